@@ -0,0 +1,154 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Range predicate L1 <= v <= L2: two scans combined with kAnd
+  vs. the single-pass Column::ScanBetween.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"ss2",     ColumnType::kSuperscalar2ByteSlicePadRight},
+    {"ss4",     ColumnType::kSuperscalar4ByteSlicePadRight},
+    {"dbs",     ColumnType::kDualByteSlicePadRight}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "ss2", "ss4", "dbs"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      lo_ratio = 0.3;
+    double      hi_ratio = 0.6;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+    }
+    WordUnit lo = arg.lo_ratio * mask;
+    WordUnit hi = arg.hi_ratio * mask;
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "layout, two scans (cycle/tuple), single pass (cycle/tuple), speedup, #matches" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+        BitVector* bitvector = new BitVector(column);
+
+        HybridTimer t1;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Scan(Comparator::kGreaterEqual, lo, bitvector, Bitwise::kSet);
+            column->Scan(Comparator::kLessEqual, hi, bitvector, Bitwise::kAnd);
+        }
+        t1.Stop();
+        double two_scans = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        size_t count = bitvector->CountOnes();
+
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->ScanBetween(lo, hi, bitvector, Bitwise::kSet);
+        }
+        t1.Stop();
+        double one_pass = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(count != bitvector->CountOnes()){
+            std::cerr << "[ERROR] " << name << ": results differ." << std::endl;
+        }
+
+        std::cout << name << ", " << two_scans << ", " << one_pass << ", "
+                  << two_scans / one_pass << ", " << count << std::endl;
+        delete bitvector;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, ss2, ss4, dbs." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | bs | ss2 | ss4 | dbs" << std::endl;
+    std::cout << "\t -l <ratio>             => the lower bound is set to L1 = ratio * 2^k. Default 0.3." << std::endl;
+    std::cout << "\t -u <ratio>             => the upper bound is set to L2 = ratio * 2^k. Default 0.6." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:l:u:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'l':
+                arg.lo_ratio = atof(optarg);
+                break;
+            case 'u':
+                arg.hi_ratio = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -6,6 +6,7 @@
 #include    <cstdlib>
 #include    <ctime>
 #include	<bitset>
+#include	<string>
 
 #include    "include/hybrid_timer.h"
 
@@ -27,11 +28,12 @@ int main(int argc, char* argv[]){
 	double selectivity2 = 0.2;
 	double selectivity3 = 0.3;
 	size_t repeat = 1;
+	std::string order = "random";
 
 	//get options:
-    //s - column size; p - predicate
+    //s - column size; p - predicate; q - sequence
     int c;
-    while((c = getopt(argc, argv, "s:p:")) != -1){
+    while((c = getopt(argc, argv, "s:p:q:")) != -1){
         switch(c){
             case 'p':
                 if(0 == strcmp(optarg, "lt"))
@@ -54,6 +56,13 @@ int main(int argc, char* argv[]){
             case 's':
                 num_rows = atoi(optarg);
                 break;
+            case 'q':
+                order = optarg;
+                if(order != "random" && order != "natural" && order != "optimized" && order != "adaptive"){
+                    std::cerr << "Unknown sequence: " << optarg << std::endl;
+                    exit(1);
+                }
+                break;
         }
     }
 
@@ -99,8 +108,16 @@ int main(int argc, char* argv[]){
 	scan.AddPredicate(BytewiseAtomPredicate(column1, comparator, literal1));
 	scan.AddPredicate(BytewiseAtomPredicate(column2, comparator, literal2));
 	scan.AddPredicate(BytewiseAtomPredicate(column3, comparator, literal3));
-	scan.ShuffleSequence();
+	if("random" == order)
+		scan.ShuffleSequence();
+	else if("optimized" == order)
+		scan.OptimizeSequence();
+	else if("adaptive" == order)
+		scan.SetAdaptive(true);
 	scan.PrintSequence();
+	std::cout << "[INFO ] estimated bytes per AvxUnit = " << scan.EstimateNumBytes(scan.sequence())
+		<< " (natural " << scan.EstimateNumBytes(scan.NaturalSequence())
+		<< ", optimized " << scan.EstimateNumBytes(scan.OptimizedSequence()) << ")" << std::endl;
 
 
 	//SCAN
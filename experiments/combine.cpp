@@ -0,0 +1,141 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/bitvector.h"
+#include    "include/bitvector_expression.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  COUNT(*) of the AND of k cached bit vectors: a chain of BitVector::And
+  and CountOnes (k + 1 passes over the result) vs. one BitVector::Combine
+  with the count fused.
+*/
+
+typedef struct {
+    std::vector<size_t> num_operands = {2, 5, 10, 15};
+    size_t      size    = 64*1024*1024;
+    double      density = 0.9;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    std::default_random_engine engine(std::time(0));
+    std::bernoulli_distribution coin(arg.density);
+    size_t max_operands = 0;
+    for(size_t k : arg.num_operands){
+        max_operands = std::max(max_operands, k);
+    }
+    std::vector<BitVector*> operands;
+    for(size_t k = 0; k < max_operands; k++){
+        BitVector* bitvector = new BitVector(arg.size);
+        bitvector->SetZeros();
+        for(size_t i = 0; i < arg.size; i++){
+            if(coin(engine)){
+                bitvector->SetBit(i);
+            }
+        }
+        operands.push_back(bitvector);
+    }
+    BitVector* result = new BitVector(arg.size);
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "operands, And chain (cycle/tuple), Combine (cycle/tuple), speedup, count" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(size_t k : arg.num_operands){
+        HybridTimer t1;
+        size_t count = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            result->SetOnes();
+            for(size_t i = 0; i < k; i++){
+                result->And(operands[i]);
+            }
+            count = result->CountOnes();
+        }
+        t1.Stop();
+        double chain = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        BitVectorExpression expression;
+        std::vector<size_t> children;
+        for(size_t i = 0; i < k; i++){
+            children.push_back(expression.AddOperand(operands[i]));
+        }
+        expression.AddAnd(children);
+        size_t count2 = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            count2 = result->Combine(expression, true);
+        }
+        t1.Stop();
+        double combine = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(count != count2){
+            std::cerr << "[ERROR] " << k << " operands: counts differ." << std::endl;
+        }
+        std::cout << k << ", " << chain << ", " << combine << ", " << chain / combine
+                  << ", " << count << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete result;
+    for(BitVector* bitvector : operands){
+        delete bitvector;
+    }
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the bit vectors. Default 64M." << std::endl;
+    std::cout << "\t -k <operands>          => combine this many bit vectors. Can be repeated." << std::endl
+              << "\t                           Default: 2, 5, 10, 15." << std::endl;
+    std::cout << "\t -d <density>           => the fraction of 1's in every operand. Default 0.9." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    bool custom_operands = false;
+    while((c = getopt(argc, argv, "s:k:d:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 'k':
+                if(!custom_operands){
+                    arg.num_operands.clear();
+                    custom_operands = true;
+                }
+                arg.num_operands.push_back(atoi(optarg));
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'd':
+                arg.density = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
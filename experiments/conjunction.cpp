@@ -26,15 +26,16 @@ int main(int argc, char* argv[]){
     double selectivity = 0.1;
     Comparator comparator = Comparator::kLess;
     size_t repeat = 1;
+    bool adaptive = false;
     const char* filename = "conjunction.data";
     std::ofstream of;
 
     //get options:
     //t - column type; s - column size; b - bit width
     //f - selectivity; r - repeat; p - predicate
-    //o - output file
+    //o - output file; a - adaptive predicate order
     int c;
-    while((c = getopt(argc, argv, "s:f:r:o:p:")) != -1){
+    while((c = getopt(argc, argv, "s:f:r:o:p:a")) != -1){
         switch(c){
             case 't':
                 if(0 == strcmp(optarg, "n"))
@@ -85,6 +86,9 @@ int main(int argc, char* argv[]){
             case 'o':
                 filename = optarg;
                 break;
+            case 'a':
+                adaptive = true;
+                break;
         }
     }
 
@@ -155,6 +159,7 @@ int main(int argc, char* argv[]){
             PipelineScan scan;
             scan.AddPredicate(AtomPredicate(column1, comparator, literal1));
             scan.AddPredicate(AtomPredicate(column2, comparator, literal2));
+            scan.SetAdaptive(adaptive);
 
             // pm.Start();
             t1.Start();
@@ -163,6 +168,14 @@ int main(int argc, char* argv[]){
             t1.Stop();
 
             cycles_pipeline += t1.GetNumCycles();
+            if(adaptive){
+                std::cout << "[INFO ] selectivity = " << selectivity << ", order =";
+                for(size_t pid : scan.order()){
+                    std::cout << " " << pid << " (s=" << scan.stats()[pid].selectivity()
+                        << ", c/t=" << scan.stats()[pid].cycles_per_tuple() << ")";
+                }
+                std::cout << std::endl;
+            }
             // l2miss_pipeline += pm.GetL2CacheMisses();
             // l3miss_pipeline += pm.GetL3CacheMisses();
             //std::cout << bitvector->CountOnes() << "\t";
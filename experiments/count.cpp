@@ -0,0 +1,182 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/pipeline_scan.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  COUNT(*) WHERE v < L: scan into a bit vector and count it
+  vs. Column::CountWhere, which materializes no bit vector.
+  With ByteSlice, also the conjunction v < L AND w < L through
+  PipelineScan::ExecuteBlockwise vs. PipelineScan::CountBlockwise.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"vbp",     ColumnType::kBitSlice},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "hs", "vbp"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      literal_ratio = 0.1;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    WordUnit* codes2 = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+        codes2[i] = dice() & mask;
+    }
+    WordUnit literal = arg.literal_ratio * mask;
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "query, scan + count (cycle/tuple), fused count (cycle/tuple), speedup, count" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+        BitVector* bitvector = new BitVector(column);
+
+        HybridTimer t1;
+        size_t count = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+            count = bitvector->CountOnes();
+        }
+        t1.Stop();
+        double materialized = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        size_t count2 = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            count2 = column->CountWhere(Comparator::kLess, literal);
+        }
+        t1.Stop();
+        double fused = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(count != count2){
+            std::cerr << "[ERROR] " << name << ": counts differ." << std::endl;
+        }
+        std::cout << name << ", " << materialized << ", " << fused << ", "
+                  << materialized / fused << ", " << count << std::endl;
+
+        if(ColumnType::kByteSlicePadRight == ctypeMap[name]){
+            Column* column2 = new Column(ctypeMap[name], arg.nbits, arg.size);
+            column2->BulkLoadArray(codes2, arg.size);
+            PipelineScan scan;
+            scan.AddPredicate(AtomPredicate(column, Comparator::kLess, literal));
+            scan.AddPredicate(AtomPredicate(column2, Comparator::kLess, literal));
+
+            t1.Start();
+            for(size_t r = 0; r < arg.repeat; r++){
+                scan.ExecuteBlockwise(bitvector);
+                count = bitvector->CountOnes();
+            }
+            t1.Stop();
+            materialized = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+            t1.Start();
+            for(size_t r = 0; r < arg.repeat; r++){
+                count2 = scan.CountBlockwise();
+            }
+            t1.Stop();
+            fused = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+            if(count != count2){
+                std::cerr << "[ERROR] " << name << " pipeline: counts differ." << std::endl;
+            }
+            std::cout << name << " pipeline, " << materialized << ", " << fused << ", "
+                      << materialized / fused << ", " << count << std::endl;
+            delete column2;
+        }
+        delete bitvector;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+    delete[] codes2;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, hs, vbp." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | vbp | bs | hs" << std::endl;
+    std::cout << "\t -l <ratio>             => the literal in the predicate (v < L) is set to L = ratio * 2^k. Default 0.1." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:l:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'l':
+                arg.literal_ratio = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
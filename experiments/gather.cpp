@@ -0,0 +1,162 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Late materialization of a sorted RID list (selectivity s):
+  GetTuple per id vs. Column::Gather, which decodes the ids
+  block by block.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"hbp",     ColumnType::kHbp},
+    {"vbp",     ColumnType::kVbp},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "hs", "hbp", "vbp"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      selectivity = 0.1;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    std::vector<TupleId> rids;
+    const WordUnit threshold = arg.selectivity * std::numeric_limits<WordUnit>::max();
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+        if(dice() < threshold){
+            rids.push_back(i);
+        }
+    }
+    std::cout << "[INFO ] #rids = " << rids.size() << std::endl;
+    std::vector<WordUnit> values(rids.size());
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "column, GetTuple (cycle/rid), Gather (cycle/rid), speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+
+        HybridTimer t1;
+        WordUnit sum = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            for(size_t i = 0; i < rids.size(); i++){
+                values[i] = column->GetTuple(rids[i]);
+            }
+        }
+        t1.Stop();
+        for(size_t i = 0; i < rids.size(); i++){
+            sum += values[i];
+        }
+        double scalar = double(t1.GetNumCycles()/arg.repeat)/rids.size();
+
+        WordUnit sum2 = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Gather(rids.data(), rids.size(), values.data());
+        }
+        t1.Stop();
+        for(size_t i = 0; i < rids.size(); i++){
+            sum2 += values[i];
+        }
+        double batched = double(t1.GetNumCycles()/arg.repeat)/rids.size();
+        if(sum != sum2){
+            std::cerr << "[ERROR] " << name << ": values differ." << std::endl;
+        }
+        std::cout << name << ", " << scalar << ", " << batched << ", "
+                  << scalar / batched << std::endl;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name);
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, hs, hbp, vbp." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | hbp | vbp | bs | hs" << std::endl;
+    std::cout << "\t -p <selectivity>       => the fraction of tuples in the RID list. Default 0.1." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:p:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'p':
+                arg.selectivity = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/hybrid_bitvector.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  COUNT(*) WHERE v < L AND w < L with sparse results: dense bit vectors
+  vs. HybridBitVector (scan, And, CountOnes), and the memory taken
+  by the intermediate results.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"vbp",     ColumnType::kBitSlice},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "hs", "vbp"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      literal_ratio = 0.001;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    WordUnit* codes2 = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+        codes2[i] = dice() & mask;
+    }
+    WordUnit literal = arg.literal_ratio * mask;
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "column, dense (cycle/tuple), hybrid (cycle/tuple), speedup, "
+              << "dense (bytes), hybrid (bytes), count" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        Column* column2 = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+        column2->BulkLoadArray(codes2, arg.size);
+        BitVector* bitvector = new BitVector(column);
+        BitVector* bitvector2 = new BitVector(column);
+        HybridBitVector* hybrid = new HybridBitVector(arg.size);
+        HybridBitVector* hybrid2 = new HybridBitVector(arg.size);
+
+        HybridTimer t1;
+        size_t count = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+            column2->Scan(Comparator::kLess, literal, bitvector2, Bitwise::kSet);
+            bitvector->And(bitvector2);
+            count = bitvector->CountOnes();
+        }
+        t1.Stop();
+        double dense = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        size_t count2 = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Scan(Comparator::kLess, literal, hybrid);
+            column2->Scan(Comparator::kLess, literal, hybrid2);
+            hybrid->And(hybrid2);
+            count2 = hybrid->CountOnes();
+        }
+        t1.Stop();
+        double compressed = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(count != count2){
+            std::cerr << "[ERROR] " << name << ": counts differ." << std::endl;
+        }
+        //hybrid2 still holds the result of a scan
+        std::cout << name << ", " << dense << ", " << compressed << ", " << dense / compressed << ", "
+                  << CEIL(arg.size, kNumWordBits) * sizeof(WordUnit) << ", "
+                  << hybrid2->GetNumBytes() << ", " << count << std::endl;
+        delete hybrid2;
+        delete hybrid;
+        delete bitvector2;
+        delete bitvector;
+        delete column2;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+    delete[] codes2;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, hs, vbp." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | vbp | bs | hs" << std::endl;
+    std::cout << "\t -l <ratio>             => the literal in the predicate (v < L) is set to L = ratio * 2^k. Default 0.001." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:l:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'l':
+                arg.literal_ratio = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
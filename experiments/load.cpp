@@ -0,0 +1,140 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Load throughput per layout: Column::BulkLoadArray vs. per-tuple SetTuple.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"avx",     ColumnType::kAvx2Scan},
+    {"hbp",     ColumnType::kHbp},
+    {"vbp",     ColumnType::kBitSlice},
+    {"vbp2",    ColumnType::kVbp},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice},
+    {"dbs",     ColumnType::kDualByteSlicePadRight}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"na", "vbp", "vbp2", "bs", "hs"};
+    size_t      size    = 16*1024*1024;
+    size_t      nbits   = 12;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    std::cout << "[INFO ] Generating " << arg.size << " random codes of "
+              << arg.nbits << " bits ..." << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+    }
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "layout, bulk load (s), bulk load (MB/s), SetTuple (s), SetTuple (MB/s)" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    const double mbytes = double(arg.size * sizeof(WordUnit)) / (1024*1024);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        HybridTimer t1;
+        double bulk_seconds = 0, set_seconds = 0;
+        for(size_t r = 0; r < arg.repeat; r++){
+            t1.Start();
+            column->BulkLoadArray(codes, arg.size);
+            t1.Stop();
+            bulk_seconds += t1.GetSeconds();
+
+            t1.Start();
+            for(size_t i=0; i < arg.size; i++){
+                column->SetTuple(i, codes[i]);
+            }
+            t1.Stop();
+            set_seconds += t1.GetSeconds();
+        }
+        bulk_seconds /= arg.repeat;
+        set_seconds /= arg.repeat;
+        std::cout << name << ", "
+                  << bulk_seconds << ", " << mbytes / bulk_seconds << ", "
+                  << set_seconds << ", " << mbytes / set_seconds << std::endl;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 16M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: na, vbp, vbp2, bs, hs." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | avx | hbp | vbp | vbp2 | bs | hs | dbs" << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
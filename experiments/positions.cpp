@@ -0,0 +1,180 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/bitvector_iterator.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Selection vector of v < L (selectivity = L / 2^k):
+  scan + BitVectorIterator::Next, scan + BitVectorIterator::NextBatch
+  (1024 at a time) and scan + BitVector::ToPositions.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"hbp",     ColumnType::kHbp},
+    {"vbp",     ColumnType::kVbp},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "hs", "hbp", "vbp"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      selectivity = 0.1;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+    }
+    WordUnit literal = arg.selectivity * (mask + 1);
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "column, scan (cycle/tuple), +Next, +NextBatch, +ToPositions, #positions" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+        BitVector* bitvector = new BitVector(column);
+        std::vector<TupleId> positions;
+        std::vector<TupleId> positions2;
+
+        HybridTimer t1;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+        }
+        t1.Stop();
+        double scan = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        //keep page faults out of the measurements
+        positions.assign(bitvector->CountOnes(), 0);
+        positions2.assign(bitvector->CountOnes(), 0);
+
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            positions.clear();
+            BitVectorIterator itor(bitvector);
+            while(itor.Next()){
+                positions.push_back(itor.GetPosition());
+            }
+        }
+        t1.Stop();
+        double iterator = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            positions2.clear();
+            BitVectorIterator itor(bitvector);
+            TupleId batch[1024];
+            size_t n = 0;
+            while(0 != (n = itor.NextBatch(batch, 1024))){
+                positions2.insert(positions2.end(), batch, batch + n);
+            }
+        }
+        t1.Stop();
+        double batched = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(positions != positions2){
+            std::cerr << "[ERROR] " << name << ": NextBatch differs." << std::endl;
+        }
+
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            bitvector->ToPositions(&positions2);
+        }
+        t1.Stop();
+        double to_positions = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(positions != positions2){
+            std::cerr << "[ERROR] " << name << ": ToPositions differs." << std::endl;
+        }
+
+        std::cout << name << ", " << scan << ", " << iterator << ", " << batched << ", " << to_positions << ", "
+                  << positions.size() << std::endl;
+        delete bitvector;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, hs, hbp, vbp." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | hbp | vbp | bs | hs" << std::endl;
+    std::cout << "\t -p <selectivity>       => the literal in the predicate (v < L) is set to L = selectivity * 2^k. Default 0.1." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:p:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'p':
+                arg.selectivity = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
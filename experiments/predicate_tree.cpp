@@ -0,0 +1,133 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/predicate_tree.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Predicate tree (c1 < L1 OR c2 = L2) AND c3 >= L3 on three ByteSlice columns:
+  one scan per predicate with merged bit vectors (Column::Scan) vs.
+  one PredicateTree::Scan pass.
+*/
+
+typedef struct {
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 16;
+    double      selectivity = 0.5;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    std::vector<Column*> columns;
+    for(size_t c = 0; c < 3; c++){
+        Column* column = new Column(ColumnType::kByteSlicePadRight, arg.nbits, arg.size);
+        WordUnit* codes = new WordUnit[arg.size];
+        for(size_t i=0; i < arg.size; i++){
+            codes[i] = dice() & mask;
+        }
+        column->BulkLoadArray(codes, arg.size);
+        delete[] codes;
+        columns.push_back(column);
+    }
+
+    const WordUnit lit1 = arg.selectivity * mask;
+    const WordUnit lit2 = dice() & mask;
+    const WordUnit lit3 = (1 - arg.selectivity) * mask;
+    PredicateTree tree;
+    size_t p1 = tree.AddPredicate(BytewiseAtomPredicate(columns[0], Comparator::kLess, lit1));
+    size_t p2 = tree.AddPredicate(BytewiseAtomPredicate(columns[1], Comparator::kEqual, lit2));
+    size_t p3 = tree.AddPredicate(BytewiseAtomPredicate(columns[2], Comparator::kGreaterEqual, lit3));
+    tree.AddAnd({tree.AddOr({p1, p2}), p3});
+    BitVector* bitvector = new BitVector(arg.size);
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "columnwise (cycle/tuple), one pass (cycle/tuple), speedup, #matches" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    HybridTimer t1;
+    t1.Start();
+    for(size_t r = 0; r < arg.repeat; r++){
+        columns[0]->Scan(Comparator::kLess, lit1, bitvector, Bitwise::kSet);
+        columns[1]->Scan(Comparator::kEqual, lit2, bitvector, Bitwise::kOr);
+        columns[2]->Scan(Comparator::kGreaterEqual, lit3, bitvector, Bitwise::kAnd);
+    }
+    t1.Stop();
+    double columnwise = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+    size_t count = bitvector->CountOnes();
+
+    t1.Start();
+    for(size_t r = 0; r < arg.repeat; r++){
+        tree.Scan(bitvector);
+    }
+    t1.Stop();
+    double tree_scan = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+    if(count != bitvector->CountOnes()){
+        std::cerr << "[ERROR] results differ." << std::endl;
+    }
+    std::cout << columnwise << ", " << tree_scan << ", " << columnwise / tree_scan
+              << ", " << count << std::endl;
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete bitvector;
+    for(Column* column : columns){
+        delete column;
+    }
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the columns (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 16." << std::endl;
+    std::cout << "\t -f <selectivity>       => selectivity of the two range predicates. Default 0.5." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    while((c = getopt(argc, argv, "s:b:f:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'f':
+                arg.selectivity = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <vector>
+#include    <random>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/bitvector.h"
+#include    "include/rank_select.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Random "k-th match" (Select) and "matches before row r" (Rank) queries:
+  counting the words of the bit vector from the start vs. RankSelect.
+  Also the time to build the directory and its size.
+*/
+
+typedef struct {
+    std::vector<double> densities = {0.001, 0.01, 0.1, 0.5};
+    size_t      size    = 64*1024*1024;
+    size_t      num_queries = 1000;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+//the k-th 1 by counting the words from the start
+size_t ScanSelect(const BitVector* bitvector, size_t k){
+    for(size_t block_id = 0; block_id < bitvector->GetNumBlocks(); block_id++){
+        const BitVectorBlock* bvblock = bitvector->GetBVBlock(block_id);
+        for(size_t word_id = 0; word_id < bvblock->num_word_units(); word_id++){
+            WordUnit word = bvblock->GetWordUnit(word_id);
+            size_t count = POPCNT64(word);
+            if(k < count){
+                for(size_t i = 0; i < k; i++){
+                    word &= word - 1;
+                }
+                return block_id * kNumTuplesPerBlock + word_id * kNumWordBits
+                    + __builtin_ctzll(word);
+            }
+            k -= count;
+        }
+    }
+    return bitvector->num();
+}
+
+//the 1's before pos by counting the words from the start
+size_t ScanRank(const BitVector* bitvector, size_t pos){
+    size_t rank = 0;
+    for(size_t block_id = 0; block_id <= pos / kNumTuplesPerBlock; block_id++){
+        const BitVectorBlock* bvblock = bitvector->GetBVBlock(block_id);
+        size_t num_bits = (block_id == pos / kNumTuplesPerBlock)?
+            pos % kNumTuplesPerBlock : kNumTuplesPerBlock;
+        for(size_t word_id = 0; word_id < num_bits / kNumWordBits; word_id++){
+            rank += POPCNT64(bvblock->GetWordUnit(word_id));
+        }
+        if(0 != num_bits % kNumWordBits){
+            rank += POPCNT64(bvblock->GetWordUnit(num_bits / kNumWordBits)
+                    & ((1ULL << (num_bits % kNumWordBits)) - 1));
+        }
+    }
+    return rank;
+}
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    std::default_random_engine engine(std::time(0));
+    BitVector* bitvector = new BitVector(arg.size);
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "density, build (cycle/tuple), directory (bytes), "
+              << "scan select (cycle/query), select (cycle/query), "
+              << "scan rank (cycle/query), rank (cycle/query)" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(double density : arg.densities){
+        std::bernoulli_distribution coin(density);
+        bitvector->SetZeros();
+        for(size_t i = 0; i < arg.size; i++){
+            if(coin(engine)){
+                bitvector->SetBit(i);
+            }
+        }
+
+        HybridTimer t1;
+        t1.Start();
+        RankSelect directory(bitvector);
+        t1.Stop();
+        double build = double(t1.GetNumCycles())/arg.size;
+        if(0 == directory.CountOnes()){
+            std::cerr << "[ERROR] " << density << ": no 1's." << std::endl;
+            continue;
+        }
+
+        std::vector<size_t> ks;
+        std::vector<size_t> rows;
+        for(size_t q = 0; q < arg.num_queries; q++){
+            ks.push_back(engine() % directory.CountOnes());
+            rows.push_back(engine() % arg.size);
+        }
+
+        size_t checksum = 0, checksum2 = 0;
+        t1.Start();
+        for(size_t k : ks){
+            checksum += ScanSelect(bitvector, k);
+        }
+        t1.Stop();
+        double scan_select = double(t1.GetNumCycles())/arg.num_queries;
+        t1.Start();
+        for(size_t k : ks){
+            checksum2 += directory.Select(k);
+        }
+        t1.Stop();
+        double select = double(t1.GetNumCycles())/arg.num_queries;
+
+        t1.Start();
+        for(size_t row : rows){
+            checksum += ScanRank(bitvector, row);
+        }
+        t1.Stop();
+        double scan_rank = double(t1.GetNumCycles())/arg.num_queries;
+        t1.Start();
+        for(size_t row : rows){
+            checksum2 += directory.Rank(row);
+        }
+        t1.Stop();
+        double rank = double(t1.GetNumCycles())/arg.num_queries;
+        if(checksum != checksum2){
+            std::cerr << "[ERROR] " << density << ": results differ." << std::endl;
+        }
+
+        std::cout << density << ", " << build << ", " << directory.GetNumBytes() << ", "
+                  << scan_select << ", " << select << ", "
+                  << scan_rank << ", " << rank << std::endl;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete bitvector;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the bit vector. Default 64M." << std::endl;
+    std::cout << "\t -d <density>           => the fraction of 1's. Can be repeated." << std::endl
+              << "\t                           Default: 0.001, 0.01, 0.1, 0.5." << std::endl;
+    std::cout << "\t -q <queries>           => set the number of random queries. Default 1000." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    bool custom_densities = false;
+    while((c = getopt(argc, argv, "s:d:q:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 'd':
+                if(!custom_densities){
+                    arg.densities.clear();
+                    custom_densities = true;
+                }
+                arg.densities.push_back(atof(optarg));
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'q':
+                arg.num_queries = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -1,7 +1,6 @@
 #include    <iostream>
 #include    <fstream>
 #include    <string>
-#include    <map>
 #include    <vector>
 
 #include    "exp-utility.h"
@@ -11,6 +10,7 @@
 
 #include    "include/types.h"
 #include    "include/column.h"
+#include    "include/table.h"
 #include    "include/bitvector.h"
 #include    "include/bitvector_iterator.h"
 
@@ -20,8 +20,8 @@ int main(int argc, char* argv[]){
 
     ColumnType type = ColumnType::kByteSlicePadRight;
     size_t repeat = 5;
+    bool fused = false;
     std::string query_file;
-    std::map<std::string, Column*> table;
     std::vector<ScanCondition> selections;
     std::vector<ScanColumnCondition> columnscans;
     std::vector<std::string> aggregates;
@@ -33,9 +33,9 @@ int main(int argc, char* argv[]){
 
     //Options:
     //t - column type; r - repeat
-    //q - query file
+    //q - query file; f - aggregate with Column::Aggregate
     int c;
-    while((c = getopt(argc, argv, "t:r:q:")) != -1){
+    while((c = getopt(argc, argv, "t:r:q:f")) != -1){
         switch(c){
             case 't':
                 if(0 == strcmp(optarg, "n"))
@@ -69,6 +69,9 @@ int main(int argc, char* argv[]){
             case 'q':
                 query_file = std::string(optarg);
                 break;
+            case 'f':
+                fused = true;
+                break;
         }
     }
 
@@ -76,15 +79,15 @@ int main(int argc, char* argv[]){
     std::ifstream ifs(query_file, std::ifstream::in);
     ifs >> num_rows;
     std::cout << "num of rows: " << num_rows << std::endl;
+    Table table(num_rows);
     ifs >> num_columns;
     //Load columns from text files
     for(size_t i=0; i<num_columns; i++){
         std::string cname;
         size_t bit_width;
         ifs >> cname >> bit_width;
-        Column *column = new Column(type, bit_width, num_rows);
+        Column *column = table.CreateColumn(cname, type, bit_width);
         column->LoadTextFile(cname);
-        table[cname] = column;
         std::cout << "Load column: " << cname << std::endl;
     }
     //Add scan conditions
@@ -165,15 +168,15 @@ int main(int argc, char* argv[]){
         //---Scan
         t1.Start();
         for(size_t s=0; s < selections.size(); s++){
-            Column *column = table[selections[s].cname];
+            Column *column = table.GetColumn(selections[s].cname);
             Comparator comparator = selections[s].comparator;
             WordUnit literal = selections[s].literal;
             column->Scan(comparator, literal, bitvector, (0==s)? Bitwise::kSet : Bitwise::kAnd);
         }
         for(size_t t=0; t < columnscans.size(); t++){
-            Column *column1 = table[columnscans[t].cname];
+            Column *column1 = table.GetColumn(columnscans[t].cname);
             Comparator comparator = columnscans[t].comparator;
-            Column *column2 = table[columnscans[t].cname_other];
+            Column *column2 = table.GetColumn(columnscans[t].cname_other);
             column1->Scan(comparator, column2, bitvector, Bitwise::kAnd);
         }
         t1.Stop();
@@ -183,15 +186,26 @@ int main(int argc, char* argv[]){
         //-------
 
         //---Aggregate
+        if(fused){
+            //block-at-a-time over the bit vector, no RID list
+            t1.Start();
+            WordUnit dummy = 1;
+            for(size_t a = 0; a < aggregates.size(); a++){
+                Column *column = table.GetColumn(aggregates[a]);
+                dummy += column->Aggregate(bitvector).sum;
+            }
+            t1.Stop();
+            if(run > 0){
+                sum_rdtsc_agg += t1.GetNumCycles();
+            }
+            continue;
+        }
         //Prepare the RID-list
         BitVectorIterator* itor = new BitVectorIterator(bitvector);
-        std::vector<size_t> rid_list;
+        std::vector<TupleId> rid_list;
         size_t count = bitvector->CountOnes();
-        rid_list.reserve(count);
-        while(itor->Next()){
-            size_t id = itor->GetPosition();
-            rid_list.push_back(id);
-        }
+        rid_list.resize(count);
+        itor->NextBatch(rid_list.data(), count);
 
         t1.Start();
 
@@ -200,19 +214,31 @@ int main(int argc, char* argv[]){
 //            while(itor->Next()){
 //                size_t id = itor->GetPosition();
 //                for(size_t a=0; a < aggregates.size(); a++){
-//                    Column *column = table[aggregates[a]];
+//                    Column *column = table.GetColumn(aggregates[a]);
 //                    dummy += column->GetTuple(id);
 //                }
 //            }
 //        }
 
-        {   //Implementation 2
+//        {   //Implementation 2
+//            WordUnit dummy = 1;
+//            for(size_t a = 0; a < aggregates.size(); a++){
+//                Column *column = table.GetColumn(aggregates[a]);
+//                for(size_t i=0; i < rid_list.size(); i++){
+//                    size_t rid = rid_list[i];
+//                    dummy += column->GetTuple(rid);
+//                }
+//            }
+//        }
+
+        {   //Implementation 3: batched by block
             WordUnit dummy = 1;
+            std::vector<WordUnit> values(rid_list.size());
             for(size_t a = 0; a < aggregates.size(); a++){
-                Column *column = table[aggregates[a]];
-                for(size_t i=0; i < rid_list.size(); i++){
-                    size_t rid = rid_list[i];
-                    dummy += column->GetTuple(rid);
+                Column *column = table.GetColumn(aggregates[a]);
+                column->Gather(rid_list.data(), rid_list.size(), values.data());
+                for(size_t i=0; i < values.size(); i++){
+                    dummy += values[i];
                 }
             }
         }
@@ -240,10 +266,4 @@ int main(int argc, char* argv[]){
     std::cout << (scan_time + agg_time) << "\t"
               << scan_time << "\t"
               << agg_time << std::endl;
-    
-    //Destroy columns
-    std::map<std::string, Column*>::iterator it;
-    for(it = table.begin(); it != table.end(); it++){
-        delete it->second;
-    }
 }
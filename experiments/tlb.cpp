@@ -0,0 +1,213 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <cstring>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <functional>
+#include    <linux/perf_event.h>
+#include    <sys/ioctl.h>
+#include    <sys/syscall.h>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/buffer_pool.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  Scan cost per page policy and layout: cycles/tuple and DTLB misses/tuple.
+  DTLB misses are read from the perf_event interface, as PCM does not
+  expose them. They are reported as -1 if perf events are not accessible.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"navx",    ColumnType::kNaiveAvx},
+    {"avx",     ColumnType::kAvx2Scan},
+    {"hbp",     ColumnType::kHbp},
+    {"vbp",     ColumnType::kBitSlice},
+    {"vbp2",    ColumnType::kVbp},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice},
+    {"dbs",     ColumnType::kDualByteSlicePadRight}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"navx", "vbp", "bs", "hs"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    double      literal_ratio = 0.1;
+    size_t      repeat  = 3;
+} arg_t;
+
+/**
+  DTLB load misses of the calling process (all threads created after Open).
+*/
+class DtlbCounter{
+public:
+    bool Open(){
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        return fd_ >= 0;
+    }
+    void Start(){
+        if(fd_ >= 0){
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    long long Stop(){
+        long long count = -1;
+        if(fd_ >= 0){
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if(sizeof(count) != read(fd_, &count, sizeof(count))){
+                count = -1;
+            }
+        }
+        return count;
+    }
+    ~DtlbCounter(){
+        if(fd_ >= 0){
+            close(fd_);
+        }
+    }
+private:
+    int fd_ = -1;
+};
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    DtlbCounter dtlb;
+    if(!dtlb.Open()){
+        std::cerr << "[WARN ] DTLB counter not available." << std::endl;
+    }
+
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+    }
+    WordUnit literal = arg.literal_ratio * mask;
+    const PagePolicy policies[] =
+        {PagePolicy::kDefault, PagePolicy::kTransparentHugePage, PagePolicy::kHugeTlb};
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "layout, policy, 2MB pages (thp/hugetlb), cycle/tuple, dtlb-miss/tuple" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        double base_cycles = 0, base_misses = 0;
+        for(PagePolicy policy : policies){
+            Column* column = new Column(ctypeMap[name], arg.nbits, arg.size, policy);
+            column->BulkLoadArray(codes, arg.size);
+            BitVector* bitvector = new BitVector(column);
+            size_t thp = BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage);
+            size_t hugetlb = BufferPool::GetNumHugePages(PagePolicy::kHugeTlb);
+
+            HybridTimer t1;
+            t1.Start();
+            dtlb.Start();
+            for(size_t r = 0; r < arg.repeat; r++){
+                column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+            }
+            long long misses = dtlb.Stop();
+            t1.Stop();
+
+            double cycles = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+            double miss_rate = (misses < 0)? -1 : double(misses/arg.repeat)/arg.size;
+            if(PagePolicy::kDefault == policy){
+                base_cycles = cycles;
+                base_misses = miss_rate;
+            }
+            std::cout << name << ", " << policy << ", "
+                      << thp << "/" << hugetlb << ", "
+                      << cycles << " (" << cycles - base_cycles << "), "
+                      << miss_rate << " (" << miss_rate - base_misses << ")"
+                      << std::endl;
+            delete bitvector;
+            delete column;
+        }
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "Deltas in parentheses are against the default page policy." << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: navx, vbp, bs, hs." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | navx | avx | hbp | vbp | vbp2 | bs | hs | dbs" << std::endl;
+    std::cout << "\t -l <ratio>             => the literal in the predicate (v < L) is set to L = ratio * 2^k. Default 0.1." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:l:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'l':
+                arg.literal_ratio = atof(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -0,0 +1,187 @@
+#include    <iostream>
+#include    <iomanip>
+#include    <unistd.h>
+#include    <string>
+#include    <cstdlib>
+#include    <ctime>
+#include    <omp.h>
+#include    <map>
+#include    <vector>
+#include    <random>
+#include    <algorithm>
+#include    <functional>
+
+#include    "include/types.h"
+#include    "include/column.h"
+#include    "include/bitvector.h"
+#include    "include/hybrid_timer.h"
+
+using namespace byteslice;
+
+/**
+  MIN and TOP-k: decode every code and keep the k smallest
+  vs. Column::Min/TopK, which decodes only the tuples whose
+  first byte can still make the top k.
+*/
+
+std::map<std::string, ColumnType> ctypeMap = {
+    {"na",      ColumnType::kNaive},
+    {"vbp",     ColumnType::kBitSlice},
+    {"bs",      ColumnType::kByteSlicePadRight},
+    {"hs",      ColumnType::kHybridSlice}
+};
+
+typedef struct {
+    std::vector<std::string> coltypes = {"bs", "hs", "vbp"};
+    size_t      size    = 64*1024*1024;
+    size_t      nbits   = 12;
+    size_t      k       = 100;
+    size_t      repeat  = 3;
+} arg_t;
+
+void parse_arg(arg_t &arg, int &argc, char** &argv);
+void print_help(char* prog_name);
+
+int main(int argc, char* argv[]){
+    arg_t arg;
+    parse_arg(arg, argc, argv);
+
+    std::cout << "[INFO ] omp_max_threads = " << omp_get_max_threads() << std::endl;
+    auto dice = std::bind(std::uniform_int_distribution<WordUnit>(
+                            std::numeric_limits<WordUnit>::min(),
+                            std::numeric_limits<WordUnit>::max()),
+                            std::default_random_engine(std::time(0)));
+    WordUnit mask = (1ULL << arg.nbits) - 1;
+    WordUnit* codes = new WordUnit[arg.size];
+    for(size_t i=0; i < arg.size; i++){
+        codes[i] = dice() & mask;
+    }
+    auto less = [](const TopKEntry &a, const TopKEntry &b){
+        return TopKBetter(a, b, false);
+    };
+
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+    std::cout << "query, decode all (cycle/tuple), bytewise (cycle/tuple), speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(5);
+    for(const std::string &name : arg.coltypes){
+        Column* column = new Column(ctypeMap[name], arg.nbits, arg.size);
+        column->BulkLoadArray(codes, arg.size);
+
+        //MIN
+        HybridTimer t1;
+        WordUnit min = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            min = std::numeric_limits<WordUnit>::max();
+            for(size_t i = 0; i < arg.size; i++){
+                min = std::min(min, column->GetTuple(i));
+            }
+        }
+        t1.Stop();
+        double decoded = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        WordUnit min2 = 0;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            column->Min(&min2);
+        }
+        t1.Stop();
+        double bytewise = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(min != min2){
+            std::cerr << "[ERROR] " << name << ": minimums differ." << std::endl;
+        }
+        std::cout << name << " min, " << decoded << ", " << bytewise << ", "
+                  << decoded / bytewise << std::endl;
+
+        //TOP-k
+        std::vector<TopKEntry> top;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            top.clear();
+            for(size_t i = 0; i < arg.size; i++){
+                TopKEntry entry(column->GetTuple(i), i);
+                if(top.size() < arg.k){
+                    top.push_back(entry);
+                    std::push_heap(top.begin(), top.end(), less);
+                }
+                else if(less(entry, top.front())){
+                    std::pop_heap(top.begin(), top.end(), less);
+                    top.back() = entry;
+                    std::push_heap(top.begin(), top.end(), less);
+                }
+            }
+            std::sort_heap(top.begin(), top.end(), less);
+        }
+        t1.Stop();
+        decoded = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+
+        std::vector<TopKEntry> top2;
+        t1.Start();
+        for(size_t r = 0; r < arg.repeat; r++){
+            top2 = column->TopK(arg.k);
+        }
+        t1.Stop();
+        bytewise = double(t1.GetNumCycles()/arg.repeat)/arg.size;
+        if(top != top2){
+            std::cerr << "[ERROR] " << name << ": top-k differ." << std::endl;
+        }
+        std::cout << name << " top-" << arg.k << ", " << decoded << ", " << bytewise << ", "
+                  << decoded / bytewise << std::endl;
+        delete column;
+    }
+    std::cout << "--------------------------------------------------------------------------" << std::endl;
+
+    delete[] codes;
+}
+
+void print_help(char* prog_name){
+    std::cout << std::endl << "Usage: " << std::endl;
+    std::cout << prog_name << " -h | [options]" << std::endl;
+    std::cout << "Descriptions of <options>: " << std::endl;
+    std::cout << "\t -h                     => display this message." << std::endl;
+    std::cout << "\t -s <size>              => set the size of the column (number of codes). Default 64M." << std::endl;
+    std::cout << "\t -t <column type>       => measure only this column type. Can be repeated." << std::endl
+              << "\t                           Default: bs, hs, vbp." << std::endl
+              << "\t                           Acceptable column types are:" << std::endl
+              << "\t                           na | vbp | bs | hs" << std::endl;
+    std::cout << "\t -k <k>                 => the number of smallest codes to find. Default 100." << std::endl;
+    std::cout << "\t -b <code width>        => set the code width (number of bits): 1~32. Default 12." << std::endl;
+    std::cout << "\t -r <repetition>        => set the number of repeated experiment runs. Default 3." << std::endl;
+}
+
+void parse_arg(arg_t &arg, int &argc, char** &argv){
+    int c;
+    std::string s;
+    bool custom_types = false;
+    while((c = getopt(argc, argv, "t:s:b:k:r:h")) != -1){
+        switch(c){
+            case 'h':
+                print_help(argv[0]);
+                exit(0);
+            case 't':
+                s = std::string(optarg);
+                if(ctypeMap.find(s) == ctypeMap.end()){
+                    std::cerr << "Unknown column type: " << s << std::endl;
+                    exit(1);
+                }
+                if(!custom_types){
+                    arg.coltypes.clear();
+                    custom_types = true;
+                }
+                arg.coltypes.push_back(s);
+                break;
+            case 's':
+                arg.size = atoi(optarg);
+                break;
+            case 'b':
+                arg.nbits = atoi(optarg);
+                break;
+            case 'k':
+                arg.k = atoi(optarg);
+                break;
+            case 'r':
+                arg.repeat = atoi(optarg);
+                break;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include    <algorithm>
+#include    <limits>
+#include    <utility>
+#include    "common.h"
+#include    "types.h"
+
+namespace byteslice{
+
+/**
+  COUNT, SUM, MIN and MAX of a set of codes.
+  Partial results of blocks and threads are combined with Merge.
+  min and max are only meaningful when count is not 0.
+*/
+struct AggregateResult{
+    size_t count = 0;
+    WordUnit sum = 0;
+    WordUnit min = std::numeric_limits<WordUnit>::max();
+    WordUnit max = 0;
+
+    //0 if count is 0
+    double avg() const;
+    void Add(WordUnit code);
+    void Merge(const AggregateResult &other);
+};
+
+inline double AggregateResult::avg() const{
+    return (0 == count)? 0.0 : double(sum) / count;
+}
+
+inline void AggregateResult::Add(WordUnit code){
+    count++;
+    sum += code;
+    min = std::min(min, code);
+    max = std::max(max, code);
+}
+
+inline void AggregateResult::Merge(const AggregateResult &other){
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+//A code and its position, in a block or in a column
+typedef std::pair<WordUnit, size_t> TopKEntry;
+
+/**
+  @brief Order of the results of TopK: the smallest (or largest) code first,
+  ties broken by the smallest position.
+*/
+inline bool TopKBetter(const TopKEntry &a, const TopKEntry &b, bool largest){
+    if(a.first != b.first){
+        return largest? (a.first > b.first) : (a.first < b.first);
+    }
+    return a.second < b.second;
+}
+
+}   //namespace
+
+#endif  //AGGREGATE_H
@@ -138,27 +138,14 @@ inline int movemask_epi16(const __m256i &a){
 }
 
 inline __m256i inverse_movemask_epi8(uint32_t mmask){
-    uint8_t byte0 = static_cast<uint8_t>(mmask);
-    uint8_t byte1 = static_cast<uint8_t>(mmask >> 8);
-    uint8_t byte2 = static_cast<uint8_t>(mmask >> 16);
-    uint8_t byte3 = static_cast<uint8_t>(mmask >> 24);
-
-    __m256i t = _mm256_set_epi8(
-            byte3, byte3, byte3, byte3, byte3, byte3, byte3, byte3,
-            byte2, byte2, byte2, byte2, byte2, byte2, byte2, byte2,
-            byte1, byte1, byte1, byte1, byte1, byte1, byte1, byte1,
-            byte0, byte0, byte0, byte0, byte0, byte0, byte0, byte0);
-
-    __m256i mask = _mm256_set_epi8(
-            0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1,
-            0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1,
-            0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1,
-            0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1);
-
-    __m256i ret = _mm256_cmpeq_epi8(mask, _mm256_and_si256(mask, t));
-    
-    return ret;
-
+    //byte j of the result takes byte j/8 of mmask...
+    const __m256i spread = _mm256_setr_epi64x(
+            0x0000000000000000, 0x0101010101010101,
+            0x0202020202020202, 0x0303030303030303);
+    __m256i t = _mm256_shuffle_epi8(_mm256_set1_epi32(mmask), spread);
+    //...and keeps bit j%8 of it
+    const __m256i mask = _mm256_set1_epi64x(0x8040201008040201);
+    return _mm256_cmpeq_epi8(mask, _mm256_and_si256(mask, t));
 }
 
 }   //namespace
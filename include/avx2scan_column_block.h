@@ -29,8 +29,8 @@ public:
             BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet) const override;
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
 private:
@@ -73,6 +73,9 @@ private:
     //the largest number of bytes that a single code can spans
     //Should be at most 5 for code no wider than 32 bits
     static constexpr size_t kNumMostSpannedBytesPerCode = CEIL(BIT_WIDTH-1, 8) + 1;
+    //allocate 32 more bytes at the end to make sure we can load the last segment
+    static constexpr size_t kMemSize =
+        CEIL(kNumTuplesPerBlock, kNumTuplePerSegment) * kNumBytesPerSegment + 32;
 
     //Precompute the starting word id and shift 
     struct Helper{
@@ -139,6 +142,7 @@ inline WordUnit Avx2ScanColumnBlock<BIT_WIDTH>::GetTuple(size_t pos) const{
 
 template <size_t BIT_WIDTH>
 inline void Avx2ScanColumnBlock<BIT_WIDTH>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     size_t segment_id = pos / kNumTuplePerSegment;
     size_t pos_in_segment = pos % kNumTuplePerSegment;
     size_t shift = helpers_[pos_in_segment].shift;
@@ -0,0 +1,66 @@
+#ifndef BIT_TRANSPOSE_H
+#define BIT_TRANSPOSE_H
+
+#include    "common.h"
+#include    "types.h"
+
+namespace byteslice{
+
+/**
+  Bit-matrix transposition kernels shared by the bit-sliced layouts
+  (BitSlice, VBP and the bit-slice part of HybridSlice) for bulk loading.
+  A group of codes is turned into all of its bit slices at once,
+  instead of a read-modify-write of every slice per code.
+*/
+
+/**
+  @brief Transpose a 64x64 bit matrix in place:
+  afterwards, bit r of rows[b] is bit b of the original rows[r].
+  */
+inline void Transpose64x64(WordUnit rows[64]){
+    WordUnit mask = 0x00000000FFFFFFFFULL;
+    for(size_t j = 32; j != 0; j >>= 1, mask ^= (mask << j)){
+        for(size_t k = 0; k < 64; k = ((k | j) + 1) & ~j){
+            WordUnit t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+            rows[k] ^= (t << j);
+            rows[k | j] ^= t;
+        }
+    }
+}
+
+/**
+  @brief Four independent 64x64 transpositions, one per 64-bit lane.
+  */
+inline void Transpose64x64x4(AvxUnit rows[64]){
+    AvxUnit mask = _mm256_set1_epi64x(0x00000000FFFFFFFFULL);
+    for(int j = 32; j != 0; j >>= 1){
+        const __m128i count = _mm_cvtsi32_si128(j);
+        for(size_t k = 0; k < 64; k = ((k | j) + 1) & ~j){
+            AvxUnit t = _mm256_and_si256(
+                    _mm256_xor_si256(_mm256_srl_epi64(rows[k], count), rows[k | j]),
+                    mask);
+            rows[k] = _mm256_xor_si256(rows[k], _mm256_sll_epi64(t, count));
+            rows[k | j] = _mm256_xor_si256(rows[k | j], t);
+        }
+        const __m128i half = _mm_cvtsi32_si128(j >> 1);
+        mask = _mm256_xor_si256(mask, _mm256_sll_epi64(mask, half));
+    }
+}
+
+/**
+  @brief Bit-transpose 256 consecutive codes.
+  Lane w of slices[b] receives bit b of codes[64w .. 64w+63],
+  i.e. slices[b] is the AVX word holding bit b of the whole group,
+  bit i of the 256-bit word belonging to codes[i].
+  */
+inline void TransposeBits256(const WordUnit* codes, AvxUnit slices[64]){
+    for(size_t r = 0; r < 64; r++){
+        slices[r] = _mm256_set_epi64x(codes[192 + r], codes[128 + r],
+                                      codes[64 + r], codes[r]);
+    }
+    Transpose64x64x4(slices);
+}
+
+}   //namespace
+
+#endif  //BIT_TRANSPOSE_H
@@ -22,6 +22,7 @@ public:
 
     WordUnit GetTuple(size_t pos) const override;
     void SetTuple(size_t pos, WordUnit value) override;
+    void Gather(const TupleId* positions, size_t n, WordUnit* out) const override;
 
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bvblock,
             Bitwise bit_opt = Bitwise::kSet) const override;
@@ -30,8 +31,8 @@ public:
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
 private:
@@ -73,7 +74,14 @@ inline WordUnit BitSliceColumnBlock::GetTuple(size_t pos) const{
     return ret;
 }
 
+inline void BitSliceColumnBlock::Gather(const TupleId* positions, size_t n, WordUnit* out) const{
+    for(size_t i = 0; i < n; i++){
+        out[i] = BitSliceColumnBlock::GetTuple(positions[i]);
+    }
+}
+
 inline void BitSliceColumnBlock::SetTuple(size_t pos, WordUnit value) {
+    zone_map_.Update(pos, value);
     assert(pos <= num_tuples_);
     size_t word_id = pos / kNumWordBits;
     size_t offset = pos % kNumWordBits;
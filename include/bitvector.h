@@ -13,6 +13,7 @@ namespace byteslice{
 */
 
 class Column;
+class BitVectorExpression;
 
 class BitVector{
 /*
@@ -27,11 +28,24 @@ public:
     void SetOnes();
     void SetZeros();
     size_t CountOnes() const;
+    /**
+      @brief The ids of the set bits, in increasing order (a selection vector).
+      Blocks are counted, then converted in parallel, each straight into
+      its own range of positions (see BitVectorBlock::GetPositions).
+      */
+    void ToPositions(std::vector<TupleId>* positions) const;
 
     //bitwise combination
     void And(const BitVector* bitvector);
     void Or(const BitVector* bitvector);
     void Not();
+    /**
+      @brief Replace the content by an AND/OR/NOT tree of bit vectors,
+      evaluated block by block in one pass (see BitVectorExpression).
+      This bit vector may be one of the operands.
+      @return the number of 1's of the result if count_ones, 0 otherwise.
+      */
+    size_t Combine(const BitVectorExpression &expression, bool count_ones = false);
 
     //bit manipulation
     bool GetBit(size_t pos);
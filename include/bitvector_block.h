@@ -27,7 +27,20 @@ public:
     ~BitVectorBlock();
     void SetOnes();
     void SetZeros();
-    size_t CountOnes();
+    size_t CountOnes() const;
+    /**
+      @brief Write base + the position of every set bit, in increasing order,
+      to positions, which must have room for CountOnes() entries.
+      @return the number of positions written.
+      */
+    size_t GetPositions(TupleId base, TupleId* positions) const;
+    /**
+      @brief Write base + the index of every set bit of word to positions.
+      Positions are stored 8 at a time: positions must have room for
+      POPCNT64(word) + 8 entries, the ones past POPCNT64(word) are garbage.
+      @return POPCNT64(word)
+      */
+    static size_t ExpandWord(WordUnit word, TupleId base, TupleId* positions);
     void ClearTail();
     void And(const BitVectorBlock* block);
     void Or(const BitVectorBlock* block);
@@ -0,0 +1,95 @@
+#ifndef BITVECTOR_EXPRESSION_H
+#define BITVECTOR_EXPRESSION_H
+
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "bitvector.h"
+#include    "bitvector_block.h"
+
+namespace byteslice{
+
+enum class BitExpressionNodeType{
+    kOperand,
+    kAnd,
+    kOr,
+    kNot
+};
+
+/**
+  * @brief An AND/OR/NOT tree over bit vectors of the same size,
+  * e.g. a AND b AND NOT c, evaluated by BitVector::Combine in one pass:
+  * every 4096 tuples (kNumUnits AvxUnits) of every operand are loaded once
+  * and the result is stored once, where a chain of BitVector::And makes
+  * one pass over the result per operand.
+  * An operand (or NOT operand) child is merged into its parent as it is
+  * loaded. The remaining children of an AND are skipped once the 4096
+  * tuples are all 0's, those of an OR once they are all 1's.
+  */
+class BitVectorExpression{
+public:
+    //Every Add* returns the id of the new node.
+    size_t AddOperand(const BitVector* bitvector);
+    size_t AddAnd(const std::vector<size_t> &children);
+    size_t AddOr(const std::vector<size_t> &children);
+    size_t AddNot(size_t child);
+    //left AND NOT right
+    size_t AddAndNot(size_t left, size_t right);
+    //The root is the last node added unless set otherwise.
+    void SetRoot(size_t node_id);
+
+    /**
+      @brief Write the result for block block_id to bvblock, which may be
+      the block of an operand.
+      @return the number of 1's written if count_ones, 0 otherwise.
+      */
+    size_t EvaluateBlock(size_t block_id, BitVectorBlock* bvblock, bool count_ones) const;
+
+    //accessors
+    size_t root() const;
+    size_t num_nodes() const;
+    size_t num_operands() const;
+    const BitVector* GetOperand(size_t operand_id) const;
+
+private:
+    struct Node{
+        BitExpressionNodeType type;
+        size_t operand_id;
+        std::vector<size_t> children;
+    };
+
+    size_t AddNode(BitExpressionNodeType type, const std::vector<size_t> &children,
+            size_t operand_id = 0);
+
+    //Every 4096 tuples are evaluated as kNumUnits AvxUnits (512 bytes of an
+    //operand); larger stretches measured slower with 10+ operands.
+    static constexpr size_t kNumUnits = kNumAvxBits / 16;
+
+    //result[0..num_units) = the node over the units starting at word offset
+    //blocks[o] is the current block of operand o
+    void Evaluate(size_t node_id, size_t offset, size_t num_units,
+            const std::vector<const BitVectorBlock*> &blocks, AvxUnit result[]) const;
+
+    std::vector<Node> nodes_;
+    std::vector<const BitVector*> operands_;
+    size_t root_ = 0;
+};
+
+inline size_t BitVectorExpression::root() const{
+    return root_;
+}
+
+inline size_t BitVectorExpression::num_nodes() const{
+    return nodes_.size();
+}
+
+inline size_t BitVectorExpression::num_operands() const{
+    return operands_.size();
+}
+
+inline const BitVector* BitVectorExpression::GetOperand(size_t operand_id) const{
+    return operands_[operand_id];
+}
+
+}   //namespace
+#endif  //BITVECTOR_EXPRESSION_H
@@ -18,6 +18,14 @@ public:
     ~BitVectorIterator();
     bool Next();    //Move the cursor to the next 1, return true if next exists
     size_t GetPosition();   //Return the position of the cursor
+    /**
+      @brief Write the next (at most max) positions of 1's to out and
+      advance past them; return how many, 0 once all are consumed.
+      Runs of 4 zero words are skipped with one AVX test, and non-zero words
+      are expanded 8 bits at a time (see BitVectorBlock::ExpandWord).
+      Can be interleaved with Next(); GetPosition() is only valid after Next().
+      */
+    size_t NextBatch(TupleId* out, size_t max);
 
 private:
     const BitVector *bitvector_;
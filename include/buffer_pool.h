@@ -0,0 +1,72 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include    <cstddef>
+#include    "types.h"
+
+namespace byteslice{
+
+/**
+  A thread-local pool of aligned, fixed-size buffers.
+  Column blocks, bit vector blocks and byte mask blocks all use a few
+  fixed buffer sizes; released buffers are kept by the releasing thread
+  and handed out again to the next request of the same size, so that
+  repeated queries neither allocate nor fault in fresh pages.
+  The cache of a thread is bounded by count per size and by total bytes.
+
+  Buffers can also be backed by 2MB pages (see PagePolicy). Such buffers
+  are carved out of 2MB-aligned chunks shared by all threads, so that
+  two 1MB slices fill one huge page.
+*/
+class BufferPool{
+public:
+    /**
+      @brief Get a buffer of size bytes, aligned to 32 bytes at least,
+      backed according to the calling thread's page policy.
+      The content is undefined.
+      */
+    static void* Allocate(size_t size);
+    /**
+      @brief Give back a buffer obtained from Allocate with the same size.
+      */
+    static void Release(void* ptr, size_t size);
+    /**
+      @brief Free all buffers cached by the calling thread.
+      */
+    static void Clear();
+    //number of buffers cached by the calling thread
+    static size_t GetNumCached();
+    //total size of the buffers cached by the calling thread
+    static size_t GetNumCachedBytes();
+
+    /**
+      @brief Set the page policy of the process. 
+      It applies to threads without a PolicyScope.
+      */
+    static void SetPagePolicy(PagePolicy policy);
+    //page policy in effect for the calling thread
+    static PagePolicy GetPagePolicy();
+    //number of 2MB pages currently mapped with the given backing
+    static size_t GetNumHugePages(PagePolicy backing);
+
+    /**
+      Override the page policy of the calling thread within a scope.
+    */
+    class PolicyScope{
+    public:
+        PolicyScope(PagePolicy policy);
+        ~PolicyScope();
+    private:
+        int saved_;
+    };
+
+    //max number of cached buffers per size, per thread
+    static constexpr size_t kMaxNumCachedPerSize = 32;
+    //max total size of the cached buffers, per thread
+    static constexpr size_t kMaxNumCachedBytes = 64*1024*1024;
+    static constexpr size_t kHugePageSize = 2*1024*1024;
+};
+
+}   //namespace
+
+#endif  //BUFFER_POOL_H
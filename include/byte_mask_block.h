@@ -1,6 +1,7 @@
 #ifndef _BYTE_MASK_BLOCK_H_
 #define _BYTE_MASK_BLOCK_H_
 
+#include    <vector>
 #include    "common.h"
 #include    "types.h"
 #include    "bitvector_block.h"
@@ -17,6 +18,8 @@ class ByteMaskBlock{
 public:
     ByteMaskBlock(size_t num);
     ~ByteMaskBlock();
+    //Reuse the block for num tuples. Masks beyond num are cleared.
+    void Resize(size_t num);
     
     void SetAllTrue();
     void SetAllFalse();
@@ -26,6 +29,15 @@ public:
     void Set(const ByteMaskBlock* block);
     
     void Condense(BitVectorBlock* bvblk, Bitwise opt = Bitwise::kSet) const;
+    /**
+      @brief Condense the AND (combine = Bitwise::kAnd) or the OR (Bitwise::kOr)
+      of blocks of the same size into bvblk in one pass: every 32 masks of
+      every block are loaded once and the combined masks are never stored.
+      */
+    static void Condense(const std::vector<const ByteMaskBlock*> &blocks, Bitwise combine,
+            BitVectorBlock* bvblk, Bitwise opt = Bitwise::kSet);
+    //number of true masks among the first num
+    size_t CountTrue() const;
 
     //mutator and accessor
     void SetAvxUnit(size_t offset, AvxUnit src);
@@ -41,6 +53,9 @@ private:
 
     template <Bitwise OPT>
     void CondenseHelper(BitVectorBlock* bvblk) const;
+    template <Bitwise COMBINE, Bitwise OPT>
+    static void CondenseHelper(const std::vector<const ByteMaskBlock*> &blocks,
+            BitVectorBlock* bvblk);
 };
 
 inline void ByteMaskBlock::SetAvxUnit(size_t offset, AvxUnit src){
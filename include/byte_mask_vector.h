@@ -38,6 +38,9 @@ public:
     void Set(const ByteMaskVector* bmvector);
 
     void Condense(BitVector* bitvector, Bitwise opt = Bitwise::kSet) const;
+    //Condense the AND (or OR) of bmvectors in one pass (see ByteMaskBlock::Condense)
+    static void Condense(const std::vector<const ByteMaskVector*> &bmvectors, Bitwise combine,
+            BitVector* bitvector, Bitwise opt = Bitwise::kSet);
 
     //single byte operation
     bool GetByteMask(size_t pos) const;
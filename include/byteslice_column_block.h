@@ -5,6 +5,7 @@
 
 #include    "column_block.h"
 #include    "avx-utility.h"
+#include    "mapped_binary_file.h"
 
 namespace byteslice{
 
@@ -23,6 +24,14 @@ template <size_t BIT_WIDTH, Direction PDIRECTION = Direction::kRight>
 class ByteSliceColumnBlock: public ColumnBlock{
 public:
     ByteSliceColumnBlock(size_t num=kNumTuplesPerBlock);
+    /**
+      @brief Zero-copy block over a payload written by SerToFile.
+      Byte slices point into the mapping, which must outlive the block.
+      The payload must start at a 32-byte aligned offset.
+      */
+    ByteSliceColumnBlock(const MappedBinaryFile* file, size_t offset);
+    //Bytes of the payload written by SerToFile
+    static constexpr size_t PayloadSize();
     virtual ~ByteSliceColumnBlock();
 
     WordUnit GetTuple(size_t pos) const override;
@@ -30,11 +39,27 @@ public:
 
     AvxUnit GetAvxUnit(size_t offset, size_t byte_id) const override;
     void Prefetch(size_t byte_id, size_t offset, size_t distance) const override;
+    const ByteUnit* GetByteSlice(size_t byte_id) const override;
 
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bvblock,
             Bitwise bit_opt = Bitwise::kSet) const override;
     void Scan(Comparator comparator, const ColumnBlock* other_block,
             BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet) const override;
+    //lo <= x <= hi in one pass (see ScanBetweenSlices)
+    void ScanBetween(WordUnit lo, WordUnit hi, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet) const override;
+    //x IN (literals) in one pass (see ScanInSlices)
+    void ScanIn(const std::vector<WordUnit> &literals, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet) const override;
+    //popcount of the comparison masks, no bit vector written
+    size_t CountWhere(Comparator comparator, WordUnit literal) const override;
+    //SUM over the byte slices, MIN/MAX refined byte by byte
+    void Aggregate(const BitVectorBlock* filter, AggregateResult* result) const override;
+    //candidates from the first byte slice only, then decoded
+    void TopK(size_t k, bool largest, const BitVectorBlock* filter,
+            std::vector<TopKEntry>* result) const override;
+    //AVX2 gathers on every byte slice, 8 codes at a time
+    void Gather(const TupleId* positions, size_t n, WordUnit* out) const override;
 
     //Scan procedure that takes in and output 8-bit masks
     void Scan(Comparator comparator, WordUnit literal, ByteMaskBlock* bmblk, 
@@ -49,8 +74,8 @@ public:
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
     Direction GetPadDirection();
@@ -62,6 +87,10 @@ private:
     template <Comparator CMP, Bitwise OPT>
     void ScanHelper2(WordUnit literal, BitVectorBlock* bvblock) const;
 
+    //Count Helper: literal
+    template <Comparator CMP>
+    size_t CountHelper(WordUnit literal) const;
+
     //Scan Helper: other block
     template <Comparator CMP>
     void ScanHelper1(const ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* other_block,
@@ -106,16 +135,26 @@ private:
     static constexpr size_t kNumPaddingBits = kNumBytesPerCode * 8 - BIT_WIDTH;
     static constexpr Direction kPadDirection = PDIRECTION;
     static constexpr WordUnit kCodeMask = (1ULL << BIT_WIDTH) - 1;
+    //TopK keeps at least this many candidates before tightening its threshold
+    static constexpr size_t kMinNumTopKCandidates = 1024;
+    //serialized header (num_tuples_) is padded to keep byte slices aligned
+    static constexpr size_t kPayloadHeaderSize = sizeof(AvxUnit);
 
     //inline AvxUnit Reverse_movemask(uint32_t mmask) const;
     //uint64_t reverse_movemask_helper_[256];
 
     ByteUnit* data_[4];
+    bool mapped_ = false;
 
     friend class ByteSliceJoinableBlock<BIT_WIDTH>;
     friend class BytewiseScan;
 };
 
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+constexpr size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::PayloadSize(){
+    return kPayloadHeaderSize + kNumBytesPerCode*kMemSizePerByteSlice;
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline WordUnit ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(size_t pos) const{
     WordUnit ret = 0ULL;
@@ -151,6 +190,7 @@ inline WordUnit ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(size_t pos
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     switch(PDIRECTION){
         case Direction::kRight:
             value <<= kNumPaddingBits;
@@ -191,5 +231,10 @@ inline void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Prefetch(size_t byte_id
     return __builtin_prefetch(data_[byte_id] + offset + distance);
 }
 
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+inline const ByteUnit* ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetByteSlice(size_t byte_id) const{
+    return data_[byte_id];
+}
+
 }   //namespace
 #endif
@@ -38,10 +38,15 @@ typedef std::vector<ByteInColumn> Sequence;
 /**
   * @brief Evaluate complex predicates as
   * "Conjunction of Byte Disjunctions" in a bytewise pipeline manner.
+  * The per-predicate masks live on the stack: a scan allocates nothing.
   * @Warning The input columns must be ByteSlice type
   */
 class BytewiseScan{
 public:
+	static constexpr size_t kMaxNumPredicates = 64;
+	static constexpr size_t kMaxNumBytes = 4;	//ByteSlice codes are up to 32 bits
+
+
 	void AddPredicate(BytewiseAtomPredicate predicate);
 	void SetSequence(const Sequence seq);
 	bool ValidSequence(Sequence seq) const;
@@ -50,6 +55,19 @@ public:
 	Sequence NaturalSequence() const;
 	Sequence RandomSequence() const;
 
+	/**
+	  * @brief Cost-based sequence: sampled AvxUnits of the columns give how many
+	  * bytes of each column are needed before the early stop can trigger,
+	  * and the sequence minimising the expected number of bytes scanned is chosen.
+	  */
+	Sequence OptimizedSequence() const;
+	void OptimizeSequence();
+	//Expected number of bytes scanned per AvxUnit, estimated by sampling
+	double EstimateNumBytes(const Sequence &seq) const;
+	//Plan the sequence per block from a sample of the block; a plan is kept
+	//for the next blocks while the samples don't expect it to get worse
+	void SetAdaptive(bool adaptive);
+
 	void Scan(BitVector* bitvector);
 	void ScanColumnwise(BitVector* bitvector);
 	
@@ -57,8 +75,31 @@ public:
 	BytewiseAtomPredicate GetPredicate(size_t pid) const;
 	Sequence sequence() const;
 	size_t num_bytes_all() const;
+	bool adaptive() const;
 
 private:
+	static constexpr size_t kNumSampleUnits = 1024;
+	static constexpr size_t kNumBlockSampleUnits = 32;
+	//exhaustive planning up to this many (#bytes scanned per column) states
+	static constexpr size_t kMaxPlanStates = 1 << 14;
+	//adaptive: a block is re-planned when the plan in use is expected to
+	//scan this many times the bytes it was planned for
+	static constexpr double kReplanRatio = 1.1;
+
+	//For each column, the number of its leading bytes after which no tuple
+	//of an AvxUnit is undecided (num_bytes+1 if never), with the frequency
+	typedef std::vector<std::pair<std::vector<size_t>, size_t>> DecidingBytes;
+	DecidingBytes SampleDecidingBytes(size_t begin, size_t end, size_t num_units) const;
+	Sequence PlanSequence(const DecidingBytes &deciding) const;
+	//Expected number of bytes scanned per AvxUnit by seq
+	double ExpectedNumBytes(const DecidingBytes &deciding, const Sequence &seq) const;
+	//Fraction of AvxUnits still undecided after scanned[c] bytes of every column c
+	double NotStopped(const DecidingBytes &deciding, const std::vector<size_t> &scanned) const;
+
+    //Scan one block, specialised for 1..8 predicates (0 for any number)
+    template <size_t NUM_PREDICATES>
+    void ScanBlock(size_t block_id, const Sequence &sequence,
+    	const AvxUnit mask_byte[][kMaxNumBytes], BitVectorBlock* bvblk) const;
     inline void ScanKernel(Comparator comparator, 
     	const AvxUnit &byteslice1, const AvxUnit &byteslice2,
         AvxUnit &mask_less, AvxUnit &mask_greater, AvxUnit &mask_equal) const;
@@ -66,7 +107,8 @@ private:
 
 	std::vector<BytewiseAtomPredicate> conjunctions_;
 	Sequence sequence_;
-	size_t num_bytes_all_ = 0; //correct?
+	size_t num_bytes_all_ = 0; //bytes of all predicates: the length of a full sequence
+	bool adaptive_ = false;
 };
 
 }	//namespace
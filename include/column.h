@@ -20,6 +20,8 @@
 #include    "vbp_column_block.h"
 #include    "dualbyteslice_column_block.h"
 #include    "sequential_binary_file.h"
+#include    "mapped_binary_file.h"
+#include    "buffer_pool.h"
 #include    "superscalar2_byteslice_column_block.h"
 #include    "superscalar4_byteslice_column_block.h"
 
@@ -27,11 +29,17 @@ namespace byteslice{
 
 class BitVector;
 class ByteMaskVector;
+class HybridBitVector;
 
 class Column{
 public:
     Column();
-    Column(ColumnType type, size_t bit_width, size_t num=0);
+    /**
+      @param policy how the storage of every block is backed by pages.
+      Huge pages cut the DTLB misses of scans over large columns.
+      */
+    Column(ColumnType type, size_t bit_width, size_t num=0,
+            PagePolicy policy=PagePolicy::kDefault);
     ~Column();
     void Destroy();    
 
@@ -39,20 +47,116 @@ public:
     void SetTuple(size_t id, WordUnit value);
     void Resize(size_t num);
 
-    void SerToFile(SequentialWriteBinaryFile &file) const;
-    void DeserFromFile(const SequentialReadBinaryFile &file);
+    /**
+      @brief Persist the column: a header (type, bit width, #tuples, #blocks,
+      page policy), followed by every block's payload and a block index.
+      The payload of each block is produced by ColumnBlock::SerToFile.
+      */
+    bool SerToFile(SequentialWriteBinaryFile &file) const;
+    /**
+      @brief Restore a column written by SerToFile. Any existing content is discarded.
+      Blocks are located through the block index and loaded in parallel,
+      backed by pages as the page policy of the file says.
+      @return false on a short or corrupted file; the column is then unchanged.
+      */
+    bool DeserFromFile(const SequentialReadBinaryFile &file);
+    /**
+      @brief Open a column written by SerToFile without copying it.
+      ByteSlice blocks are backed directly by the mapped file, so the cost
+      does not depend on the column size and pages are faulted in on first scan.
+      Other layouts fall back to DeserFromFile. The page policy of the file
+      is kept for the blocks created later on (e.g. by Resize).
+      The mapping is owned by the column and released in Destroy().
+      */
+    bool MapBinaryFile(std::string filepath);
 
     /**
       @brief Load the column from a projection file in text format. One value per line.
+      @return the number of values loaded, at most num_tuples().
       */
     size_t LoadTextFile(std::string filepath);
+    /**
+      @brief Load a set of columns from one delimited text file in a single pass,
+      the k-th field of each line going to columns[k]. Lines beyond the
+      smallest column are ignored.
+      The file is mapped and split into line-aligned chunks counted in parallel;
+      the rows of every block are then parsed into a per-thread buffer and
+      loaded with one BulkLoadArray per column, blocks in parallel.
+      @return the number of lines loaded, or 0 on error (e.g. a field that is
+      not an unsigned integer); the columns may then be partly loaded.
+      */
+    static size_t LoadCsvFile(std::string filepath, const std::vector<Column*> &columns,
+            char delimiter = ',');
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t pos=0);
+    //Recompute the zone map of every block (see ColumnBlock::RebuildZoneMap)
+    void RebuildZoneMaps();
 
+    /**
+      @brief Blocks whose zone map decides the predicate are not scanned:
+      their bit vector block is filled directly.
+      */
     void Scan(Comparator comparator, WordUnit literal,
             BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
     void Scan(Comparator comparator, const Column* other_column, 
             BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    /**
+      @brief Scan into a hybrid bit vector. Each block is scanned into a
+      block-sized bit vector that is compressed right away, so sparse
+      results never take 1 bit per tuple.
+      */
+    void Scan(Comparator comparator, WordUnit literal, HybridBitVector* result) const;
+    /**
+      @brief Range predicate lo <= x <= hi. ByteSlice layouts read every
+      slice once for both bounds (see ColumnBlock::ScanBetween).
+      */
+    void ScanBetween(WordUnit lo, WordUnit hi,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    /**
+      @brief IN-list predicate x IN (literals), in any order and with duplicates.
+      ByteSlice and HybridSlice make one pass over their slices whatever the
+      list size (see ColumnBlock::ScanIn).
+      */
+    void ScanIn(const std::vector<WordUnit> &literals,
+            BitVector* bitvector, Bitwise bit_opt = Bitwise::kSet) const;
+    /**
+      @brief COUNT(*) WHERE x comparator literal, without materializing
+      a bit vector (see ColumnBlock::CountWhere). Per-block counts are
+      reduced across threads.
+      */
+    size_t CountWhere(Comparator comparator, WordUnit literal) const;
+    /**
+      @brief COUNT/SUM/MIN/MAX (and AVG) of the tuples selected by filter,
+      or of every tuple if filter is nullptr. Blocks are aggregated in
+      parallel (see ColumnBlock::Aggregate) and merged at the end.
+      */
+    AggregateResult Aggregate(const BitVector* filter = nullptr) const;
+    /**
+      @brief Aggregate of the tuples for which
+      "predicate_column comparator literal" holds.
+      Each block of predicate_column is scanned into a bit vector block
+      that is aggregated right away, while still in cache.
+      */
+    AggregateResult AggregateWhere(const Column* predicate_column,
+            Comparator comparator, WordUnit literal) const;
+    /**
+      @brief The k smallest (or largest) codes among the tuples selected by
+      filter (every tuple if nullptr), with their tuple ids, best first
+      (see TopKBetter). Blocks are searched in parallel
+      (see ColumnBlock::TopK) and their results merged.
+      */
+    std::vector<TopKEntry> TopK(size_t k, bool largest = false,
+            const BitVector* filter = nullptr) const;
+    //MIN/MAX as top-1; false if no tuple is selected
+    bool Min(WordUnit* min, const BitVector* filter = nullptr) const;
+    bool Max(WordUnit* max, const BitVector* filter = nullptr) const;
+    /**
+      @brief out[i] = GetTuple(rids[i]) for i < n, in any order of rids.
+      Each run of ids falling in the same block is decoded by one call of
+      ColumnBlock::Gather, so sorted lists (e.g. from a BitVectorIterator)
+      cost one virtual call per block. Chunks of the list run in parallel.
+      */
+    void Gather(const TupleId* rids, size_t n, WordUnit* out) const;
 
     void ScanByte(size_t byte_id, Comparator comparator, ByteUnit literal,
         ByteMaskVector* bm_less, ByteMaskVector* bm_greater, ByteMaskVector* bm_equal, 
@@ -61,19 +165,33 @@ public:
         ByteMaskVector* bm_less, ByteMaskVector* bm_greater, ByteMaskVector* bm_equal) const;
 
     ColumnBlock* CreateNewBlock() const;
+    /**
+      @brief A block backed by the payload at offset of a mapped column file.
+      @return NULL if the layout can't be mapped, or if the payload does not
+      fit in [offset, end).
+      */
+    ColumnBlock* CreateMappedBlock(const MappedBinaryFile* file, size_t offset,
+            size_t end) const;
 
     //accessors
     size_t num_tuples() const;
     size_t bit_width() const;
     ColumnType type() const;
+    PagePolicy page_policy() const;
     size_t GetNumBlocks() const;
     ColumnBlock* GetBlock(size_t block_id) const;
 
 private:
+    //Exchange the content of two columns; the other one takes over this
+    //column's blocks and mapping, and releases them when destroyed.
+    void Swap(Column &other);
+
     size_t num_tuples_;
     size_t bit_width_;
     ColumnType type_;
+    PagePolicy page_policy_;
     std::vector<ColumnBlock*> blocks_;
+    MappedBinaryFile* mapped_file_;
 };
 
 inline size_t Column::num_tuples() const{
@@ -88,6 +206,10 @@ inline ColumnType Column::type() const{
     return type_;
 }
 
+inline PagePolicy Column::page_policy() const{
+    return page_policy_;
+}
+
 inline size_t Column::GetNumBlocks() const{
     return blocks_.size();
 }
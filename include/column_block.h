@@ -1,12 +1,15 @@
 #ifndef COLUMN_BLOCK_H
 #define COLUMN_BLOCK_H
 
+#include    <vector>
 #include    "common.h"
 #include    "types.h"
 #include    "avx-utility.h"
+#include    "aggregate.h"
 #include    "bitvector_block.h"
 #include    "byte_mask_block.h"
 #include    "sequential_binary_file.h"
+#include    "zone_map.h"
 
 namespace byteslice{
 
@@ -20,15 +23,65 @@ public:
     virtual void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet) const = 0;
     virtual void Scan(Comparator comparator, const ColumnBlock* column_block, BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet) const = 0;
     virtual void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) = 0;
-    virtual void SerToFile(SequentialWriteBinaryFile &file) const = 0;
-    virtual void DeserFromFile(const SequentialReadBinaryFile &file) = 0;
+    //Both return false on a short read/write or a bad tuple count;
+    //the block content is then unspecified.
+    virtual bool SerToFile(SequentialWriteBinaryFile &file) const = 0;
+    virtual bool DeserFromFile(const SequentialReadBinaryFile &file) = 0;
     virtual bool Resize(size_t size) = 0;
 
+    /**
+      @brief Range predicate lo <= x <= hi.
+      The default runs two scans; byte-sliced layouts evaluate both bounds
+      in a single pass over their slices.
+      */
+    virtual void ScanBetween(WordUnit lo, WordUnit hi, BitVectorBlock* bv_block,
+            Bitwise bit_opt = Bitwise::kSet) const;
+    /**
+      @brief IN-list predicate x IN (literals); literals are sorted and unique.
+      The default ORs one equality scan per literal; ByteSlice and HybridSlice
+      evaluate the whole list in a single pass over their slices.
+      */
+    virtual void ScanIn(const std::vector<WordUnit> &literals, BitVectorBlock* bv_block,
+            Bitwise bit_opt = Bitwise::kSet) const;
+    /**
+      @brief Number of tuples satisfying the predicate.
+      The default scans into a temporary bit vector block and counts it;
+      ByteSlice popcounts its comparison masks without writing any bits.
+      */
+    virtual size_t CountWhere(Comparator comparator, WordUnit literal) const;
+    /**
+      @brief Merge into result the COUNT/SUM/MIN/MAX of the tuples whose bit
+      is set in filter, or of every tuple if filter is nullptr.
+      The default decodes the selected tuples one by one; ByteSlice sums
+      its byte slices and finds MIN/MAX byte by byte without decoding.
+      */
+    virtual void Aggregate(const BitVectorBlock* filter, AggregateResult* result) const;
+    /**
+      @brief Append to result the k smallest (or largest) codes among the tuples
+      selected by filter (every tuple if nullptr), with their positions in
+      the block, best first (see TopKBetter).
+      The default decodes every selected tuple; ByteSlice reads the first
+      byte slice and decodes only the tuples whose first byte can still make it.
+      */
+    virtual void TopK(size_t k, bool largest, const BitVectorBlock* filter,
+            std::vector<TopKEntry>* result) const;
+    /**
+      @brief out[i] = the code at positions[i] of the block, for i < n.
+      The default calls GetTuple per position; layouts override it with a
+      loop over their own (inlined) GetTuple, and ByteSlice gathers
+      8 codes at a time from its byte slices.
+      */
+    virtual void Gather(const TupleId* positions, size_t n, WordUnit* out) const;
+
     virtual AvxUnit GetAvxUnit(size_t offset, size_t byte_id) const{
         return avx_zero();
     }
     virtual void Prefetch(size_t byte_id, size_t offset, size_t distance) const{
     }
+    //Raw byte slice of a ByteSlice block; nullptr for other layouts
+    virtual const ByteUnit* GetByteSlice(size_t byte_id) const{
+        return nullptr;
+    }
 
     //Scan procedure that takes in and output 8-bit masks
     //This method is only used by ByteSlice
@@ -48,19 +101,36 @@ public:
     	ByteMaskBlock* bm_less, ByteMaskBlock* bm_greater, ByteMaskBlock* bm_equal) const{
     }
 
+    /**
+      @brief Recompute the zone map from the tuples of the block.
+      SetTuple can only widen summaries: rebuild after many in-place updates.
+      */
+    void RebuildZoneMap();
+
     //accessor
     ColumnType type() const;
     size_t bit_width() const;
     size_t num_tuples() const;
+    const ZoneMap& zone_map() const;
+    ZoneMap& zone_map();
 
 
 protected:
     ColumnBlock(ColumnType type, size_t bit_width, size_t num):
-        type_(type), bit_width_(bit_width), num_tuples_(num){
+        type_(type), bit_width_(bit_width), num_tuples_(num), zone_map_(bit_width){
     }
+    //Layouts call this at the end of their constructor, once the storage
+    //is zeroed: every tuple then decodes to the same value.
+    void InitZoneMap();
+    //Layouts call this from Resize after setting num_tuples_: the tuples
+    //past old_num may still hold values from before a shrink.
+    void ResizeZoneMap(size_t old_num);
     const ColumnType type_;
     const size_t bit_width_;
     size_t num_tuples_;
+    //maintained by the constructor, Resize, SetTuple and BulkLoadArray
+    //of every layout
+    ZoneMap zone_map_;
     
 
 };
@@ -77,6 +147,149 @@ inline size_t ColumnBlock::num_tuples() const{
     return num_tuples_;
 }
 
+inline const ZoneMap& ColumnBlock::zone_map() const{
+    return zone_map_;
+}
+
+inline ZoneMap& ColumnBlock::zone_map(){
+    return zone_map_;
+}
+
+inline void ColumnBlock::ScanBetween(WordUnit lo, WordUnit hi, BitVectorBlock* bv_block,
+        Bitwise bit_opt) const{
+    switch(bit_opt){
+        case Bitwise::kSet:
+        case Bitwise::kAnd:
+            Scan(Comparator::kGreaterEqual, lo, bv_block, bit_opt);
+            Scan(Comparator::kLessEqual, hi, bv_block, Bitwise::kAnd);
+            break;
+        case Bitwise::kOr:{
+            BitVectorBlock range(num_tuples_);
+            Scan(Comparator::kGreaterEqual, lo, &range, Bitwise::kSet);
+            Scan(Comparator::kLessEqual, hi, &range, Bitwise::kAnd);
+            bv_block->Or(&range);
+            break;
+        }
+    }
+}
+
+inline void ColumnBlock::ScanIn(const std::vector<WordUnit> &literals,
+        BitVectorBlock* bv_block, Bitwise bit_opt) const{
+    if(literals.empty()){
+        ZoneMap::Fill(ZoneMatch::kNone, bit_opt, bv_block, 0, bv_block->num_word_units());
+        bv_block->ClearTail();
+        return;
+    }
+    switch(bit_opt){
+        case Bitwise::kSet:
+            Scan(Comparator::kEqual, literals[0], bv_block, Bitwise::kSet);
+            for(size_t i = 1; i < literals.size(); i++){
+                Scan(Comparator::kEqual, literals[i], bv_block, Bitwise::kOr);
+            }
+            break;
+        case Bitwise::kAnd:
+        case Bitwise::kOr:{
+            BitVectorBlock matches(num_tuples_);
+            ScanIn(literals, &matches, Bitwise::kSet);
+            if(Bitwise::kAnd == bit_opt){
+                bv_block->And(&matches);
+            }
+            else{
+                bv_block->Or(&matches);
+            }
+            break;
+        }
+    }
+}
+
+inline size_t ColumnBlock::CountWhere(Comparator comparator, WordUnit literal) const{
+    BitVectorBlock matches(num_tuples_);
+    Scan(comparator, literal, &matches, Bitwise::kSet);
+    return matches.CountOnes();
+}
+
+inline void ColumnBlock::Aggregate(const BitVectorBlock* filter,
+        AggregateResult* result) const{
+    for(size_t offset = 0; offset < num_tuples_; offset += kNumWordBits){
+        WordUnit word = (nullptr == filter)? ~WordUnit(0) : filter->GetWordUnit(offset / kNumWordBits);
+        if(num_tuples_ - offset < kNumWordBits){
+            word &= (1ULL << (num_tuples_ - offset)) - 1;
+        }
+        while(0 != word){
+            result->Add(GetTuple(offset + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+inline void ColumnBlock::TopK(size_t k, bool largest, const BitVectorBlock* filter,
+        std::vector<TopKEntry>* result) const{
+    if(0 == k){
+        return;
+    }
+    //the k best so far, the worst of them on top
+    auto better = [largest](const TopKEntry &a, const TopKEntry &b){
+        return TopKBetter(a, b, largest);
+    };
+    std::vector<TopKEntry> heap;
+    for(size_t offset = 0; offset < num_tuples_; offset += kNumWordBits){
+        WordUnit word = (nullptr == filter)? ~WordUnit(0) : filter->GetWordUnit(offset / kNumWordBits);
+        if(num_tuples_ - offset < kNumWordBits){
+            word &= (1ULL << (num_tuples_ - offset)) - 1;
+        }
+        while(0 != word){
+            size_t pos = offset + __builtin_ctzll(word);
+            TopKEntry entry(GetTuple(pos), pos);
+            if(heap.size() < k){
+                heap.push_back(entry);
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+            else if(better(entry, heap.front())){
+                std::pop_heap(heap.begin(), heap.end(), better);
+                heap.back() = entry;
+                std::push_heap(heap.begin(), heap.end(), better);
+            }
+            word &= word - 1;
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), better);
+    result->insert(result->end(), heap.begin(), heap.end());
+}
+
+inline void ColumnBlock::Gather(const TupleId* positions, size_t n, WordUnit* out) const{
+    for(size_t i = 0; i < n; i++){
+        out[i] = GetTuple(positions[i]);
+    }
+}
+
+inline void ColumnBlock::InitZoneMap(){
+    if(0 < num_tuples_){
+        zone_map_.Widen(0, num_tuples_, GetTuple(0));
+    }
+}
+
+inline void ColumnBlock::ResizeZoneMap(size_t old_num){
+    if(num_tuples_ < old_num){
+        zone_map_.Truncate(num_tuples_);
+        return;
+    }
+    for(size_t pos = old_num; pos < num_tuples_; pos++){
+        zone_map_.Update(pos, GetTuple(pos));
+    }
+}
+
+inline void ColumnBlock::RebuildZoneMap(){
+    WordUnit codes[ZoneMap::kNumTuplesPerZone];
+    zone_map_.Clear();
+    for(size_t pos = 0; pos < num_tuples_; pos += ZoneMap::kNumTuplesPerZone){
+        size_t num = std::min(ZoneMap::kNumTuplesPerZone, num_tuples_ - pos);
+        for(size_t i = 0; i < num; i++){
+            codes[i] = GetTuple(pos + i);
+        }
+        zone_map_.Update(codes, num, pos, num_tuples_);
+    }
+}
+
 }
 
 #endif  //COLUMN_BLOCK_H
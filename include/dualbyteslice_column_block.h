@@ -23,12 +23,15 @@ public:
             Bitwise bit_opt = Bitwise::kSet) const override;
     void Scan(Comparator comparator, const ColumnBlock* other_block,
             BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet) const override;
+    //lo <= x <= hi in one pass (see ScanBetweenSlices)
+    void ScanBetween(WordUnit lo, WordUnit hi, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet) const override;
 
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
     Direction GetPadDirection();
@@ -104,6 +107,7 @@ inline WordUnit DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(size_t
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     switch(PDIRECTION){
         case Direction::kRight:
             value <<= kNumPaddingBits;
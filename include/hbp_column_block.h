@@ -22,6 +22,7 @@ public:
 
     WordUnit GetTuple(size_t pos) const override;
     void SetTuple(size_t pos, WordUnit value) override;
+    void Gather(const TupleId* positions, size_t n, WordUnit* out) const override;
 
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bvblock,
             Bitwise bit_opt = Bitwise::kSet) const override;
@@ -30,8 +31,8 @@ public:
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
 private:
@@ -95,8 +96,16 @@ inline WordUnit HbpColumnBlock<BIT_WIDTH>::GetTuple(size_t pos) const{
     return (word >> (seek_helpers_[id_in_segment].shift_in_word)) & kCodeMask;
 }
 
+template <size_t BIT_WIDTH>
+inline void HbpColumnBlock<BIT_WIDTH>::Gather(const TupleId* positions, size_t n, WordUnit* out) const{
+    for(size_t i = 0; i < n; i++){
+        out[i] = HbpColumnBlock<BIT_WIDTH>::GetTuple(positions[i]);
+    }
+}
+
 template <size_t BIT_WIDTH>
 inline void HbpColumnBlock<BIT_WIDTH>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     value &= kCodeMask;
     size_t segment_id = pos / kNumCodesPerSegment;
     size_t id_in_segment = pos % kNumCodesPerSegment;
@@ -0,0 +1,127 @@
+#ifndef HYBRID_BITVECTOR_H
+#define HYBRID_BITVECTOR_H
+
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "bitvector.h"
+#include    "bitvector_block.h"
+
+namespace byteslice{
+
+enum class ContainerType{
+    kArray,     //sorted offsets of the 1's
+    kBitmap,    //one bit per tuple
+    kRun        //sorted [first, last] ranges of 1's
+};
+
+/**
+  The 1's of a chunk of kNumTuplesPerContainer tuples, in whichever of
+  the three forms takes the least memory: 2 bytes per 1 (array),
+  8KB (bitmap) or 4 bytes per run of 1's (run). Offsets are 16-bit.
+  And/Or work on arrays directly and go through bitmaps otherwise;
+  the result picks its form again.
+*/
+class BitContainer{
+public:
+    static constexpr size_t kNumTuplesPerContainer = 1 << 16;
+    static constexpr size_t kNumWordsPerContainer = kNumTuplesPerContainer / kNumWordBits;
+
+    //Replace the content by words[0..num_words) of a bitmap
+    void FromWords(const WordUnit* words, size_t num_words);
+    //Write the content as num_words words of a bitmap
+    void ToWords(WordUnit* words, size_t num_words) const;
+    //Every tuple in [0, num) is a 1
+    void SetRange(size_t num);
+    void Clear();
+
+    void And(const BitContainer &other);
+    void Or(const BitContainer &other);
+
+    bool GetBit(size_t offset) const;
+    //Write base + the offset of every 1, in order; return how many
+    size_t GetPositions(TupleId base, TupleId* positions) const;
+
+    //accessors
+    ContainerType type() const;
+    size_t CountOnes() const;
+    size_t GetNumBytes() const;
+
+private:
+    //pick the smallest form for the bitmap words[0..num_words)
+    void Pack(const WordUnit* words, size_t num_words);
+
+    ContainerType type_ = ContainerType::kArray;
+    size_t count_ = 0;
+    //offsets (kArray), or first/last pairs (kRun)
+    std::vector<uint16_t> array_;
+    //kBitmap only
+    std::vector<WordUnit> bitmap_;
+};
+
+inline ContainerType BitContainer::type() const{
+    return type_;
+}
+
+inline size_t BitContainer::CountOnes() const{
+    return count_;
+}
+
+/**
+  A bit vector for sparse (or clustered) results: one BitContainer per
+  kNumTuplesPerContainer tuples instead of 1 bit per tuple.
+  An empty result of 2B tuples takes a few hundred KB instead of 256MB.
+  Converts from and to the dense BitVector; Column::Scan can write into it
+  directly, block by block.
+*/
+class HybridBitVector{
+public:
+    HybridBitVector(size_t num);
+
+    //Compress / decompress a dense bit vector of the same size
+    void FromBitVector(const BitVector* bitvector);
+    void ToBitVector(BitVector* bitvector) const;
+    //Compress a block of a dense bit vector into the containers it covers
+    void FromBVBlock(size_t block_id, const BitVectorBlock* bvblock);
+    void ToBVBlock(size_t block_id, BitVectorBlock* bvblock) const;
+    //Every tuple of a block is a 1 (or a 0)
+    void SetBlock(size_t block_id, bool one);
+
+    void And(const HybridBitVector* other);
+    void Or(const HybridBitVector* other);
+
+    bool GetBit(size_t pos) const;
+    size_t CountOnes() const;
+    //The ids of the 1's in increasing order (see BitVector::ToPositions)
+    void ToPositions(std::vector<TupleId>* positions) const;
+
+    //accessors
+    size_t num() const;
+    size_t GetNumContainers() const;
+    const BitContainer& GetContainer(size_t id) const;
+    //memory taken by the containers
+    size_t GetNumBytes() const;
+
+private:
+    //number of tuples in a container
+    size_t ContainerSize(size_t id) const;
+
+    std::vector<BitContainer> containers_;
+    const size_t num_;
+};
+
+inline size_t HybridBitVector::num() const{
+    return num_;
+}
+
+inline size_t HybridBitVector::GetNumContainers() const{
+    return containers_.size();
+}
+
+inline const BitContainer& HybridBitVector::GetContainer(size_t id) const{
+    return containers_[id];
+}
+
+}   //namespace
+
+#endif  //HYBRID_BITVECTOR_H
@@ -22,16 +22,20 @@ public:
 
     WordUnit GetTuple(size_t pos) const override;
     void SetTuple(size_t pos, WordUnit value) override;
+    void Gather(const TupleId* positions, size_t n, WordUnit* out) const override;
 
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bvblock,
             Bitwise bit_opt = Bitwise::kSet) const override;
     void Scan(Comparator comparator, const ColumnBlock* other_block,
             BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet) const override;
+    //x IN (literals) in one pass over byte and bit slices (see ScanInSlices)
+    void ScanIn(const std::vector<WordUnit> &literals, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet) const override;
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
     size_t GetNumByteSlices() const;
@@ -52,6 +56,9 @@ private:
     void ScanHelper2(const HybridSliceColumnBlock<BIT_WIDTH>* other_block,
                             BitVectorBlock* bvblock) const;
     
+    //Store the byte-sliced part (the code without its bit-sliced bits)
+    inline void SetByteSlices(size_t pos, WordUnit value);
+
     //Scan Kernels
     template <Comparator CMP, size_t BYTE_ID>
     inline void ScanKernelByteSlice(const AvxUnit &byteslice1, const AvxUnit &byteslice2,
@@ -69,6 +76,11 @@ private:
         = (kNumBitSlices > 0)? (BIT_WIDTH / 8) : CEIL(BIT_WIDTH, 8);
     static constexpr size_t kNumPaddingBits
         = (8 * kNumByteSlices + kNumBitSlices) - BIT_WIDTH;
+
+    static constexpr size_t kMemSizePerByteSlice
+        = CEIL(kNumTuplesPerBlock, sizeof(AvxUnit))*sizeof(AvxUnit);
+    static constexpr size_t kMemSizePerBitSlice
+        = sizeof(AvxUnit) * CEIL(kNumTuplesPerBlock, kNumAvxBits);
     
 
     ByteUnit* data_[4];
@@ -128,8 +140,16 @@ inline WordUnit HybridSliceColumnBlock<BIT_WIDTH>::GetTuple(size_t pos) const{
     return ret;
 }
 
+template <size_t BIT_WIDTH>
+inline void HybridSliceColumnBlock<BIT_WIDTH>::Gather(const TupleId* positions, size_t n, WordUnit* out) const{
+    for(size_t i = 0; i < n; i++){
+        out[i] = HybridSliceColumnBlock<BIT_WIDTH>::GetTuple(positions[i]);
+    }
+}
+
 template <size_t BIT_WIDTH>
 inline void HybridSliceColumnBlock<BIT_WIDTH>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     assert(pos <= num_tuples_);
     //Fill in bit slice first
     if(kNumBitSlices > 0){
@@ -144,6 +164,11 @@ inline void HybridSliceColumnBlock<BIT_WIDTH>::SetTuple(size_t pos, WordUnit val
         }
     }
     
+    SetByteSlices(pos, value);
+}
+
+template <size_t BIT_WIDTH>
+inline void HybridSliceColumnBlock<BIT_WIDTH>::SetByteSlices(size_t pos, WordUnit value){
     if(kNumPaddingBits > 0){
         value <<= kNumPaddingBits;
     }
@@ -0,0 +1,296 @@
+#ifndef IN_LIST_SCAN_H
+#define IN_LIST_SCAN_H
+
+#include    <algorithm>
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "avx-utility.h"
+#include    "bitvector_block.h"
+#include    "zone_map.h"
+
+namespace byteslice{
+
+//Lists up to this size compare every literal against the shared slice loads
+static constexpr size_t kInListMaxSmallSize = 8;
+
+/**
+  IN-list predicate x IN (literals) over a block stored as byte slices
+  (FLIPPED, the most significant first) optionally followed by bit slices
+  (HybridSlice: bit slice NUM_BIT_SLICES-1 holds the least significant bit).
+  literals are sorted, unique, and fit in the codes.
+
+  Every 256 tuples are evaluated in one pass, 32 at a time:
+  - small lists: each byte slice is loaded once and compared against every
+    literal still possible, keeping one equal-mask per literal;
+  - large lists: the first byte slice is tested against a 256-bit bitmap of
+    the literals' first bytes (a nibble lookup with shuffles). Surviving
+    candidates are refined on a bitmap of their first two bytes, then on
+    the full code (BLOCK::GetTuple), stopping as soon as the bytes tested
+    hold the whole code. Codes with at most one byte slice fit in 16 bits
+    and are refined on a bitmap of the codes; without byte slices every
+    tuple is refined.
+  Zones decided by the zone map are filled without being scanned.
+*/
+template <typename BLOCK, size_t NUM_BYTE_SLICES, size_t NUM_BIT_SLICES, Bitwise OPT>
+void ScanInSlicesHelper(const BLOCK* block, ByteUnit* const byte_slices[],
+        WordUnit* const bit_slices[], size_t num_tuples, size_t padding_bits,
+        const std::vector<WordUnit> &literals, const ZoneMap &zone_map,
+        BitVectorBlock* bvblock){
+    constexpr size_t kNumTuplesPerUnit = sizeof(AvxUnit);
+    constexpr size_t kNumUnitsPerGroup = kNumAvxBits / kNumTuplesPerUnit;
+    //whether the leading byte slices hold the whole code
+    constexpr bool kExactFirstByte = (1 == NUM_BYTE_SLICES && 0 == NUM_BIT_SLICES);
+    constexpr bool kExactTwoBytes = (2 == NUM_BYTE_SLICES && 0 == NUM_BIT_SLICES);
+    const size_t num_literals = literals.size();
+    const bool small = num_literals <= kInListMaxSmallSize;
+
+    //small lists: the literals split into slices
+    AvxUnit literal_bytes[kInListMaxSmallSize * 4];
+    uint32_t literal_bits[kInListMaxSmallSize * 8];
+    //large lists: lookup tables on the nibbles of the first byte
+    alignas(sizeof(AvxUnit)) ByteUnit row_low[sizeof(AvxUnit)] = {0};
+    alignas(sizeof(AvxUnit)) ByteUnit row_high[sizeof(AvxUnit)] = {0};
+    alignas(sizeof(AvxUnit)) ByteUnit bit_of_nibble[sizeof(AvxUnit)] = {0};
+    //large lists: the (first byte, second byte) pairs of the literals, or
+    //the literals themselves if they fit in 16 bits
+    std::vector<WordUnit> pairs;
+    if(!small && !kExactFirstByte){
+        pairs.resize((1 << 16) / kNumWordBits, 0);
+    }
+    for(size_t i = 0; i < num_literals; i++){
+        WordUnit bytes = (literals[i] >> NUM_BIT_SLICES) << padding_bits;
+        if(small){
+            for(size_t k = 0; k < NUM_BYTE_SLICES; k++){
+                size_t shift = 8 * (NUM_BYTE_SLICES - 1 - k);
+                literal_bytes[i * NUM_BYTE_SLICES + k] = avx_set1<ByteUnit>(
+                        FLIP(static_cast<ByteUnit>(bytes >> shift)));
+            }
+            for(size_t j = 0; j < NUM_BIT_SLICES; j++){
+                size_t shift = NUM_BIT_SLICES - 1 - j;
+                literal_bits[i * NUM_BIT_SLICES + j] =
+                    0U - static_cast<uint32_t>((literals[i] >> shift) & 1ULL);
+            }
+        }
+        else{
+            if(NUM_BYTE_SLICES > 0){
+                ByteUnit first = FLIP(static_cast<ByteUnit>(bytes >> (8 * (NUM_BYTE_SLICES - 1))));
+                size_t hi = first >> 4;
+                size_t lo = first & 0x0F;
+                ByteUnit* row = (hi < 8)? row_low : row_high;
+                row[lo] |= 1 << (hi & 7);
+                row[lo + 16] |= 1 << (hi & 7);
+            }
+            if(NUM_BYTE_SLICES > 1){
+                size_t pair = (bytes >> (8 * (NUM_BYTE_SLICES - 2))) & 0xFFFF;
+                pair ^= 0x8080;     //FLIPPED as stored
+                pairs[pair / kNumWordBits] |= 1ULL << (pair % kNumWordBits);
+            }
+            else if(!kExactFirstByte){
+                pairs[literals[i] / kNumWordBits] |= 1ULL << (literals[i] % kNumWordBits);
+            }
+        }
+    }
+    for(size_t h = 0; h < 16; h++){
+        bit_of_nibble[h] = bit_of_nibble[h + 16] = 1 << (h & 7);
+    }
+    const AvxUnit m_row_low = _mm256_load_si256(reinterpret_cast<const __m256i*>(row_low));
+    const AvxUnit m_row_high = _mm256_load_si256(reinterpret_cast<const __m256i*>(row_high));
+    const AvxUnit m_bit_of_nibble = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(bit_of_nibble));
+    const AvxUnit m_nibble = avx_set1<ByteUnit>(0x0F);
+    const AvxUnit m_seven = avx_set1<ByteUnit>(7);
+
+    AvxUnit m_equal[kInListMaxSmallSize][kNumUnitsPerGroup];
+    //For every 256 tuples
+    for(size_t offset = 0; offset < num_tuples; offset += kNumAvxBits){
+        const size_t bv_word_id = offset / kNumWordBits;
+        if(0 == offset % ZoneMap::kNumTuplesPerZone){
+            size_t zone_id = offset / ZoneMap::kNumTuplesPerZone;
+            ZoneMatch match = zone_map.MatchIn(zone_id, literals);
+            if(ZoneMatch::kSome != match){
+                size_t end_word = std::min(bv_word_id + ZoneMap::kNumWordsPerZone,
+                        bvblock->num_word_units());
+                ZoneMap::Fill(match, OPT, bvblock, bv_word_id, end_word);
+                offset += ZoneMap::kNumTuplesPerZone - kNumAvxBits;
+                continue;
+            }
+        }
+
+        uint32_t input[kNumUnitsPerGroup];
+        //tuples whose result is not decided by the input bit
+        uint32_t active[kNumUnitsPerGroup];
+        uint32_t any_active = 0;
+        for(size_t u = 0; u < kNumUnitsPerGroup; u++){
+            input[u] = 0;
+            active[u] = ~0U;
+            if(Bitwise::kSet != OPT){
+                input[u] = static_cast<uint32_t>(
+                        bvblock->GetWordUnit(bv_word_id + u / 2) >> (u % 2 * 32));
+                active[u] = (Bitwise::kAnd == OPT)? input[u] : ~input[u];
+            }
+            any_active |= active[u];
+        }
+
+        uint32_t result[kNumUnitsPerGroup] = {0};
+        if(0 != any_active && small){
+            //tuples still equal to some literal
+            uint32_t pending[kNumUnitsPerGroup];
+            std::copy(active, active + kNumUnitsPerGroup, pending);
+            for(size_t k = 0; k < NUM_BYTE_SLICES; k++){
+                uint32_t any_pending = 0;
+                for(size_t u = 0; u < kNumUnitsPerGroup; u++){
+                    size_t pos = offset + u * kNumTuplesPerUnit;
+                    if(0 == k){
+                        __builtin_prefetch(byte_slices[0] + pos + 1024);
+                    }
+                    AvxUnit slice = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(
+                                byte_slices[k] + pos));
+                    AvxUnit m_pending = avx_zero();
+                    for(size_t i = 0; i < num_literals; i++){
+                        AvxUnit m_eq = avx_cmpeq<ByteUnit>(slice,
+                                literal_bytes[i * NUM_BYTE_SLICES + k]);
+                        m_equal[i][u] = (0 == k)? m_eq : avx_and(m_equal[i][u], m_eq);
+                        m_pending = avx_or(m_pending, m_equal[i][u]);
+                    }
+                    pending[u] = static_cast<uint32_t>(_mm256_movemask_epi8(m_pending))
+                        & active[u];
+                    any_pending |= pending[u];
+                }
+                //early stop: no tuple equal to any literal so far
+                if(0 == any_pending){
+                    break;
+                }
+            }
+            for(size_t u = 0; u < kNumUnitsPerGroup; u++){
+                if(0 == NUM_BIT_SLICES || 0 == pending[u]){
+                    result[u] = pending[u];
+                    continue;
+                }
+                size_t pos = offset + u * kNumTuplesPerUnit;
+                uint32_t bits[NUM_BIT_SLICES > 0? NUM_BIT_SLICES : 1];
+                for(size_t j = 0; j < NUM_BIT_SLICES; j++){
+                    bits[j] = static_cast<uint32_t>(
+                            bit_slices[j][pos / kNumWordBits] >> (pos % kNumWordBits));
+                }
+                for(size_t i = 0; i < num_literals; i++){
+                    uint32_t equal = (NUM_BYTE_SLICES > 0)?
+                        static_cast<uint32_t>(_mm256_movemask_epi8(m_equal[i][u])) : ~0U;
+                    for(size_t j = 0; j < NUM_BIT_SLICES; j++){
+                        equal &= ~(bits[j] ^ literal_bits[i * NUM_BIT_SLICES + j]);
+                    }
+                    result[u] |= equal;
+                }
+                result[u] &= pending[u];
+            }
+        }
+        else if(0 != any_active){
+            for(size_t u = 0; u < kNumUnitsPerGroup; u++){
+                size_t pos = offset + u * kNumTuplesPerUnit;
+                uint32_t candidates = active[u];
+                if(NUM_BYTE_SLICES > 0){
+                    //membership of the first byte: row[lo] holds one bit per hi nibble
+                    AvxUnit first = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(
+                                byte_slices[0] + pos));
+                    __builtin_prefetch(byte_slices[0] + pos + 1024);
+                    AvxUnit m_hi = avx_and(_mm256_srli_epi16(first, 4), m_nibble);
+                    AvxUnit m_lo = avx_and(first, m_nibble);
+                    AvxUnit m_row = _mm256_blendv_epi8(
+                            _mm256_shuffle_epi8(m_row_low, m_lo),
+                            _mm256_shuffle_epi8(m_row_high, m_lo),
+                            _mm256_cmpgt_epi8(m_hi, m_seven));
+                    AvxUnit m_bit = _mm256_shuffle_epi8(m_bit_of_nibble, m_hi);
+                    AvxUnit m_miss = avx_cmpeq<ByteUnit>(avx_and(m_row, m_bit), avx_zero());
+                    candidates &= ~static_cast<uint32_t>(_mm256_movemask_epi8(m_miss));
+                }
+                if(kExactFirstByte){
+                    result[u] = candidates;
+                    continue;
+                }
+                //refine the candidates: on the first two bytes, then on the full code
+                while(0 != candidates){
+                    size_t i = __builtin_ctz(candidates);
+                    candidates &= candidates - 1;
+                    if(NUM_BYTE_SLICES > 1){
+                        size_t pair = (static_cast<size_t>(byte_slices[0][pos + i]) << 8)
+                            | byte_slices[1][pos + i];
+                        if(0 == (pairs[pair / kNumWordBits] & (1ULL << (pair % kNumWordBits)))){
+                            continue;
+                        }
+                        if(kExactTwoBytes){
+                            result[u] |= 1U << i;
+                        }
+                        else if(std::binary_search(literals.begin(), literals.end(),
+                                    block->BLOCK::GetTuple(pos + i))){
+                            result[u] |= 1U << i;
+                        }
+                    }
+                    else{
+                        WordUnit code = block->BLOCK::GetTuple(pos + i);
+                        if(0 != (pairs[code / kNumWordBits] & (1ULL << (code % kNumWordBits)))){
+                            result[u] |= 1U << i;
+                        }
+                    }
+                }
+            }
+        }
+
+        for(size_t w = 0; w < kNumUnitsPerGroup / 2; w++){
+            WordUnit word = (static_cast<WordUnit>(result[2 * w + 1]) << 32) | result[2 * w];
+            WordUnit input_word = (static_cast<WordUnit>(input[2 * w + 1]) << 32) | input[2 * w];
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    word &= input_word;
+                    break;
+                case Bitwise::kOr:
+                    word |= input_word;
+                    break;
+            }
+            bvblock->SetWordUnit(word, bv_word_id + w);
+        }
+    }
+    bvblock->ClearTail();
+}
+
+/**
+  @brief IN-list entry of ByteSlice and HybridSlice: literals wider than
+  the codes are dropped, an empty list matches nothing.
+  */
+template <typename BLOCK, size_t NUM_BYTE_SLICES, size_t NUM_BIT_SLICES>
+void ScanInSlices(const BLOCK* block, ByteUnit* const byte_slices[],
+        WordUnit* const bit_slices[], size_t num_tuples, size_t bit_width,
+        size_t padding_bits, const std::vector<WordUnit> &literals,
+        const ZoneMap &zone_map, BitVectorBlock* bvblock, Bitwise bit_opt){
+    assert(std::is_sorted(literals.begin(), literals.end()));
+    const WordUnit code_mask = (1ULL << bit_width) - 1;
+    std::vector<WordUnit> codes(literals.begin(),
+            std::upper_bound(literals.begin(), literals.end(), code_mask));
+    if(codes.empty()){
+        ZoneMap::Fill(ZoneMatch::kNone, bit_opt, bvblock, 0, bvblock->num_word_units());
+        bvblock->ClearTail();
+        return;
+    }
+    if(1 == codes.size()){
+        return block->BLOCK::Scan(Comparator::kEqual, codes[0], bvblock, bit_opt);
+    }
+    switch(bit_opt){
+        case Bitwise::kSet:
+            return ScanInSlicesHelper<BLOCK, NUM_BYTE_SLICES, NUM_BIT_SLICES, Bitwise::kSet>(
+                    block, byte_slices, bit_slices, num_tuples, padding_bits,
+                    codes, zone_map, bvblock);
+        case Bitwise::kAnd:
+            return ScanInSlicesHelper<BLOCK, NUM_BYTE_SLICES, NUM_BIT_SLICES, Bitwise::kAnd>(
+                    block, byte_slices, bit_slices, num_tuples, padding_bits,
+                    codes, zone_map, bvblock);
+        case Bitwise::kOr:
+            return ScanInSlicesHelper<BLOCK, NUM_BYTE_SLICES, NUM_BIT_SLICES, Bitwise::kOr>(
+                    block, byte_slices, bit_slices, num_tuples, padding_bits,
+                    codes, zone_map, bvblock);
+    }
+}
+
+}   //namespace
+
+#endif  //IN_LIST_SCAN_H
@@ -0,0 +1,48 @@
+#ifndef	MAPPED_BINARY_FILE_H
+#define	MAPPED_BINARY_FILE_H
+
+#include    <cstdio>
+#include    <string>
+
+namespace byteslice{
+
+/**
+  A read-mostly memory mapping of a whole binary file.
+  Pages are backed by the page cache and are faulted in on first access,
+  so opening a file costs the same regardless of its size.
+  The mapping is private: writes (if any) go to copy-on-write pages
+  and never reach the file.
+*/
+class MappedBinaryFile{
+public:
+    ~MappedBinaryFile();
+    bool Open(const std::string filename);
+    bool Close();
+
+    //accessors
+    const char* data() const;
+    size_t size() const;
+    const std::string& filename() const;
+
+private:
+    char* data_ = NULL;
+    size_t size_ = 0;
+    std::string filename_;
+
+};
+
+inline const char* MappedBinaryFile::data() const{
+    return data_;
+}
+
+inline size_t MappedBinaryFile::size() const{
+    return size_;
+}
+
+inline const std::string& MappedBinaryFile::filename() const{
+    return filename_;
+}
+
+}   //namespace
+
+#endif	//MAPPED_BINARY_FILE_H
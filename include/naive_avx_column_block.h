@@ -28,8 +28,8 @@ public:
             BitVectorBlock* bv_block, Bitwise bit_opt=Bitwise::kSet) const override;
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
 private:
@@ -68,6 +68,7 @@ inline WordUnit NaiveAvxColumnBlock<DTYPE>::GetTuple(size_t pos) const{
 
 template <typename DTYPE>
 inline void NaiveAvxColumnBlock<DTYPE>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     data_[pos] = FLIP<DTYPE>(static_cast<DTYPE>(value));
 }
 
@@ -16,6 +16,7 @@ public:
 
     WordUnit GetTuple(size_t pos_in_block) const override;
     void SetTuple(size_t pos_in_block, WordUnit value) override;
+    void Gather(const TupleId* positions, size_t n, WordUnit* out) const override;
     
     void Scan(Comparator comparator, WordUnit literal, BitVectorBlock* bv_block,
             Bitwise bit_opt=Bitwise::kSet) const override;
@@ -23,8 +24,8 @@ public:
             BitVectorBlock* bv_block, Bitwise bit_opti=Bitwise::kSet) const override;
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos=0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
 private:
@@ -47,8 +48,16 @@ inline WordUnit NaiveColumnBlock<DTYPE>::GetTuple(size_t pos_in_block) const{
     return static_cast<WordUnit>(data_[pos_in_block]);
 }
 
+template <typename DTYPE>
+inline void NaiveColumnBlock<DTYPE>::Gather(const TupleId* positions, size_t n, WordUnit* out) const{
+    for(size_t i = 0; i < n; i++){
+        out[i] = static_cast<WordUnit>(data_[positions[i]]);
+    }
+}
+
 template <typename DTYPE>
 inline void NaiveColumnBlock<DTYPE>::SetTuple(size_t pos_in_block, WordUnit value){
+    zone_map_.Update(pos_in_block, value);
     data_[pos_in_block] = static_cast<DTYPE>(value);
 }
 
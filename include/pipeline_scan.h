@@ -20,24 +20,88 @@ struct AtomPredicate{
     const Comparator comparator;
     const WordUnit literal;
 };
+//Observed behaviour of a predicate in the blocks measured by PipelineScan
+struct PredicateStats{
+    size_t num_blocks = 0;
+    size_t num_tuples = 0;  //tuples of the measured blocks
+    size_t num_input = 0;   //tuples still qualifying before the predicate
+    size_t num_output = 0;  //tuples still qualifying after it
+    uint64_t num_cycles = 0;
+
+    //fraction of the input tuples kept; 1 if nothing measured
+    double selectivity() const;
+    double cycles_per_block() const;
+    //a byte slice scan reads every tuple of a block, qualifying or not
+    double cycles_per_tuple() const;
+};
+
 /**
   * @brief Evaluate complex predicates as
   * "Conjunction of Byte Disjunctions" in a pipeline manner.
+  * When adaptive, ExecuteBlockwise measures selectivity and cycles of every
+  * predicate on one block out of kStatsInterval and reorders the predicates
+  * for the following blocks by ascending cycles_per_tuple / (1 - selectivity):
+  * cheap predicates that drop many tuples go first.
   * @Warning The input columns must be ByteSlice type
   */
 class PipelineScan{
 public:
+    static constexpr size_t kStatsInterval = 8;
+
     void AddPredicate(AtomPredicate predicate);
     void ExecuteBlockwise(BitVector* bitvector);
+    //COUNT(*) of the conjunction: the byte masks of each block are
+    //popcounted instead of condensed into a bit vector
+    size_t CountBlockwise();
     void ExecuteColumnwise(BitVector* bitvector);
     void ExecuteNaive(BitVector* bitvector);
     void ExecuteStandard(BitVector* bitvector);
 
+    void SetAdaptive(bool adaptive);
+    void ResetStats();
+
+    //accessors
+    bool adaptive() const;
+    //ids (in the order added) of the predicates in evaluation order
+    const std::vector<size_t>& order() const;
+    //statistics by predicate id, accumulated across executions
+    const std::vector<PredicateStats>& stats() const;
 
 private:
+    void Reorder();
+    //Evaluate the conjunction on one block into bmblk, predicates in order
+    void ScanBlock(size_t block_id, ByteMaskBlock* bmblk, std::vector<size_t> &order);
+
     std::vector<AtomPredicate> conjunctions_;
+    std::vector<size_t> order_;
+    std::vector<PredicateStats> stats_;
+    bool adaptive_ = false;
 
 };
+
+inline double PredicateStats::selectivity() const{
+    return (0 == num_input)? 1.0 : double(num_output) / num_input;
+}
+
+inline double PredicateStats::cycles_per_block() const{
+    return (0 == num_blocks)? 0.0 : double(num_cycles) / num_blocks;
+}
+
+inline double PredicateStats::cycles_per_tuple() const{
+    return (0 == num_tuples)? 0.0 : double(num_cycles) / num_tuples;
+}
+
+inline bool PipelineScan::adaptive() const{
+    return adaptive_;
+}
+
+inline const std::vector<size_t>& PipelineScan::order() const{
+    return order_;
+}
+
+inline const std::vector<PredicateStats>& PipelineScan::stats() const{
+    return stats_;
+}
     
 
 }   //namespace
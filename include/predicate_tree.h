@@ -0,0 +1,92 @@
+#ifndef PREDICATE_TREE_H
+#define PREDICATE_TREE_H
+
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "column.h"
+#include    "bytewise_scan.h"
+
+namespace byteslice{
+
+enum class PredicateNodeType{
+    kPredicate,
+    kAnd,
+    kOr,
+    kNot
+};
+
+/**
+  * @brief Evaluate an arbitrary AND/OR/NOT tree of atom predicates,
+  * e.g. (a < 5 OR b = 3) AND c >= 10.
+  * Scan evaluates it in one pass over the blocks: every 512 tuples walk the
+  * tree, every node producing its result as 16 AVX units of byte masks.
+  * A tuple stops mattering to the remaining children of an AND once a child
+  * is false for it, and to those of an OR once a child is true for it;
+  * the remaining children are skipped when no tuple matters any more.
+  * An atom predicate scans its most significant byte for all 16 units,
+  * and every next byte only for the units that still have a tuple that
+  * matters equal to the literal so far.
+  * Atom predicates decided by the zone map of a block are not scanned.
+  * @Warning The input columns must be ByteSlice type
+  */
+class PredicateTree{
+public:
+    //Every Add* returns the id of the new node.
+    size_t AddPredicate(BytewiseAtomPredicate predicate);
+    size_t AddAnd(const std::vector<size_t> &children);
+    size_t AddOr(const std::vector<size_t> &children);
+    size_t AddNot(size_t child);
+    //The root is the last node added unless set otherwise.
+    void SetRoot(size_t node_id);
+
+    void Scan(BitVector* bitvector) const;
+
+    //accessors
+    size_t root() const;
+    size_t num_nodes() const;
+    size_t num_predicates() const;
+
+private:
+    struct Node{
+        PredicateNodeType type;
+        size_t predicate_id;
+        std::vector<size_t> children;
+    };
+
+    size_t AddNode(PredicateNodeType type, const std::vector<size_t> &children,
+            size_t predicate_id = 0);
+
+    //Every 512 tuples are evaluated as kNumUnits byte masks, one per 32 tuples.
+    static constexpr size_t kNumUnits = 16;
+    //byte slices of a code of up to 32 bits
+    static constexpr size_t kMaxNumBytes = 4;
+
+    //Lanes outside relevant may be wrong in result.
+    //slices[kMaxNumBytes * p + b] is byte slice b of the current block of predicate p
+    void Evaluate(size_t node_id, size_t offset, const AvxUnit relevant[],
+            const ByteUnit* const slices[], const ZoneMatch matches[], AvxUnit result[]) const;
+    void EvaluatePredicate(size_t predicate_id, size_t offset, const AvxUnit relevant[],
+            const ByteUnit* const slices[], AvxUnit result[]) const;
+
+    std::vector<Node> nodes_;
+    std::vector<BytewiseAtomPredicate> predicates_;
+    //literals aligned to the byte slices, one byte per slice
+    std::vector<std::vector<ByteUnit>> literal_bytes_;
+    size_t root_ = 0;
+};
+
+inline size_t PredicateTree::root() const{
+    return root_;
+}
+
+inline size_t PredicateTree::num_nodes() const{
+    return nodes_.size();
+}
+
+inline size_t PredicateTree::num_predicates() const{
+    return predicates_.size();
+}
+
+}   //namespace
+#endif  //PREDICATE_TREE_H
@@ -0,0 +1,194 @@
+#ifndef RANGE_SCAN_H
+#define RANGE_SCAN_H
+
+#include    <algorithm>
+#include    "common.h"
+#include    "types.h"
+#include    "avx-utility.h"
+#include    "bitvector_block.h"
+#include    "zone_map.h"
+
+namespace byteslice{
+
+template <typename UNIT>
+inline uint32_t avx_movemask(const AvxUnit &a){
+    switch(sizeof(UNIT)){
+        case 1:
+            return static_cast<uint32_t>(_mm256_movemask_epi8(a));
+        case 2:
+            return static_cast<uint32_t>(movemask_epi16(a));
+    }
+}
+
+/**
+  Range predicate lo <= x <= hi over a block stored as slices of UNIT
+  (ByteSlice and its variants: bytes, DualByteSlice: 16-bit units).
+  slices[k] holds unit k of every code, the most significant first, FLIPPED.
+  lo and hi are codes already aligned to the slices (padding applied).
+
+  Both bounds are evaluated in one pass: every slice is loaded once and
+  compared against both literals, keeping two sets of less/greater/equal
+  masks. Later slices are skipped as soon as both equal-masks are empty.
+  NUM_UNITS AvxUnits are evaluated side by side to expose more independent
+  instructions (see the superscalar layouts).
+  Zones decided by the zone map (on the unaligned codes lo_code and hi_code)
+  are filled without being scanned.
+*/
+template <typename UNIT, size_t NUM_SLICES, size_t NUM_UNITS, Bitwise OPT>
+void ScanBetweenSlicesHelper(UNIT* const slices[], size_t num_tuples,
+        WordUnit lo, WordUnit hi, WordUnit lo_code, WordUnit hi_code,
+        const ZoneMap &zone_map, BitVectorBlock* bvblock){
+    constexpr size_t kUnitBits = sizeof(UNIT) * 8;
+    constexpr size_t kNumTuplesPerUnit = sizeof(AvxUnit) / sizeof(UNIT);
+    constexpr size_t kNumTuplesPerGroup = NUM_UNITS * kNumTuplesPerUnit;
+    constexpr WordUnit kUnitMask = (kNumTuplesPerUnit == kNumWordBits)?
+        ~0ULL : (1ULL << kNumTuplesPerUnit) - 1;
+    static_assert(0 == ZoneMap::kNumTuplesPerZone % kNumTuplesPerGroup,
+            "a group of units must not span zones");
+
+    AvxUnit mask_lo[NUM_SLICES];
+    AvxUnit mask_hi[NUM_SLICES];
+    for(size_t k = 0; k < NUM_SLICES; k++){
+        size_t shift = kUnitBits * (NUM_SLICES - 1 - k);
+        mask_lo[k] = avx_set1<UNIT>(FLIP(static_cast<UNIT>(lo >> shift)));
+        mask_hi[k] = avx_set1<UNIT>(FLIP(static_cast<UNIT>(hi >> shift)));
+    }
+
+    //result bits of the current word, stored once the word is complete
+    WordUnit word = 0;
+    WordUnit input_word = 0;
+    size_t offset = 0;
+    for(; offset < num_tuples; offset += kNumTuplesPerGroup){
+        if(0 == offset % ZoneMap::kNumTuplesPerZone){
+            size_t zone_id = offset / ZoneMap::kNumTuplesPerZone;
+            ZoneMatch match = zone_map.MatchBetween(zone_id, lo_code, hi_code);
+            if(ZoneMatch::kSome != match){
+                size_t begin_word = offset / kNumWordBits;
+                size_t end_word = std::min(begin_word + ZoneMap::kNumWordsPerZone,
+                        bvblock->num_word_units());
+                ZoneMap::Fill(match, OPT, bvblock, begin_word, end_word);
+                offset += ZoneMap::kNumTuplesPerZone - kNumTuplesPerGroup;
+                continue;
+            }
+        }
+
+        AvxUnit m_greater[NUM_UNITS], m_equal_lo[NUM_UNITS];
+        AvxUnit m_less[NUM_UNITS], m_equal_hi[NUM_UNITS];
+        WordUnit input[NUM_UNITS];
+        //tuples whose result is not decided by the input bit
+        WordUnit active[NUM_UNITS];
+        WordUnit any_active = 0;
+        for(size_t u = 0; u < NUM_UNITS; u++){
+            size_t pos = offset + u * kNumTuplesPerUnit;
+            m_greater[u] = avx_zero();
+            m_less[u] = avx_zero();
+            m_equal_lo[u] = avx_ones();
+            m_equal_hi[u] = avx_ones();
+            if(Bitwise::kSet != OPT){
+                if(0 == pos % kNumWordBits){
+                    input_word = bvblock->GetWordUnit(pos / kNumWordBits);
+                }
+                input[u] = (input_word >> (pos % kNumWordBits)) & kUnitMask;
+                active[u] = (Bitwise::kAnd == OPT)? input[u] : (~input[u] & kUnitMask);
+                any_active |= active[u];
+            }
+        }
+
+        for(size_t k = 0; k < NUM_SLICES; k++){
+            if(0 == k){
+                __builtin_prefetch(slices[0] + offset + 1024);
+            }
+            else{
+                //early stop: no tuple still equal to either bound
+                AvxUnit m_pending = avx_zero();
+                WordUnit pending = 0;
+                for(size_t u = 0; u < NUM_UNITS; u++){
+                    AvxUnit m_equal = avx_or(m_equal_lo[u], m_equal_hi[u]);
+                    if(Bitwise::kSet == OPT){
+                        m_pending = avx_or(m_pending, m_equal);
+                    }
+                    else{
+                        pending |= avx_movemask<UNIT>(m_equal) & active[u];
+                    }
+                }
+                if(Bitwise::kSet == OPT? avx_iszero(m_pending) : 0 == pending){
+                    break;
+                }
+            }
+            if(Bitwise::kSet != OPT && 0 == any_active){
+                break;
+            }
+            for(size_t u = 0; u < NUM_UNITS; u++){
+                AvxUnit slice = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(
+                            slices[k] + offset + u * kNumTuplesPerUnit));
+                m_greater[u] = avx_or(m_greater[u],
+                        avx_and(m_equal_lo[u], avx_cmpgt<UNIT>(slice, mask_lo[k])));
+                m_less[u] = avx_or(m_less[u],
+                        avx_and(m_equal_hi[u], avx_cmplt<UNIT>(slice, mask_hi[k])));
+                m_equal_lo[u] = avx_and(m_equal_lo[u], avx_cmpeq<UNIT>(slice, mask_lo[k]));
+                m_equal_hi[u] = avx_and(m_equal_hi[u], avx_cmpeq<UNIT>(slice, mask_hi[k]));
+            }
+        }
+
+        for(size_t u = 0; u < NUM_UNITS; u++){
+            WordUnit result = avx_movemask<UNIT>(avx_and(
+                        avx_or(m_greater[u], m_equal_lo[u]),
+                        avx_or(m_less[u], m_equal_hi[u])));
+            switch(OPT){
+                case Bitwise::kSet:
+                    break;
+                case Bitwise::kAnd:
+                    result &= input[u];
+                    break;
+                case Bitwise::kOr:
+                    result |= input[u];
+                    break;
+            }
+            size_t pos = offset + u * kNumTuplesPerUnit;
+            word |= result << (pos % kNumWordBits);
+            if(0 == (pos + kNumTuplesPerUnit) % kNumWordBits){
+                bvblock->SetWordUnit(word, pos / kNumWordBits);
+                word = 0;
+            }
+        }
+    }
+    //last word, if incomplete
+    if(0 != offset % kNumWordBits){
+        bvblock->SetWordUnit(word, offset / kNumWordBits);
+    }
+    bvblock->ClearTail();
+}
+
+/**
+  @brief Range scan entry of the sliced layouts: bounds are clipped to the
+  code domain, then aligned to the slices by padding_bits.
+  */
+template <typename UNIT, size_t NUM_SLICES, size_t NUM_UNITS>
+void ScanBetweenSlices(UNIT* const slices[], size_t num_tuples, size_t bit_width,
+        size_t padding_bits, WordUnit lo, WordUnit hi, const ZoneMap &zone_map,
+        BitVectorBlock* bvblock, Bitwise bit_opt){
+    const WordUnit code_mask = (1ULL << bit_width) - 1;
+    if(lo > hi || lo > code_mask){
+        ZoneMap::Fill(ZoneMatch::kNone, bit_opt, bvblock, 0, bvblock->num_word_units());
+        return;
+    }
+    hi = std::min(hi, code_mask);
+    switch(bit_opt){
+        case Bitwise::kSet:
+            return ScanBetweenSlicesHelper<UNIT, NUM_SLICES, NUM_UNITS, Bitwise::kSet>(
+                    slices, num_tuples, lo << padding_bits, hi << padding_bits,
+                    lo, hi, zone_map, bvblock);
+        case Bitwise::kAnd:
+            return ScanBetweenSlicesHelper<UNIT, NUM_SLICES, NUM_UNITS, Bitwise::kAnd>(
+                    slices, num_tuples, lo << padding_bits, hi << padding_bits,
+                    lo, hi, zone_map, bvblock);
+        case Bitwise::kOr:
+            return ScanBetweenSlicesHelper<UNIT, NUM_SLICES, NUM_UNITS, Bitwise::kOr>(
+                    slices, num_tuples, lo << padding_bits, hi << padding_bits,
+                    lo, hi, zone_map, bvblock);
+    }
+}
+
+}   //namespace
+
+#endif  //RANGE_SCAN_H
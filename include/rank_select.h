@@ -0,0 +1,74 @@
+#ifndef RANK_SELECT_H
+#define RANK_SELECT_H
+
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "bitvector.h"
+#include    "bitvector_block.h"
+
+namespace byteslice{
+
+/**
+  * @brief A rank/select directory over the words of a BitVector, for
+  * positional access to the 1's without scanning from the start:
+  * "how many matches before row r" (Rank) and "the k-th match" (Select).
+  * It holds the number of 1's before every block, before every 512-bit
+  * line within its block (32 bits per 512), and the line of every
+  * kSampleRate-th 1 of a block. Select goes to the block, to the lines
+  * between two samples, then within a word with pdep/tzcnt (BMI2).
+  * @Warning The directory is not updated with the bit vector: call Build()
+  * again after changing it.
+  */
+class RankSelect{
+public:
+    RankSelect(const BitVector* bitvector);
+
+    //(Re)count the 1's of the bit vector
+    void Build();
+
+    //The number of 1's in [0, pos); pos <= num()
+    size_t Rank(size_t pos) const;
+    //The position of the k-th 1, counted from 0; num() if k >= CountOnes()
+    size_t Select(size_t k) const;
+    /**
+      @brief Write the positions of the first-th to the (first + n - 1)-th 1's
+      to positions (an offset/limit page of the matches).
+      @return the number of positions written, less than n at the end.
+      */
+    size_t SelectRange(size_t first, size_t n, TupleId* positions) const;
+
+    //accessors
+    size_t num() const;
+    size_t CountOnes() const;
+    //memory taken by the directory
+    size_t GetNumBytes() const;
+
+private:
+    static constexpr size_t kNumWordsPerLine = 8;
+    static constexpr size_t kNumBitsPerLine = kNumWordsPerLine * kNumWordBits;
+    //one select sample every kSampleRate 1's of a block
+    static constexpr size_t kSampleRate = 1024;
+
+    //count the lines and take the samples of a block; return its 1's
+    size_t BuildBlock(size_t block_id);
+
+    const BitVector* bitvector_;
+    //1's before every block, and all of them at the end
+    std::vector<size_t> block_ranks_;
+    //per block: 1's before every line within the block
+    std::vector<std::vector<uint32_t>> line_ranks_;
+    //per block: the line holding the (s * kSampleRate)-th 1 of the block
+    std::vector<std::vector<uint32_t>> samples_;
+};
+
+inline size_t RankSelect::num() const{
+    return bitvector_->num();
+}
+
+inline size_t RankSelect::CountOnes() const{
+    return block_ranks_.back();
+}
+
+}   //namespace
+#endif  //RANK_SELECT_H
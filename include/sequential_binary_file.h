@@ -13,18 +13,30 @@ public:
     size_t Read(void* buf, size_t size) const;
     bool IsEnd();
 
+    //Random positioning, so that independent readers of the same
+    //file can each start at a different offset
+    bool Seek(size_t offset) const;
+    size_t Tell() const;
+    size_t Size() const;
+    const std::string& filename() const;
+
 private:
     FILE* file_ = NULL;
     std::string filename_;
 
 };
 
+inline const std::string& SequentialReadBinaryFile::filename() const{
+    return filename_;
+}
+
 class SequentialWriteBinaryFile{
 public:
     bool Open(const std::string filename);
     bool Close();
     size_t Append(const void* data, size_t size);
     bool Flush();
+    size_t Tell() const;
 
 private:
     FILE* file_ = NULL;
@@ -36,6 +36,9 @@ public:
             Bitwise bit_opt = Bitwise::kSet) const override;
     void Scan(Comparator comparator, const ColumnBlock* other_block,
             BitVectorBlock* bvblock, Bitwise bit_opt = Bitwise::kSet) const override;
+    //lo <= x <= hi in one pass (see ScanBetweenSlices)
+    void ScanBetween(WordUnit lo, WordUnit hi, BitVectorBlock* bvblock,
+            Bitwise bit_opt = Bitwise::kSet) const override;
 
     //Scan procedure that takes in and output 8-bit masks
     void Scan(Comparator comparator, WordUnit literal, ByteMaskBlock* bmblk, 
@@ -43,8 +46,8 @@ public:
 
     void BulkLoadArray(const WordUnit* codes, size_t num, size_t start_pos = 0) override;
 
-    void SerToFile(SequentialWriteBinaryFile &file) const override;
-    void DeserFromFile(const SequentialReadBinaryFile &file) override;
+    bool SerToFile(SequentialWriteBinaryFile &file) const override;
+    bool DeserFromFile(const SequentialReadBinaryFile &file) override;
     bool Resize(size_t size) override;
 
     Direction GetPadDirection();
@@ -127,6 +130,7 @@ inline WordUnit Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTupl
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 inline void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::SetTuple(size_t pos, WordUnit value){
+    zone_map_.Update(pos, value);
     switch(PDIRECTION){
         case Direction::kRight:
             value <<= kNumPaddingBits;
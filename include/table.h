@@ -3,17 +3,74 @@
 
 #include    <string>
 #include    <map>
+#include    <vector>
 #include    "column.h"
 
+namespace byteslice{
+
+/**
+  A set of named columns of equal cardinality.
+  The table owns its columns and deletes them on destruction.
+  On disk, a table is a directory holding a catalog file and
+  one column file (see Column::SerToFile) per column.
+*/
 class Table{
 public:
     struct Option{
-        bool in_memory;
+        //true: copy columns into memory; false: map them (see Column::MapBinaryFile)
+        bool in_memory = true;
+        //create an empty directory if the path does not exist
+        bool create_if_missing = false;
     };
 
-    void Open(Option option);
-    size_t num_tuples() const {return num_tuples_;}
-    bool CreateColumn(std::string name, ColumnType type, size_t bit_width);
+    Table(size_t num=0);
+    ~Table();
+    void Destroy();
+
+    /**
+      @brief Load all columns of a table directory. Any existing content is discarded.
+      */
+    bool Open(std::string path, Option option);
+    /**
+      @brief Write the catalog and all columns to the directory given in Open.
+      Files are written under temporary names and renamed into place once
+      all of them are written.
+      */
+    bool Persist() const;
+    bool Persist(std::string path) const;
+
+    //Column names must be non-empty, without white spaces or '/'.
+    Column* CreateColumn(std::string name, ColumnType type, size_t bit_width,
+            PagePolicy policy = PagePolicy::kDefault);
+    //Take over an existing column; its cardinality must match the table.
+    bool AddColumn(std::string name, Column* column);
+    bool DropColumn(std::string name);
+    Column* GetColumn(std::string name) const;
+    bool HasColumn(std::string name) const;
+    std::vector<std::string> GetColumnNames() const;
+    void Resize(size_t num);
+    /**
+      @brief Fill the named columns from a delimited text file (see Column::LoadCsvFile),
+      the k-th field of each line going to names[k].
+      */
+    size_t LoadCsvFile(std::string filepath, const std::vector<std::string> &names,
+            char delimiter = ',');
+
+    /**
+      @brief Block-aligned iteration over a group of columns.
+      All columns share the same block boundaries, so func is called once per
+      block id with the blocks of every named column, in the given order.
+      Blocks are processed in parallel: func must be safe to call concurrently
+      for different block ids.
+      */
+    template <typename Func>
+    void ForEachBlock(const std::vector<std::string> &names, Func func) const;
+
+    //accessors
+    size_t num_tuples() const;
+    size_t GetNumColumns() const;
+    size_t GetNumBlocks() const;
+    const std::string& path() const;
 
 private:
     size_t num_tuples_;
@@ -22,5 +79,41 @@ private:
 
 };
 
+inline size_t Table::num_tuples() const{
+    return num_tuples_;
+}
+
+inline size_t Table::GetNumColumns() const{
+    return map_.size();
+}
+
+inline size_t Table::GetNumBlocks() const{
+    return CEIL(num_tuples_, kNumTuplesPerBlock);
+}
+
+inline const std::string& Table::path() const{
+    return path_;
+}
+
+template <typename Func>
+void Table::ForEachBlock(const std::vector<std::string> &names, Func func) const{
+    std::vector<Column*> columns;
+    for(const std::string &name : names){
+        Column* column = GetColumn(name);
+        assert(NULL != column);
+        columns.push_back(column);
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < GetNumBlocks(); block_id++){
+        std::vector<ColumnBlock*> blocks(columns.size());
+        for(size_t i = 0; i < columns.size(); i++){
+            blocks[i] = columns[i]->GetBlock(block_id);
+        }
+        func(block_id, blocks);
+    }
+}
+
+}   //namespace
 
 #endif  //TABLE_H
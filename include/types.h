@@ -68,10 +68,18 @@ enum class Direction{
     kRight
 };
 
+//How column storage is backed by memory pages
+enum class PagePolicy{
+    kDefault,               //regular pages
+    kTransparentHugePage,   //2MB-aligned and advised with MADV_HUGEPAGE
+    kHugeTlb                //MAP_HUGETLB, falling back to kTransparentHugePage
+};
+
 
 //for debug use
 std::ostream& operator<< (std::ostream &out, ColumnType type);
 std::ostream& operator<< (std::ostream &out, Comparator comp);
+std::ostream& operator<< (std::ostream &out, PagePolicy policy);
 
 }   //namespace
 
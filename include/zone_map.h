@@ -0,0 +1,151 @@
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include    <algorithm>
+#include    <vector>
+#include    "common.h"
+#include    "types.h"
+#include    "bitvector_block.h"
+#include    "sequential_binary_file.h"
+
+namespace byteslice{
+
+//What a min/max summary tells about a predicate
+enum class ZoneMatch{
+    kNone,      //no tuple can match
+    kSome,      //must be scanned
+    kAll        //every tuple matches
+};
+
+/**
+  Min/max summaries of a column block, for the whole block and for every
+  zone of kNumTuplesPerZone consecutive tuples.
+  Summaries cover the values written through Update, and the value that
+  tuples hold before they are written, which a block folds in with Widen
+  when it is created and with Update when it grows; zones past its size
+  are dropped with Truncate when it shrinks. A zone with no value yet is
+  unknown and always has to be scanned.
+  Updates of single tuples can only widen a zone; a batch update that
+  covers a zone entirely makes its summary exact again.
+*/
+class ZoneMap{
+public:
+    static constexpr size_t kNumTuplesPerZone = 4096;
+    static constexpr size_t kNumZones = CEIL(kNumTuplesPerBlock, kNumTuplesPerZone);
+    static constexpr size_t kNumWordsPerZone = kNumTuplesPerZone / kNumWordBits;
+
+    ZoneMap(size_t bit_width);
+    void Clear();
+
+    void Update(size_t pos, WordUnit value);
+    //A zone written up to the end of the block (num_tuples) is exact again
+    void Update(const WordUnit* codes, size_t num, size_t start_pos,
+            size_t num_tuples = kNumTuplesPerBlock);
+    //Every tuple in [begin, end) holds value
+    void Widen(size_t begin, size_t end, WordUnit value);
+    //Forget the zones that start at or past num_tuples
+    void Truncate(size_t num_tuples);
+
+    ZoneMatch Match(Comparator comparator, WordUnit literal) const;
+    ZoneMatch Match(size_t zone_id, Comparator comparator, WordUnit literal) const;
+    //lo <= x <= hi
+    ZoneMatch MatchBetween(WordUnit lo, WordUnit hi) const;
+    ZoneMatch MatchBetween(size_t zone_id, WordUnit lo, WordUnit hi) const;
+    //x IN (literals), literals sorted
+    ZoneMatch MatchIn(const std::vector<WordUnit> &literals) const;
+    ZoneMatch MatchIn(size_t zone_id, const std::vector<WordUnit> &literals) const;
+
+    bool SerToFile(SequentialWriteBinaryFile &file) const;
+    bool DeserFromFile(const SequentialReadBinaryFile &file);
+
+    /**
+      @brief Write the result of a decided match into words [begin, end) of bvblock,
+      combined with the existing words as bit_opt requires.
+      */
+    static void Fill(ZoneMatch match, Bitwise bit_opt, BitVectorBlock* bvblock,
+            size_t begin_word, size_t end_word);
+
+    //accessors
+    uint32_t min() const;
+    uint32_t max() const;
+    uint32_t GetZoneMin(size_t zone_id) const;
+    uint32_t GetZoneMax(size_t zone_id) const;
+    bool IsEmpty() const;
+    bool IsZoneEmpty(size_t zone_id) const;
+
+private:
+    ZoneMatch Match(uint32_t min, uint32_t max, Comparator comparator,
+            WordUnit literal) const;
+    ZoneMatch MatchBetween(uint32_t min, uint32_t max, WordUnit lo, WordUnit hi) const;
+    ZoneMatch MatchIn(uint32_t min, uint32_t max, const std::vector<WordUnit> &literals) const;
+
+    const WordUnit code_mask_;
+    //empty when min > max
+    uint32_t min_;
+    uint32_t max_;
+    uint32_t mins_[kNumZones];
+    uint32_t maxs_[kNumZones];
+};
+
+inline void ZoneMap::Update(size_t pos, WordUnit value){
+    assert(pos < kNumTuplesPerBlock);
+    uint32_t code = static_cast<uint32_t>(value & code_mask_);
+    size_t zone_id = pos / kNumTuplesPerZone;
+    mins_[zone_id] = std::min(mins_[zone_id], code);
+    maxs_[zone_id] = std::max(maxs_[zone_id], code);
+    min_ = std::min(min_, code);
+    max_ = std::max(max_, code);
+}
+
+inline ZoneMatch ZoneMap::Match(Comparator comparator, WordUnit literal) const{
+    return Match(min_, max_, comparator, literal);
+}
+
+inline ZoneMatch ZoneMap::Match(size_t zone_id, Comparator comparator,
+        WordUnit literal) const{
+    return Match(mins_[zone_id], maxs_[zone_id], comparator, literal);
+}
+
+inline ZoneMatch ZoneMap::MatchBetween(WordUnit lo, WordUnit hi) const{
+    return MatchBetween(min_, max_, lo, hi);
+}
+
+inline ZoneMatch ZoneMap::MatchBetween(size_t zone_id, WordUnit lo, WordUnit hi) const{
+    return MatchBetween(mins_[zone_id], maxs_[zone_id], lo, hi);
+}
+
+inline ZoneMatch ZoneMap::MatchIn(const std::vector<WordUnit> &literals) const{
+    return MatchIn(min_, max_, literals);
+}
+
+inline ZoneMatch ZoneMap::MatchIn(size_t zone_id, const std::vector<WordUnit> &literals) const{
+    return MatchIn(mins_[zone_id], maxs_[zone_id], literals);
+}
+
+inline uint32_t ZoneMap::min() const{
+    return min_;
+}
+
+inline uint32_t ZoneMap::max() const{
+    return max_;
+}
+
+inline uint32_t ZoneMap::GetZoneMin(size_t zone_id) const{
+    return mins_[zone_id];
+}
+
+inline uint32_t ZoneMap::GetZoneMax(size_t zone_id) const{
+    return maxs_[zone_id];
+}
+
+inline bool ZoneMap::IsEmpty() const{
+    return min_ > max_;
+}
+
+inline bool ZoneMap::IsZoneEmpty(size_t zone_id) const{
+    return mins_[zone_id] > maxs_[zone_id];
+}
+
+}   //namespace
+
+#endif  //ZONE_MAP_H
@@ -2,6 +2,7 @@
 #include    <cstdlib>
 #include    <cstring>
 #include    <immintrin.h>
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -14,11 +15,8 @@ Avx2ScanColumnBlock<BIT_WIDTH>::Avx2ScanColumnBlock(size_t num):
                 num){
     assert(num <= kNumTuplesPerBlock);
     //allocate memory space
-    //allocate 32 more bytes at the end to make sure we can load the last segment
-    size_t size = CEIL(kNumTuplesPerBlock, kNumTuplePerSegment) * kNumBytesPerSegment + 32;
-    int ret = posix_memalign((void**)&data_, 32, size);
-    ret = ret;
-    memset(data_, 0x0, size);
+    data_ = static_cast<ByteUnit*>(BufferPool::Allocate(kMemSize));
+    memset(data_, 0x0, kMemSize);
 
     //precompute helpers
     for(size_t i=0; i < kNumTuplePerSegment; i++){
@@ -26,6 +24,7 @@ Avx2ScanColumnBlock<BIT_WIDTH>::Avx2ScanColumnBlock(size_t num):
         helpers_[i].shift = (i*BIT_WIDTH) % 8;
     }
 
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH>
@@ -69,23 +68,30 @@ void Avx2ScanColumnBlock<BIT_WIDTH>::SetUpMasks(AvxUnit& shiftv,
 
 template <size_t BIT_WIDTH>
 Avx2ScanColumnBlock<BIT_WIDTH>::~Avx2ScanColumnBlock(){
-    free(data_);
+    BufferPool::Release(data_, kMemSize);
 }
 
 template <size_t BIT_WIDTH>
 bool Avx2ScanColumnBlock<BIT_WIDTH>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH>
-void Avx2ScanColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
-
+bool Avx2ScanColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
+    success = success && kMemSize == file.Append(data_, kMemSize);
+    return success;
 }
 
 template <size_t BIT_WIDTH>
-void Avx2ScanColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
-
+bool Avx2ScanColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
+    success = success && kMemSize == file.Read(data_, kMemSize);
+    return success;
 }
 
 template <size_t BIT_WIDTH>
@@ -370,6 +376,7 @@ void Avx2ScanColumnBlock<BIT_WIDTH>::BulkLoadArray(const WordUnit* codes,
     for(size_t i = 0; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 
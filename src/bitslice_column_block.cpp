@@ -3,6 +3,8 @@
 #include    <cstring>
 #include    <algorithm>
 #include    "include/avx-utility.h"
+#include    "include/bit_transpose.h"
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -17,35 +19,41 @@ BitSliceColumnBlock::BitSliceColumnBlock(size_t num, size_t bit_width):
     assert(num <= kNumTuplesPerBlock);
 
     for(size_t i = 0; i < bit_width_; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerBitSlice);
-        ret = ret;
+        data_[i] = static_cast<WordUnit*>(BufferPool::Allocate(kMemSizePerBitSlice));
         memset(data_[i], 0x0, kMemSizePerBitSlice);
     }
+
+    InitZoneMap();
 }
 
 BitSliceColumnBlock::~BitSliceColumnBlock(){
     for(size_t i = 0; i < bit_width_; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerBitSlice);
     }
 }
 
 bool BitSliceColumnBlock::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
-void BitSliceColumnBlock::SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
+bool BitSliceColumnBlock::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
     for(size_t i = 0; i < bit_width_; i++){
-        file.Append(data_[i], kMemSizePerBitSlice);
+        success = success && kMemSizePerBitSlice == file.Append(data_[i], kMemSizePerBitSlice);
     }
+    return success;
 }
 
-void BitSliceColumnBlock::DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
+bool BitSliceColumnBlock::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
     for(size_t i = 0; i < bit_width_; i++){
-        file.Read(data_[i], kMemSizePerBitSlice);
+        success = success && kMemSizePerBitSlice == file.Read(data_[i], kMemSizePerBitSlice);
     }
+    return success;
 }
 
 //Scan against literal
@@ -325,9 +333,36 @@ inline void BitSliceColumnBlock::ScanKernel(const AvxUnit &data, const AvxUnit &
 void BitSliceColumnBlock::BulkLoadArray(const WordUnit* codes, size_t num,
         size_t start_pos){
     assert(start_pos+num <= num_tuples_);
-    for(size_t i = 0; i < num; i++){
+    size_t i = 0;
+    //head: up to the next word boundary
+    for(; i < num && 0 != (start_pos + i) % kNumWordBits; i++){
+        SetTuple(start_pos+i, codes[i]);
+    }
+    //256 codes at a time: every bit slice gets 4 whole words
+    AvxUnit slices[64];
+    for(; i + kNumAvxBits <= num; i += kNumAvxBits){
+        TransposeBits256(codes + i, slices);
+        size_t word_id = (start_pos + i) / kNumWordBits;
+        for(size_t bit_id = 0; bit_id < bit_width_; bit_id++){
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(data_[bit_id] + word_id),
+                    slices[bit_width_ - 1 - bit_id]);
+        }
+    }
+    //64 codes at a time
+    WordUnit rows[64];
+    for(; i + kNumWordBits <= num; i += kNumWordBits){
+        memcpy(rows, codes + i, sizeof(rows));
+        Transpose64x64(rows);
+        size_t word_id = (start_pos + i) / kNumWordBits;
+        for(size_t bit_id = 0; bit_id < bit_width_; bit_id++){
+            data_[bit_id][word_id] = rows[bit_width_ - 1 - bit_id];
+        }
+    }
+    //tail
+    for(; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 }   //namespace
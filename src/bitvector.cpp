@@ -1,4 +1,5 @@
 #include    "include/bitvector.h"
+#include    "include/bitvector_expression.h"
 #include    <algorithm>
 #include    <omp.h>
 
@@ -53,6 +54,16 @@ void BitVector::Not(){
     }
 }
 
+size_t BitVector::Combine(const BitVectorExpression &expression, bool count_ones){
+    assert(0 == expression.num_operands() || num_ == expression.GetOperand(0)->num());
+    size_t count = 0;
+#   pragma omp parallel for schedule(dynamic) reduction(+: count)
+    for(size_t i=0; i < blocks_.size(); i++){
+        count += expression.EvaluateBlock(i, blocks_[i], count_ones);
+    }
+    return count;
+}
+
 void BitVector::SetOnes(){
 #   pragma omp parallel for schedule(dynamic)
     for(size_t i=0; i < blocks_.size(); i++){
@@ -76,6 +87,22 @@ size_t BitVector::CountOnes() const{
     return count;
 }
 
+void BitVector::ToPositions(std::vector<TupleId>* positions) const{
+    std::vector<size_t> offsets(blocks_.size() + 1, 0);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i < blocks_.size(); i++){
+        offsets[i + 1] = blocks_[i]->CountOnes();
+    }
+    for(size_t i=0; i < blocks_.size(); i++){
+        offsets[i + 1] += offsets[i];
+    }
+    positions->resize(offsets.back());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t i=0; i < blocks_.size(); i++){
+        blocks_[i]->GetPositions(i * kNumTuplesPerBlock, positions->data() + offsets[i]);
+    }
+}
+
 bool BitVector::GetBit(size_t pos){
     size_t block_id = pos / kNumTuplesPerBlock;
     size_t pos_in_block = pos % kNumTuplesPerBlock;
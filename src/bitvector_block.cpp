@@ -2,20 +2,39 @@
 
 #include    <cstdlib>
 #include    <cstring>
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
+static constexpr size_t kAllocSize = sizeof(WordUnit)*CEIL(kNumTuplesPerBlock, kNumWordBits);
+
+//Entry m holds the indices of the set bits of the byte m, in order, one per byte
+struct PositionTable{
+    uint64_t indices[256];
+    PositionTable(){
+        for(size_t mask = 0; mask < 256; mask++){
+            indices[mask] = 0;
+            size_t n = 0;
+            for(size_t bit = 0; bit < 8; bit++){
+                if(mask & (1 << bit)){
+                    indices[mask] |= static_cast<uint64_t>(bit) << (8 * n++);
+                }
+            }
+        }
+    }
+};
+static const PositionTable kPositionTable;
+
 BitVectorBlock::BitVectorBlock(size_t num):
     num_(num), num_word_units_(CEIL(num, kNumAvxBits)*(kNumAvxBits/kNumWordBits)){
     assert(num_ <= kNumTuplesPerBlock);
     //always allocate a full-block's storage
-    size_t count = posix_memalign((void**)&data_, 32, sizeof(WordUnit)*CEIL(kNumTuplesPerBlock, kNumWordBits));
-    count = count;
+    data_ = static_cast<WordUnit*>(BufferPool::Allocate(kAllocSize));
     SetOnes();
 }
 
 BitVectorBlock::~BitVectorBlock(){
-    free(data_);
+    BufferPool::Release(data_, kAllocSize);
 }
 
 bool BitVectorBlock::GetBit(size_t pos){
@@ -48,7 +67,7 @@ void BitVectorBlock::SetZeros(){
     memset(data_, 0x0, sizeof(WordUnit)*num_word_units_);
 }
 
-size_t BitVectorBlock::CountOnes(){
+size_t BitVectorBlock::CountOnes() const{
     size_t count = 0;
     for(size_t i=0; i<num_word_units_; i++){
         //count += _mm_popcnt_u64(data_[i]);
@@ -57,30 +76,74 @@ size_t BitVectorBlock::CountOnes(){
     return count;
 }
 
+//Each byte of the word is expanded to 8 positions by one table lookup and
+//stored at once; only the first popcount of them are kept.
+size_t BitVectorBlock::ExpandWord(WordUnit word, TupleId base, TupleId* positions){
+    size_t n = 0;
+    AvxUnit v_offset = _mm256_set1_epi32(base);
+    for(size_t i = 0; i < kNumWordBits; i += 8){
+        uint32_t byte = (word >> i) & 0xff;
+        AvxUnit v_indices = _mm256_cvtepu8_epi32(
+                _mm_cvtsi64_si128(kPositionTable.indices[byte]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(positions + n),
+                _mm256_add_epi32(v_indices, v_offset));
+        n += __builtin_popcount(byte);
+        v_offset = _mm256_add_epi32(v_offset, _mm256_set1_epi32(8));
+    }
+    return n;
+}
+
+//Stores stop 8 entries short of the end, where positions are written one by one.
+size_t BitVectorBlock::GetPositions(TupleId base, TupleId* positions) const{
+    const size_t count = CountOnes();
+    const size_t num_words = CEIL(num_, kNumWordBits);
+    size_t n = 0;
+    size_t word_id = 0;
+    for(; word_id < num_words; word_id++){
+        WordUnit word = data_[word_id];
+        if(n + POPCNT64(word) + 8 > count){
+            break;
+        }
+        if(0 != word){
+            n += ExpandWord(word, base + word_id * kNumWordBits, positions + n);
+        }
+    }
+    for(; word_id < num_words; word_id++){
+        WordUnit word = data_[word_id];
+        while(0 != word){
+            positions[n++] = base + word_id * kNumWordBits + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+    return n;
+}
+
+//num_word_units_ is a multiple of the AvxUnit: 4 words at a time
 void BitVectorBlock::And(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
-        data_[i] &= block->GetWordUnit(i);
+    for(size_t i=0; i<num_word_units_; i += 4){
+        SetAvxUnit(_mm256_and_si256(GetAvxUnit(i), block->GetAvxUnit(i)), i);
     }
     ClearTail();
 }
 
 void BitVectorBlock::Or(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
-        data_[i] |= block->GetWordUnit(i);
+    for(size_t i=0; i<num_word_units_; i += 4){
+        SetAvxUnit(_mm256_or_si256(GetAvxUnit(i), block->GetAvxUnit(i)), i);
     }
     ClearTail();
 }
 
 void BitVectorBlock::Not(){
-    for(size_t i=0; i<num_word_units_; i++){
-        data_[i] = ~data_[i];
+    const AvxUnit ones = _mm256_set1_epi8(0xff);
+    for(size_t i=0; i<num_word_units_; i += 4){
+        SetAvxUnit(_mm256_xor_si256(GetAvxUnit(i), ones), i);
     }
     ClearTail();
 }
 
 void BitVectorBlock::Set(const BitVectorBlock* block){
-    for(size_t i=0; i<num_word_units_; i++){
-        data_[i] = block->GetWordUnit(i);
+    for(size_t i=0; i<num_word_units_; i += 4){
+        SetAvxUnit(block->GetAvxUnit(i), i);
     }
     ClearTail();
 } 
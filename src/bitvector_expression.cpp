@@ -0,0 +1,169 @@
+#include    "include/bitvector_expression.h"
+#include    "include/avx-utility.h"
+#include    <algorithm>
+
+namespace byteslice{
+
+constexpr size_t BitVectorExpression::kNumUnits;
+
+size_t BitVectorExpression::AddOperand(const BitVector* bitvector){
+    assert(operands_.empty() || operands_[0]->num() == bitvector->num());
+    operands_.push_back(bitvector);
+    return AddNode(BitExpressionNodeType::kOperand, std::vector<size_t>(), operands_.size() - 1);
+}
+
+size_t BitVectorExpression::AddAnd(const std::vector<size_t> &children){
+    return AddNode(BitExpressionNodeType::kAnd, children);
+}
+
+size_t BitVectorExpression::AddOr(const std::vector<size_t> &children){
+    return AddNode(BitExpressionNodeType::kOr, children);
+}
+
+size_t BitVectorExpression::AddNot(size_t child){
+    return AddNode(BitExpressionNodeType::kNot, std::vector<size_t>(1, child));
+}
+
+size_t BitVectorExpression::AddAndNot(size_t left, size_t right){
+    size_t not_right = AddNot(right);
+    return AddAnd({left, not_right});
+}
+
+size_t BitVectorExpression::AddNode(BitExpressionNodeType type, const std::vector<size_t> &children,
+        size_t operand_id){
+    assert(BitExpressionNodeType::kOperand == type || !children.empty());
+    for(size_t child : children){
+        assert(child < nodes_.size());
+        (void) child;
+    }
+    Node node;
+    node.type = type;
+    node.operand_id = operand_id;
+    node.children = children;
+    nodes_.push_back(node);
+    root_ = nodes_.size() - 1;
+    return root_;
+}
+
+void BitVectorExpression::SetRoot(size_t node_id){
+    assert(node_id < nodes_.size());
+    root_ = node_id;
+}
+
+size_t BitVectorExpression::EvaluateBlock(size_t block_id, BitVectorBlock* bvblock,
+        bool count_ones) const{
+    assert(!nodes_.empty());
+    std::vector<const BitVectorBlock*> blocks;
+    for(const BitVector* operand : operands_){
+        blocks.push_back(operand->GetBVBlock(block_id));
+        assert(bvblock->num() == blocks.back()->num());
+    }
+
+    const size_t num_avx_units = bvblock->num_word_units() / 4;
+    //the last 4096 tuples may hold bits past num(), counted after ClearTail()
+    const size_t last_unit_id = (num_avx_units - 1) / kNumUnits * kNumUnits;
+    size_t count = 0;
+    AvxUnit m_result[kNumUnits];
+    for(size_t unit_id = 0; unit_id < num_avx_units; unit_id += kNumUnits){
+        const size_t num_units = std::min(kNumUnits, num_avx_units - unit_id);
+        Evaluate(root_, 4 * unit_id, num_units, blocks, m_result);
+        for(size_t u = 0; u < num_units; u++){
+            bvblock->SetAvxUnit(m_result[u], 4 * (unit_id + u));
+        }
+        if(count_ones && unit_id != last_unit_id){
+            for(size_t u = 0; u < num_units; u++){
+                count += POPCNT64(_mm256_extract_epi64(m_result[u], 0))
+                    + POPCNT64(_mm256_extract_epi64(m_result[u], 1))
+                    + POPCNT64(_mm256_extract_epi64(m_result[u], 2))
+                    + POPCNT64(_mm256_extract_epi64(m_result[u], 3));
+            }
+        }
+    }
+    bvblock->ClearTail();
+    if(count_ones){
+        for(size_t i = 4 * last_unit_id; i < bvblock->num_word_units(); i++){
+            count += POPCNT64(bvblock->GetWordUnit(i));
+        }
+    }
+    return count;
+}
+
+void BitVectorExpression::Evaluate(size_t node_id, size_t offset, size_t num_units,
+        const std::vector<const BitVectorBlock*> &blocks, AvxUnit result[]) const{
+    const Node &node = nodes_[node_id];
+    switch(node.type){
+        case BitExpressionNodeType::kOperand:
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = blocks[node.operand_id]->GetAvxUnit(offset + 4 * u);
+            }
+            return;
+        case BitExpressionNodeType::kNot:
+            Evaluate(node.children[0], offset, num_units, blocks, result);
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = avx_not(result[u]);
+            }
+            return;
+        case BitExpressionNodeType::kAnd:
+        case BitExpressionNodeType::kOr:
+            break;
+    }
+
+    const bool is_and = (BitExpressionNodeType::kAnd == node.type);
+    Evaluate(node.children[0], offset, num_units, blocks, result);
+    AvxUnit m_child[kNumUnits];
+    for(size_t c = 1; c < node.children.size(); c++){
+        //stop once the rest cannot change the result:
+        //all 0's for an AND, all 1's for an OR
+        AvxUnit m_acc = is_and? avx_zero() : avx_ones();
+        for(size_t u = 0; u < num_units; u++){
+            m_acc = is_and? avx_or(m_acc, result[u]) : avx_and(m_acc, result[u]);
+        }
+        if(avx_iszero(is_and? m_acc : avx_not(m_acc))){
+            return;
+        }
+
+        //merge an operand (or NOT operand) as it is loaded
+        const Node &child = nodes_[node.children[c]];
+        const BitVectorBlock* leaf = NULL;
+        bool negated = false;
+        if(BitExpressionNodeType::kOperand == child.type){
+            leaf = blocks[child.operand_id];
+        }
+        else if(BitExpressionNodeType::kNot == child.type
+                && BitExpressionNodeType::kOperand == nodes_[child.children[0]].type){
+            leaf = blocks[nodes_[child.children[0]].operand_id];
+            negated = true;
+        }
+        else{
+            Evaluate(node.children[c], offset, num_units, blocks, m_child);
+        }
+
+        if(NULL == leaf){
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = is_and? avx_and(result[u], m_child[u]) : avx_or(result[u], m_child[u]);
+            }
+        }
+        else if(is_and && !negated){
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = avx_and(result[u], leaf->GetAvxUnit(offset + 4 * u));
+            }
+        }
+        else if(is_and && negated){
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = avx_andnot(leaf->GetAvxUnit(offset + 4 * u), result[u]);
+            }
+        }
+        else if(!negated){
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = avx_or(result[u], leaf->GetAvxUnit(offset + 4 * u));
+            }
+        }
+        else{
+            for(size_t u = 0; u < num_units; u++){
+                result[u] = avx_or(result[u], avx_not(leaf->GetAvxUnit(offset + 4 * u)));
+            }
+        }
+    }
+}
+
+}   //namespace
@@ -11,5 +11,57 @@ BitVectorIterator::BitVectorIterator(const BitVector *bitvector):
 BitVectorIterator::~BitVectorIterator(){
 }
 
+size_t BitVectorIterator::NextBatch(TupleId* out, size_t max){
+    //Next() has already returned false
+    if(cur_block_id_ >= bitvector_->GetNumBlocks()){
+        return 0;
+    }
+    size_t n = 0;
+    //positions left on the stack by Next() or by the previous batch
+    while(stack_top_ > 1 && n < max){
+        stack_top_--;
+        out[n++] = stack_[stack_top_ - 1];
+    }
+    while(n < max){
+        if(cur_word_id_ >= cur_block_->num_word_units()){
+            if(cur_block_id_ + 1 >= bitvector_->GetNumBlocks()){
+                break;
+            }
+            cur_word_id_ = 0;
+            cur_block_id_++;
+            block_offset_ += cur_block_->num();
+            cur_block_ = bitvector_->GetBVBlock(cur_block_id_);
+        }
+        //words come in AVX units, so cur_word_id_ + 4 stays within the block
+        if(0 == cur_word_id_ % (kNumAvxBits / kNumWordBits)
+                && avx_iszero(cur_block_->GetAvxUnit(cur_word_id_))){
+            cur_word_id_ += kNumAvxBits / kNumWordBits;
+            continue;
+        }
+        WordUnit word = cur_block_->GetWordUnit(cur_word_id_);
+        size_t offset = block_offset_ + cur_word_id_ * kNumWordBits;
+        cur_word_id_++;
+        if(n + POPCNT64(word) + 8 <= max){
+            n += BitVectorBlock::ExpandWord(word, offset, out + n);
+            continue;
+        }
+        while(0 != word && n < max){
+            out[n++] = offset + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+        if(0 != word){
+            //keep the rest for later, smallest position on top,
+            //above the slot of the "current" position that Next() pops
+            stack_top_ = 0;
+            for(size_t bit = kNumWordBits - 1; bit < kNumWordBits; bit--){
+                stack_[stack_top_] = offset + bit;
+                stack_top_ += ((word >> bit) & 1ULL);
+            }
+            stack_top_++;
+        }
+    }
+    return n;
+}
+
 
 }   //namespace
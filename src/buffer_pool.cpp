@@ -0,0 +1,326 @@
+#include    "include/buffer_pool.h"
+#include    <cstdlib>
+#include    <cstdint>
+#include    <algorithm>
+#include    <atomic>
+#include    <map>
+#include    <mutex>
+#include    <utility>
+#include    <vector>
+#include    <sys/mman.h>
+
+namespace byteslice{
+
+constexpr size_t BufferPool::kMaxNumCachedPerSize;
+constexpr size_t BufferPool::kMaxNumCachedBytes;
+constexpr size_t BufferPool::kHugePageSize;
+
+/**
+  Free lists of one thread, by buffer size.
+  Buffers left over are freed when the thread exits.
+*/
+struct FreeLists{
+    ~FreeLists(){
+        Clear();
+    }
+
+    void Clear(){
+        for(auto &entry : lists){
+            for(void* ptr : entry.second){
+                free(ptr);
+            }
+        }
+        lists.clear();
+        num_bytes = 0;
+    }
+
+    std::map<size_t, std::vector<void*>> lists;
+    size_t num_bytes = 0;
+};
+
+/**
+  Slab of 2MB-aligned chunks backed by huge pages.
+  A chunk holds as many slots of one size as fit in 2MB, or a single
+  buffer rounded up to a multiple of 2MB. A chunk is unmapped as soon
+  as none of its slots is in use.
+  Chunks are mapped within one range of address space reserved on the
+  first allocation, so that whether a buffer belongs to the slab is
+  known from its address alone.
+*/
+class HugePageSlab{
+public:
+    void* Allocate(size_t size, PagePolicy policy);
+    //false if ptr does not belong to the slab
+    bool Release(void* ptr);
+    size_t GetNumHugePages(PagePolicy backing);
+    //lock-free check, so that regular buffers don't pay for the slab
+    bool Owns(const void* ptr) const{
+        uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+        return addr >= begin_.load(std::memory_order_acquire)
+            && addr < end_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Chunk{
+        char* base;
+        size_t length;
+        size_t slot_size;
+        size_t num_used;
+        PagePolicy policy;  //requested
+        PagePolicy backing; //obtained
+    };
+    typedef std::pair<PagePolicy, size_t> SlotKey;
+
+    //address space reserved for the chunks; only mapped pages take memory
+    static constexpr size_t kReservedSize = 256ULL*1024*1024*1024;
+
+    //reserve the address space once; false if it can't be reserved
+    bool Reserve();
+    //a range of length bytes of the reserved space, NULL if exhausted
+    char* TakeRange(size_t length);
+    static bool MapChunk(char* base, size_t length, PagePolicy policy, PagePolicy &backing);
+    static void UnmapChunk(char* base, size_t length);
+
+    std::mutex mutex_;
+    std::map<uintptr_t, Chunk> chunks_;
+    std::map<SlotKey, std::vector<void*>> free_slots_;
+    //reserved space [begin_, end_), handed out from top_ and
+    //given back as ranges of the same length (chunks are 2MB multiples)
+    std::atomic<uintptr_t> begin_{0};
+    std::atomic<uintptr_t> end_{0};
+    char* top_ = NULL;
+    std::multimap<size_t, char*> free_ranges_;
+    bool reserve_failed_ = false;
+};
+
+bool HugePageSlab::Reserve(){
+    if(0 != end_.load(std::memory_order_relaxed)){
+        return true;
+    }
+    if(reserve_failed_){
+        return false;
+    }
+    //over-reserve and trim to a 2MB boundary
+    const size_t align = BufferPool::kHugePageSize;
+    void* addr = mmap(NULL, kReservedSize + align, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(MAP_FAILED == addr){
+        reserve_failed_ = true;
+        return false;
+    }
+    char* raw = static_cast<char*>(addr);
+    char* base = reinterpret_cast<char*>(CEIL(reinterpret_cast<uintptr_t>(raw), align) * align);
+    if(base > raw){
+        munmap(raw, base - raw);
+    }
+    munmap(base + kReservedSize, raw + align - base);
+    top_ = base;
+    begin_.store(reinterpret_cast<uintptr_t>(base), std::memory_order_release);
+    end_.store(reinterpret_cast<uintptr_t>(base) + kReservedSize, std::memory_order_release);
+    return true;
+}
+
+char* HugePageSlab::TakeRange(size_t length){
+    auto it = free_ranges_.find(length);
+    if(free_ranges_.end() != it){
+        char* base = it->second;
+        free_ranges_.erase(it);
+        return base;
+    }
+    if(reinterpret_cast<uintptr_t>(top_) + length > end_.load(std::memory_order_relaxed)){
+        return NULL;
+    }
+    char* base = top_;
+    top_ += length;
+    return base;
+}
+
+bool HugePageSlab::MapChunk(char* base, size_t length, PagePolicy policy, PagePolicy &backing){
+    void* addr;
+    if(PagePolicy::kHugeTlb == policy){
+        addr = mmap(base, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_FIXED, -1, 0);
+        if(MAP_FAILED != addr){
+            backing = PagePolicy::kHugeTlb;
+            return true;
+        }
+        //no reserved huge pages: fall back to transparent huge pages
+    }
+
+    addr = mmap(base, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if(MAP_FAILED == addr){
+        return false;
+    }
+    //only a hint: regular pages are used if THP is disabled
+    madvise(base, length, MADV_HUGEPAGE);
+    backing = PagePolicy::kTransparentHugePage;
+    return true;
+}
+
+void HugePageSlab::UnmapChunk(char* base, size_t length){
+    //give the pages back but keep the range reserved
+    mmap(base, length, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+}
+
+void* HugePageSlab::Allocate(size_t size, PagePolicy policy){
+    const size_t align = BufferPool::kHugePageSize;
+    const size_t slot_size = (size <= align)? 
+        CEIL(size, sizeof(AvxUnit)) * sizeof(AvxUnit) : CEIL(size, align) * align;
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    std::vector<void*> &slots = free_slots_[SlotKey(policy, slot_size)];
+    if(slots.empty()){
+        Chunk chunk;
+        chunk.length = std::max(slot_size, align);
+        chunk.slot_size = slot_size;
+        chunk.num_used = 0;
+        chunk.policy = policy;
+        chunk.base = Reserve()? TakeRange(chunk.length) : NULL;
+        if(NULL == chunk.base){
+            return NULL;
+        }
+        if(!MapChunk(chunk.base, chunk.length, policy, chunk.backing)){
+            free_ranges_.insert(std::make_pair(chunk.length, chunk.base));
+            return NULL;
+        }
+        for(size_t offset = 0; offset + slot_size <= chunk.length; offset += slot_size){
+            slots.push_back(chunk.base + chunk.length - offset - slot_size);
+        }
+        chunks_[reinterpret_cast<uintptr_t>(chunk.base)] = chunk;
+    }
+    void* ptr = slots.back();
+    slots.pop_back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t(align) - 1);
+    chunks_[base].num_used++;
+    return ptr;
+}
+
+bool HugePageSlab::Release(void* ptr){
+    const size_t align = BufferPool::kHugePageSize;
+    uintptr_t base = reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t(align) - 1);
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = chunks_.find(base);
+    if(chunks_.end() == it){
+        return false;
+    }
+    Chunk &chunk = it->second;
+    std::vector<void*> &slots = free_slots_[SlotKey(chunk.policy, chunk.slot_size)];
+    if(0 < --chunk.num_used){
+        slots.push_back(ptr);
+        return true;
+    }
+
+    //the chunk is unused: drop its other slots and unmap it
+    char* begin = chunk.base;
+    char* end = chunk.base + chunk.length;
+    slots.erase(std::remove_if(slots.begin(), slots.end(),
+                [begin, end](void* slot){
+                    return static_cast<char*>(slot) >= begin && static_cast<char*>(slot) < end;
+                }),
+            slots.end());
+    UnmapChunk(chunk.base, chunk.length);
+    free_ranges_.insert(std::make_pair(chunk.length, chunk.base));
+    chunks_.erase(it);
+    return true;
+}
+
+size_t HugePageSlab::GetNumHugePages(PagePolicy backing){
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t count = 0;
+    for(const auto &entry : chunks_){
+        if(backing == entry.second.backing){
+            count += entry.second.length / BufferPool::kHugePageSize;
+        }
+    }
+    return count;
+}
+
+static thread_local FreeLists free_lists;
+static HugePageSlab huge_page_slab;
+static PagePolicy process_policy = PagePolicy::kDefault;
+//-1: no scope, use process_policy
+static thread_local int thread_policy = -1;
+
+void* BufferPool::Allocate(size_t size){
+    PagePolicy policy = GetPagePolicy();
+    if(PagePolicy::kDefault != policy){
+        void* ptr = huge_page_slab.Allocate(size, policy);
+        if(NULL != ptr){
+            return ptr;
+        }
+    }
+
+    std::vector<void*> &list = free_lists.lists[size];
+    if(!list.empty()){
+        void* ptr = list.back();
+        list.pop_back();
+        free_lists.num_bytes -= size;
+        return ptr;
+    }
+
+    void* ptr = NULL;
+    int ret = posix_memalign(&ptr, 32, size);
+    ret = ret;
+    return ptr;
+}
+
+void BufferPool::Release(void* ptr, size_t size){
+    if(NULL == ptr){
+        return;
+    }
+    if(huge_page_slab.Owns(ptr)){
+        huge_page_slab.Release(ptr);
+        return;
+    }
+    std::vector<void*> &list = free_lists.lists[size];
+    if(list.size() < kMaxNumCachedPerSize
+            && free_lists.num_bytes + size <= kMaxNumCachedBytes){
+        list.push_back(ptr);
+        free_lists.num_bytes += size;
+    }
+    else{
+        free(ptr);
+    }
+}
+
+void BufferPool::Clear(){
+    free_lists.Clear();
+}
+
+size_t BufferPool::GetNumCached(){
+    size_t count = 0;
+    for(const auto &entry : free_lists.lists){
+        count += entry.second.size();
+    }
+    return count;
+}
+
+size_t BufferPool::GetNumCachedBytes(){
+    return free_lists.num_bytes;
+}
+
+void BufferPool::SetPagePolicy(PagePolicy policy){
+    process_policy = policy;
+}
+
+PagePolicy BufferPool::GetPagePolicy(){
+    return (thread_policy < 0)? process_policy : static_cast<PagePolicy>(thread_policy);
+}
+
+size_t BufferPool::GetNumHugePages(PagePolicy backing){
+    return huge_page_slab.GetNumHugePages(backing);
+}
+
+BufferPool::PolicyScope::PolicyScope(PagePolicy policy):
+    saved_(thread_policy){
+    thread_policy = static_cast<int>(policy);
+}
+
+BufferPool::PolicyScope::~PolicyScope(){
+    thread_policy = saved_;
+}
+
+}   //namespace
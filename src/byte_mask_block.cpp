@@ -1,6 +1,7 @@
 #include    "include/byte_mask_block.h"
 #include    <cstring>
 #include    <cstdlib>
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -10,14 +11,18 @@ static constexpr size_t kAllocSize
 ByteMaskBlock::ByteMaskBlock(size_t num):
     num_(num){
     assert(num_ <= kNumTuplesPerBlock);
-    int ret 
-        = posix_memalign((void**)&data_, 32, kAllocSize);
-    ret = ret;
+    data_ = static_cast<ByteUnit*>(BufferPool::Allocate(kAllocSize));
     SetAllTrue();
 }
 
 ByteMaskBlock::~ByteMaskBlock(){
-    free(data_);
+    BufferPool::Release(data_, kAllocSize);
+}
+
+void ByteMaskBlock::Resize(size_t num){
+    assert(num <= kNumTuplesPerBlock);
+    num_ = num;
+    ClearTail();
 }
 
 void ByteMaskBlock::SetAllTrue(){
@@ -33,22 +38,23 @@ void ByteMaskBlock::ClearTail(){
     memset(data_+num_, 0ULL, (kNumTuplesPerBlock-num_)*sizeof(ByteUnit));
 }
 
+//32 masks at a time: the storage is a whole number of AvxUnits, and masks
+//beyond num are garbage anyway (see CountTrue)
 void ByteMaskBlock::And(const ByteMaskBlock* block){
-    //may be improved by operating on more tuples at a time?
-    for(size_t i = 0; i < num_; i++){
-        data_[i] &= block->GetByte(i);
+    for(size_t i = 0; i < num_; i += sizeof(AvxUnit)){
+        SetAvxUnit(i, _mm256_and_si256(GetAvxUnit(i), block->GetAvxUnit(i)));
     }
 }
 
 void ByteMaskBlock::Or(const ByteMaskBlock* block){
-    for(size_t i = 0; i < num_; i++){
-        data_[i] |= block->GetByte(i);
+    for(size_t i = 0; i < num_; i += sizeof(AvxUnit)){
+        SetAvxUnit(i, _mm256_or_si256(GetAvxUnit(i), block->GetAvxUnit(i)));
     }
 }
 
 void ByteMaskBlock::Set(const ByteMaskBlock* block){
-    for(size_t i = 0; i < num_; i++){
-        data_[i] = block->GetByte(i);
+    for(size_t i = 0; i < num_; i += sizeof(AvxUnit)){
+        SetAvxUnit(i, block->GetAvxUnit(i));
     }
 }
 
@@ -63,6 +69,46 @@ void ByteMaskBlock::Condense(BitVectorBlock* bvblk, Bitwise opt) const{
     }
 }
 
+void ByteMaskBlock::Condense(const std::vector<const ByteMaskBlock*> &blocks, Bitwise combine,
+        BitVectorBlock* bvblk, Bitwise opt){
+    assert(!blocks.empty());
+    assert(Bitwise::kAnd == combine || Bitwise::kOr == combine);
+    if(Bitwise::kAnd == combine){
+        switch(opt){
+            case Bitwise::kSet:
+                return CondenseHelper<Bitwise::kAnd, Bitwise::kSet>(blocks, bvblk);
+            case Bitwise::kAnd:
+                return CondenseHelper<Bitwise::kAnd, Bitwise::kAnd>(blocks, bvblk);
+            case Bitwise::kOr:
+                return CondenseHelper<Bitwise::kAnd, Bitwise::kOr>(blocks, bvblk);
+        }
+    }
+    else{
+        switch(opt){
+            case Bitwise::kSet:
+                return CondenseHelper<Bitwise::kOr, Bitwise::kSet>(blocks, bvblk);
+            case Bitwise::kAnd:
+                return CondenseHelper<Bitwise::kOr, Bitwise::kAnd>(blocks, bvblk);
+            case Bitwise::kOr:
+                return CondenseHelper<Bitwise::kOr, Bitwise::kOr>(blocks, bvblk);
+        }
+    }
+}
+
+size_t ByteMaskBlock::CountTrue() const{
+    size_t count = 0;
+    size_t offset = 0;
+    for(; offset + sizeof(AvxUnit) <= num_; offset += sizeof(AvxUnit)){
+        count += __builtin_popcount(_mm256_movemask_epi8(GetAvxUnit(offset)));
+    }
+    //masks beyond num may be set by scans
+    if(offset < num_){
+        uint32_t mmask = _mm256_movemask_epi8(GetAvxUnit(offset));
+        count += __builtin_popcount(mmask & ((1U << (num_ - offset)) - 1));
+    }
+    return count;
+}
+
 template <Bitwise OPT>
 void ByteMaskBlock::CondenseHelper(BitVectorBlock* bvblk) const{
     //For every 64 masks, generates a word to be written to bvblk
@@ -94,4 +140,40 @@ void ByteMaskBlock::CondenseHelper(BitVectorBlock* bvblk) const{
 
 }
 
+template <Bitwise COMBINE, Bitwise OPT>
+void ByteMaskBlock::CondenseHelper(const std::vector<const ByteMaskBlock*> &blocks,
+        BitVectorBlock* bvblk){
+    const size_t num = blocks[0]->num();
+    for(size_t offset = 0; offset < num; offset += kNumWordBits){
+        WordUnit word = 0ULL;
+        for(size_t i = 0; i < kNumWordBits; i += sizeof(AvxUnit)){
+            AvxUnit m_mask = blocks[0]->GetAvxUnit(offset+i);
+            for(size_t b = 1; b < blocks.size(); b++){
+                m_mask = (Bitwise::kAnd == COMBINE)?
+                    _mm256_and_si256(m_mask, blocks[b]->GetAvxUnit(offset+i)) :
+                    _mm256_or_si256(m_mask, blocks[b]->GetAvxUnit(offset+i));
+            }
+            uint32_t mmask = _mm256_movemask_epi8(m_mask);
+            word |= (static_cast<WordUnit>(mmask) << i);
+        }
+
+        //Merge the word into bitvector
+        size_t bv_word_id = offset / kNumWordBits;
+        WordUnit out = word;
+        switch(OPT){
+            case Bitwise::kSet:
+                break;
+            case Bitwise::kAnd:
+                out &= bvblk->GetWordUnit(bv_word_id);
+                break;
+            case Bitwise::kOr:
+                out |= bvblk->GetWordUnit(bv_word_id);
+                break;
+        }
+        bvblk->SetWordUnit(out, bv_word_id);
+    }
+
+    bvblk->ClearTail();
+}
+
 }   //namespace
@@ -88,4 +88,20 @@ void ByteMaskVector::Condense(BitVector* bitvector, Bitwise opt) const{
 	}
 }
 
+void ByteMaskVector::Condense(const std::vector<const ByteMaskVector*> &bmvectors, Bitwise combine,
+        BitVector* bitvector, Bitwise opt){
+	assert(!bmvectors.empty());
+	assert(bmvectors[0]->num() == bitvector->num());
+
+#	pragma omp parallel for schedule(dynamic)
+	for(size_t i=0; i < bitvector->GetNumBlocks(); i++){
+		std::vector<const ByteMaskBlock*> blocks;
+		for(const ByteMaskVector* bmvector : bmvectors){
+			assert(bmvector->num() == bitvector->num());
+			blocks.push_back(bmvector->GetBMBlock(i));
+		}
+		ByteMaskBlock::Condense(blocks, combine, bitvector->GetBVBlock(i), opt);
+	}
+}
+
 }	//namespace
\ No newline at end of file
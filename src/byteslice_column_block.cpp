@@ -1,7 +1,12 @@
 #include    "include/byteslice_column_block.h"
+#include    <algorithm>
 #include    <cstdlib>
 #include    <cstring>
+#include    <limits>
 #include    <include/avx-utility.h>
+#include    "include/buffer_pool.h"
+#include    "include/range_scan.h"
+#include    "include/in_list_scan.h"
 
 namespace byteslice{
     
@@ -11,6 +16,45 @@ namespace byteslice{
 
 static constexpr size_t kPrefetchDistance = 512*2;
 
+/**
+  Transpose 32 codes (at most 32 bits each) into 4 byte planes,
+  planes[k] holding byte k (k=0 being the least significant byte) of
+  every code in order. Codes are shifted left by shift bits and FLIPPED.
+*/
+static inline void TransposeBytes(const WordUnit* codes, int shift, AvxUnit planes[4]){
+    //64-bit codes -> 32-bit codes
+    const __m256i narrow = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    //group the bytes of 4 codes within each 128-bit lane
+    const __m256i group = _mm256_setr_epi8(
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+            0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m256i flip = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m128i count = _mm_cvtsi32_si128(shift);
+
+    AvxUnit v[4];
+    for(size_t k = 0; k < 4; k++){
+        __m256i lo = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + 8*k)), narrow);
+        __m256i hi = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(codes + 8*k + 4)), narrow);
+        v[k] = _mm256_permute2x128_si256(lo, hi, 0x20);
+        v[k] = _mm256_xor_si256(_mm256_sll_epi32(v[k], count), flip);
+        v[k] = _mm256_shuffle_epi8(v[k], group);
+    }
+
+    //each lane of v[k] holds 4 bytes of byte k of codes 8k..8k+3 (lane 0)
+    //and 8k+4..8k+7 (lane 1); gather the same byte of all codes
+    __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    planes[0] = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(t0, t2), order);
+    planes[1] = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(t0, t2), order);
+    planes[2] = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(t1, t3), order);
+    planes[3] = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(t1, t3), order);
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(size_t num):
     ColumnBlock(
@@ -22,42 +66,78 @@ ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(size_t num):
     //allocate memory space
     assert(num <= kNumTuplesPerBlock);
     for(size_t i=0; i < kNumBytesPerCode; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerByteSlice);                    
-        ret = ret;
+        data_[i] = static_cast<ByteUnit*>(BufferPool::Allocate(kMemSizePerByteSlice));
         memset(data_[i], 0x0, kMemSizePerByteSlice);
     }
 
+    InitZoneMap();
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ByteSliceColumnBlock(
+        const MappedBinaryFile* file, size_t offset):
+    ColumnBlock(
+            PDIRECTION==Direction::kLeft ? 
+                ColumnType::kByteSlicePadLeft:ColumnType::kByteSlicePadRight, 
+            BIT_WIDTH, 
+            0),
+    mapped_(true)
+{
+    //payload layout must match SerToFile
+    assert(offset + PayloadSize() <= file->size());
+    char* payload = const_cast<char*>(file->data()) + offset;
+    num_tuples_ = *reinterpret_cast<const size_t*>(payload);
+    //no allocation: byte slices point into the (private) mapping
+    for(size_t i=0; i < kNumBytesPerCode; i++){
+        data_[i] = reinterpret_cast<ByteUnit*>(
+                payload + kPayloadHeaderSize + i*kMemSizePerByteSlice);
+    }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::~ByteSliceColumnBlock(){
+    if(mapped_){
+        return;
+    }
     for(size_t i=0; i < kNumBytesPerCode; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerByteSlice);
     }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 bool ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
+    //pad the header so that byte slices keep their alignment in the file
+    ByteUnit header[kPayloadHeaderSize] = {0};
+    memcpy(header, &num_tuples_, sizeof(num_tuples_));
+    bool success = kPayloadHeaderSize == file.Append(header, kPayloadHeaderSize);
     for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
-        file.Append(data_[byte_id], kMemSizePerByteSlice);
+        success = success
+                && kMemSizePerByteSlice == file.Append(data_[byte_id], kMemSizePerByteSlice);
     }
+    return success;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
+    ByteUnit header[kPayloadHeaderSize];
+    bool success = kPayloadHeaderSize == file.Read(header, kPayloadHeaderSize);
+    memcpy(&num_tuples_, header, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
     for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
-        file.Read(data_[byte_id], kMemSizePerByteSlice);
+        success = success
+                && kMemSizePerByteSlice == file.Read(data_[byte_id], kMemSizePerByteSlice);
     }
+    return success;
 }
 
 //Scan that takes in and output ByteMask
@@ -372,6 +452,26 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator,
     }
 }
 
+//Range scan: both bounds in one pass
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetween(WordUnit lo, WordUnit hi,
+        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+    assert(bvblock->num() == num_tuples_);
+    const size_t padding = (Direction::kRight == PDIRECTION)? kNumPaddingBits : 0;
+    ScanBetweenSlices<ByteUnit, kNumBytesPerCode, 1>(data_, num_tuples_, BIT_WIDTH, padding,
+            lo, hi, zone_map_, bvblock, bit_opt);
+}
+
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanIn(const std::vector<WordUnit> &literals,
+        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+    assert(bvblock->num() == num_tuples_);
+    const size_t padding = (Direction::kRight == PDIRECTION)? kNumPaddingBits : 0;
+    ScanInSlices<ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>, kNumBytesPerCode, 0>(
+            this, data_, nullptr, num_tuples_, BIT_WIDTH, padding,
+            literals, zone_map_, bvblock, bit_opt);
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper1(WordUnit literal,
@@ -393,6 +493,7 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
     //Prepare byte-slices of literal
     AvxUnit mask_literal[kNumBytesPerCode];
     literal &= kCodeMask;
+    const WordUnit code = literal;
     if(Direction::kRight == PDIRECTION){
         literal <<= kNumPaddingBits;
     }
@@ -403,6 +504,19 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
     
     //for every kNumWordBits (64) tuples
     for(size_t offset = 0, bv_word_id = 0; offset < num_tuples_; offset += kNumWordBits, bv_word_id++){
+        //zones decided by their min/max are filled without being scanned
+        if(0 == offset % ZoneMap::kNumTuplesPerZone){
+            size_t zone_id = offset / ZoneMap::kNumTuplesPerZone;
+            ZoneMatch match = zone_map_.Match(zone_id, CMP, code);
+            if(ZoneMatch::kSome != match){
+                size_t end_word = std::min(bv_word_id + ZoneMap::kNumWordsPerZone,
+                        bvblock->num_word_units());
+                ZoneMap::Fill(match, OPT, bvblock, bv_word_id, end_word);
+                offset += ZoneMap::kNumTuplesPerZone - kNumWordBits;
+                bv_word_id += ZoneMap::kNumWordsPerZone - 1;
+                continue;
+            }
+        }
         WordUnit bitvector_word = WordUnit(0);
         //need several iteration of AVX scan
         for(size_t i=0; i < kNumWordBits; i += kNumAvxBits/8){
@@ -526,6 +640,405 @@ void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper2(WordUnit literal,
     bvblock->ClearTail();
 }
 
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::CountWhere(Comparator comparator,
+        WordUnit literal) const{
+    switch(comparator){
+        case Comparator::kLess:
+            return CountHelper<Comparator::kLess>(literal);
+        case Comparator::kGreater:
+            return CountHelper<Comparator::kGreater>(literal);
+        case Comparator::kLessEqual:
+            return CountHelper<Comparator::kLessEqual>(literal);
+        case Comparator::kGreaterEqual:
+            return CountHelper<Comparator::kGreaterEqual>(literal);
+        case Comparator::kEqual:
+            return CountHelper<Comparator::kEqual>(literal);
+        case Comparator::kInequal:
+            return CountHelper<Comparator::kInequal>(literal);
+    }
+    return 0;
+}
+
+//Same kernel as ScanHelper2<CMP, kSet>, but every result mask is
+//popcounted in registers instead of being written to a bit vector
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+template <Comparator CMP>
+size_t ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::CountHelper(WordUnit literal) const{
+    //Prepare byte-slices of literal
+    AvxUnit mask_literal[kNumBytesPerCode];
+    literal &= kCodeMask;
+    const WordUnit code = literal;
+    if(Direction::kRight == PDIRECTION){
+        literal <<= kNumPaddingBits;
+    }
+    for(size_t byte_id=0; byte_id < kNumBytesPerCode; byte_id++){
+         ByteUnit byte = FLIP(static_cast<ByteUnit>(literal >> 8*(kNumBytesPerCode - 1 - byte_id)));
+         mask_literal[byte_id] = avx_set1<ByteUnit>(byte);
+    }
+
+    size_t count = 0;
+    //for every kNumAvxBits/8 (32) tuples
+    for(size_t offset = 0; offset < num_tuples_; offset += kNumAvxBits/8){
+        //zones decided by their min/max are counted without being scanned
+        if(0 == offset % ZoneMap::kNumTuplesPerZone){
+            size_t zone_id = offset / ZoneMap::kNumTuplesPerZone;
+            ZoneMatch match = zone_map_.Match(zone_id, CMP, code);
+            if(ZoneMatch::kSome != match){
+                if(ZoneMatch::kAll == match){
+                    count += std::min(ZoneMap::kNumTuplesPerZone, num_tuples_ - offset);
+                }
+                offset += ZoneMap::kNumTuplesPerZone - kNumAvxBits/8;
+                continue;
+            }
+        }
+        AvxUnit m_less = avx_zero();
+        AvxUnit m_greater = avx_zero();
+        AvxUnit m_equal = avx_ones();
+
+        __builtin_prefetch(data_[0] + offset + kPrefetchDistance);
+        ScanKernel2<CMP, 0>(
+                _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[0]+offset)),
+                mask_literal[0], m_less, m_greater, m_equal);
+        if(kNumBytesPerCode > 1
+#ifndef     NEARLYSTOP
+                && !avx_iszero(m_equal)
+#endif
+          ){
+            __builtin_prefetch(data_[1] + offset + kPrefetchDistance);
+            ScanKernel2<CMP, 1>(
+                    _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[1]+offset)),
+                    mask_literal[1], m_less, m_greater, m_equal);
+            if(kNumBytesPerCode > 2
+#ifndef         NEARLYSTOP
+                    && !avx_iszero(m_equal)
+#endif
+              ){
+                ScanKernel2<CMP, 2>(
+                        _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[2]+offset)),
+                        mask_literal[2], m_less, m_greater, m_equal);
+                if(kNumBytesPerCode > 3
+#ifndef             NEARLYSTOP
+                        && !avx_iszero(m_equal)
+#endif
+                  ){
+                    ScanKernel2<CMP, 3>(
+                            _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[3]+offset)),
+                            mask_literal[3], m_less, m_greater, m_equal);
+                }
+            }
+        }
+
+        AvxUnit m_result;
+        switch(CMP){
+            case Comparator::kLessEqual:
+                m_result = avx_or(m_less, m_equal);
+                break;
+            case Comparator::kLess:
+                m_result = m_less;
+                break;
+            case Comparator::kGreaterEqual:
+                m_result = avx_or(m_greater, m_equal);
+                break;
+            case Comparator::kGreater:
+                m_result = m_greater;
+                break;
+            case Comparator::kEqual:
+                m_result = m_equal;
+                break;
+            case Comparator::kInequal:
+                m_result = avx_not(m_equal);
+                break;
+        }
+        WordUnit mmask = static_cast<uint32_t>(_mm256_movemask_epi8(m_result));
+        //ignore the padding after the last tuple
+        if(num_tuples_ - offset < kNumAvxBits/8){
+            mmask &= (1ULL << (num_tuples_ - offset)) - 1;
+        }
+        count += POPCNT64(mmask);
+    }
+    return count;
+}
+
+//Single pass over the selected tuples.
+//SUM: every byte slice is summed on its own (SAD against zero) and
+//weighted by its shift at the end, which adds up to the sum of the codes.
+//MIN/MAX: the byte slices are interleaved in registers into 8/16/32-bit
+//lanes; the first byte is left flipped, so that signed comparisons of the
+//lanes follow the order of the codes. Unselected lanes hold the identity.
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Aggregate(const BitVectorBlock* filter,
+        AggregateResult* result) const{
+    //bytes per lane of the interleaved codes
+    constexpr size_t kLaneSize = (kNumBytesPerCode > 2)? 4 : kNumBytesPerCode;
+    const AvxUnit flip = avx_set1<ByteUnit>(0x80);
+    AvxUnit min_identity, max_identity;
+    switch(kLaneSize){
+        case 1:
+            min_identity = _mm256_set1_epi8(0x7f);
+            max_identity = _mm256_set1_epi8(static_cast<char>(0x80));
+            break;
+        case 2:
+            min_identity = _mm256_set1_epi16(0x7fff);
+            max_identity = _mm256_set1_epi16(static_cast<short>(0x8000));
+            break;
+        default:
+            min_identity = _mm256_set1_epi32(0x7fffffff);
+            max_identity = _mm256_set1_epi32(static_cast<int>(0x80000000));
+            break;
+    }
+    AvxUnit v_min = min_identity;
+    AvxUnit v_max = max_identity;
+    AvxUnit sums[kNumBytesPerCode];
+    for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+        sums[byte_id] = avx_zero();
+    }
+
+    size_t count = 0;
+    for(size_t offset = 0; offset < num_tuples_; offset += kNumWordBits){
+        WordUnit word = (nullptr == filter)? ~WordUnit(0) : filter->GetWordUnit(offset / kNumWordBits);
+        if(num_tuples_ - offset < kNumWordBits){
+            word &= (1ULL << (num_tuples_ - offset)) - 1;
+        }
+        if(0 == word){
+            continue;
+        }
+        count += POPCNT64(word);
+        for(size_t i = 0; i < kNumWordBits; i += kNumAvxBits/8){
+            AvxUnit m = inverse_movemask_epi8(static_cast<uint32_t>(word >> i));
+            //bytes[0] flipped as stored, the others restored
+            AvxUnit bytes[4] = {avx_zero(), avx_zero(), avx_zero(), avx_zero()};
+            for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+                AvxUnit x = _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[byte_id]+offset+i));
+                AvxUnit restored = avx_xor(x, flip);
+                sums[byte_id] = _mm256_add_epi64(sums[byte_id],
+                        _mm256_sad_epu8(avx_and(restored, m), avx_zero()));
+                bytes[byte_id] = (0 == byte_id)? x : restored;
+            }
+
+            switch(kLaneSize){
+                case 1:
+                    v_min = _mm256_min_epi8(v_min, _mm256_blendv_epi8(min_identity, bytes[0], m));
+                    v_max = _mm256_max_epi8(v_max, _mm256_blendv_epi8(max_identity, bytes[0], m));
+                    break;
+                case 2:
+                    for(size_t j = 0; j < 2; j++){
+                        AvxUnit codes = (0 == j)? _mm256_unpacklo_epi8(bytes[1], bytes[0])
+                                                : _mm256_unpackhi_epi8(bytes[1], bytes[0]);
+                        AvxUnit mask = (0 == j)? _mm256_unpacklo_epi8(m, m)
+                                               : _mm256_unpackhi_epi8(m, m);
+                        v_min = _mm256_min_epi16(v_min, _mm256_blendv_epi8(min_identity, codes, mask));
+                        v_max = _mm256_max_epi16(v_max, _mm256_blendv_epi8(max_identity, codes, mask));
+                    }
+                    break;
+                default:{
+                    for(size_t j = 0; j < 2; j++){
+                        AvxUnit high = (0 == j)? _mm256_unpacklo_epi8(bytes[1], bytes[0])
+                                               : _mm256_unpackhi_epi8(bytes[1], bytes[0]);
+                        AvxUnit low = (0 == j)? _mm256_unpacklo_epi8(bytes[3], bytes[2])
+                                              : _mm256_unpackhi_epi8(bytes[3], bytes[2]);
+                        AvxUnit mask16 = (0 == j)? _mm256_unpacklo_epi8(m, m)
+                                                 : _mm256_unpackhi_epi8(m, m);
+                        for(size_t k = 0; k < 2; k++){
+                            AvxUnit codes = (0 == k)? _mm256_unpacklo_epi16(low, high)
+                                                    : _mm256_unpackhi_epi16(low, high);
+                            AvxUnit mask = (0 == k)? _mm256_unpacklo_epi16(mask16, mask16)
+                                                   : _mm256_unpackhi_epi16(mask16, mask16);
+                            v_min = _mm256_min_epi32(v_min, _mm256_blendv_epi8(min_identity, codes, mask));
+                            v_max = _mm256_max_epi32(v_max, _mm256_blendv_epi8(max_identity, codes, mask));
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    if(0 == count){
+        return;
+    }
+
+    AggregateResult block_result;
+    block_result.count = count;
+    block_result.sum = 0;
+    for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+        WordUnit byte_sum = _mm256_extract_epi64(sums[byte_id], 0) + _mm256_extract_epi64(sums[byte_id], 1)
+                          + _mm256_extract_epi64(sums[byte_id], 2) + _mm256_extract_epi64(sums[byte_id], 3);
+        block_result.sum += byte_sum << 8*(kNumBytesPerCode - 1 - byte_id);
+    }
+    //reduce to the lowest kLaneSize bytes of each 32-bit lane, then restore
+    //the first byte and drop the empty low byte of 3-byte codes
+    alignas(32) int32_t min_lanes[kNumAvxBits/32];
+    alignas(32) int32_t max_lanes[kNumAvxBits/32];
+    switch(kLaneSize){
+        case 1:
+            v_min = _mm256_min_epi8(v_min, _mm256_srli_epi32(v_min, 8));
+            v_min = _mm256_min_epi8(v_min, _mm256_srli_epi32(v_min, 16));
+            v_max = _mm256_max_epi8(v_max, _mm256_srli_epi32(v_max, 8));
+            v_max = _mm256_max_epi8(v_max, _mm256_srli_epi32(v_max, 16));
+            break;
+        case 2:
+            v_min = _mm256_min_epi16(v_min, _mm256_srli_epi32(v_min, 16));
+            v_max = _mm256_max_epi16(v_max, _mm256_srli_epi32(v_max, 16));
+            break;
+        default:
+            break;
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(min_lanes), v_min);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(max_lanes), v_max);
+    const size_t lane_shift = 32 - 8*kLaneSize;
+    int32_t lane_min = std::numeric_limits<int32_t>::max();
+    int32_t lane_max = std::numeric_limits<int32_t>::min();
+    for(size_t j = 0; j < kNumAvxBits/32; j++){
+        //sign-extend the lowest kLaneSize bytes
+        lane_min = std::min(lane_min, static_cast<int32_t>(
+                    static_cast<uint32_t>(min_lanes[j]) << lane_shift) >> lane_shift);
+        lane_max = std::max(lane_max, static_cast<int32_t>(
+                    static_cast<uint32_t>(max_lanes[j]) << lane_shift) >> lane_shift);
+    }
+    const size_t code_shift = 8*(kLaneSize - kNumBytesPerCode);
+    const WordUnit lane_mask = (1ULL << 8*kLaneSize) - 1;
+    const WordUnit first_bit = 1ULL << (8*kLaneSize - 1);
+    block_result.min = ((static_cast<WordUnit>(lane_min) & lane_mask) ^ first_bit) >> code_shift;
+    block_result.max = ((static_cast<WordUnit>(lane_max) & lane_mask) ^ first_bit) >> code_shift;
+    if(Direction::kRight == PDIRECTION){
+        block_result.sum >>= kNumPaddingBits;
+        block_result.min >>= kNumPaddingBits;
+        block_result.max >>= kNumPaddingBits;
+    }
+    result->Merge(block_result);
+}
+
+//The k best codes have the k best first bytes or ties of them, so one pass
+//over the first byte slice keeps the tuples whose first byte is not worse
+//than a threshold. Whenever too many are kept, the threshold is tightened
+//to the k-th best first byte kept. Only the tuples kept are decoded.
+//Zones whose min (max) cannot beat the threshold are not read at all.
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::TopK(size_t k, bool largest,
+        const BitVectorBlock* filter, std::vector<TopKEntry>* result) const{
+    if(0 == k){
+        return;
+    }
+    //Keys of the first bytes: flipped bytes compare in order as signed
+    //bytes, inverted when looking for the largest; smaller keys are better
+    const ByteUnit invert = largest? 0xff : 0x00;
+    auto key = [&](size_t pos){
+        return static_cast<int8_t>(data_[0][pos] ^ invert);
+    };
+    auto code_key = [&](WordUnit code){
+        if(Direction::kRight == PDIRECTION){
+            code <<= kNumPaddingBits;
+        }
+        ByteUnit first = FLIP(static_cast<ByteUnit>(code >> 8*(kNumBytesPerCode - 1)));
+        return static_cast<int8_t>(first ^ invert);
+    };
+
+    size_t max_num_candidates = std::max(2*k, size_t(kMinNumTopKCandidates));
+    std::vector<uint32_t> candidates;
+    std::vector<int8_t> keys;
+    int8_t threshold = std::numeric_limits<int8_t>::max();
+    AvxUnit v_threshold = _mm256_set1_epi8(threshold);
+    const AvxUnit v_invert = avx_set1<ByteUnit>(invert);
+    const size_t num_words = CEIL(num_tuples_, kNumWordBits);
+    const size_t num_zones = CEIL(num_tuples_, ZoneMap::kNumTuplesPerZone);
+    for(size_t zone_id = 0; zone_id < num_zones; zone_id++){
+        if(!zone_map_.IsZoneEmpty(zone_id)){
+            WordUnit best = largest? zone_map_.GetZoneMax(zone_id) : zone_map_.GetZoneMin(zone_id);
+            if(code_key(best) > threshold){
+                continue;
+            }
+        }
+        const size_t end_word = std::min(num_words, (zone_id + 1) * ZoneMap::kNumWordsPerZone);
+        for(size_t word_id = zone_id * ZoneMap::kNumWordsPerZone; word_id < end_word; word_id++){
+            size_t offset = word_id * kNumWordBits;
+            WordUnit word = (nullptr == filter)? ~WordUnit(0) : filter->GetWordUnit(word_id);
+            if(num_tuples_ - offset < kNumWordBits){
+                word &= (1ULL << (num_tuples_ - offset)) - 1;
+            }
+            for(size_t i = 0; i < kNumWordBits && 0 != word; i += kNumAvxBits/8){
+                uint32_t mmask = static_cast<uint32_t>(word >> i);
+                if(0 == mmask){
+                    continue;
+                }
+                AvxUnit v_key = avx_xor(v_invert,
+                        _mm256_lddqu_si256(reinterpret_cast<__m256i*>(data_[0]+offset+i)));
+                uint32_t hits = mmask & ~static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpgt_epi8(v_key, v_threshold)));
+                while(0 != hits){
+                    candidates.push_back(offset + i + __builtin_ctz(hits));
+                    hits &= hits - 1;
+                }
+            }
+            if(candidates.size() > max_num_candidates){
+                keys.resize(candidates.size());
+                for(size_t c = 0; c < candidates.size(); c++){
+                    keys[c] = key(candidates[c]);
+                }
+                std::nth_element(keys.begin(), keys.begin() + (k - 1), keys.end());
+                threshold = keys[k - 1];
+                v_threshold = _mm256_set1_epi8(threshold);
+                candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                            [&](uint32_t pos){ return key(pos) > threshold; }),
+                        candidates.end());
+                //ties on the threshold can keep too many
+                if(candidates.size() > max_num_candidates / 2){
+                    max_num_candidates *= 2;
+                }
+            }
+        }
+    }
+
+    std::vector<TopKEntry> entries;
+    entries.reserve(candidates.size());
+    for(uint32_t pos : candidates){
+        entries.push_back(TopKEntry(ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(pos), pos));
+    }
+    size_t num = std::min(k, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + num, entries.end(),
+            [largest](const TopKEntry &a, const TopKEntry &b){
+                return TopKBetter(a, b, largest);
+            });
+    result->insert(result->end(), entries.begin(), entries.begin() + num);
+}
+
+//Byte i of a slice is read by a gather of the aligned 32-bit word holding it,
+//then shifted down to the bottom of its lane. Slices are 32-byte aligned and
+//their size is a multiple of 32, so the gather never reads outside a slice.
+//Codes are assembled in 32-bit lanes and widened to 64 bits on store.
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Gather(const TupleId* positions, size_t n,
+        WordUnit* out) const{
+    const AvxUnit v_three = _mm256_set1_epi32(3);
+    const AvxUnit v_byte = _mm256_set1_epi32(0xff);
+    //unflip every byte of the code at once
+    constexpr uint32_t kFlips = static_cast<uint32_t>(0x80808080ULL >> 8*(4 - kNumBytesPerCode));
+    const AvxUnit v_flips = _mm256_set1_epi32(kFlips);
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8){
+        AvxUnit v_pos = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions + i));
+        AvxUnit v_index = _mm256_andnot_si256(v_three, v_pos);
+        AvxUnit v_shift = _mm256_slli_epi32(_mm256_and_si256(v_pos, v_three), 3);
+        AvxUnit v_code = _mm256_setzero_si256();
+        for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+            AvxUnit v_word = _mm256_i32gather_epi32(
+                    reinterpret_cast<const int*>(data_[byte_id]), v_index, 1);
+            AvxUnit v_bytes = _mm256_and_si256(_mm256_srlv_epi32(v_word, v_shift), v_byte);
+            v_code = _mm256_or_si256(_mm256_slli_epi32(v_code, 8), v_bytes);
+        }
+        v_code = _mm256_xor_si256(v_code, v_flips);
+        if(Direction::kRight == PDIRECTION){
+            v_code = _mm256_srli_epi32(v_code, kNumPaddingBits);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v_code)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 4),
+                _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v_code, 1)));
+    }
+    for(; i < n; i++){
+        out[i] = ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::GetTuple(positions[i]);
+    }
+}
+
 //Scan against other block
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator,
@@ -798,9 +1311,23 @@ template <size_t BIT_WIDTH, Direction PDIRECTION>
 void ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::BulkLoadArray(const WordUnit* codes,
                                                         size_t num, size_t start_pos){
     assert(start_pos + num <= num_tuples_);
-    for(size_t i = 0; i < num; i++){
+    const int shift = (Direction::kRight == PDIRECTION)? kNumPaddingBits : 0;
+    size_t i = 0;
+    AvxUnit planes[4];
+    for(; i + kNumAvxBits/8 <= num; i += kNumAvxBits/8){
+        TransposeBytes(codes + i, shift, planes);
+        //the most significant byte goes to data_[0]
+        for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
+            _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(data_[byte_id] + start_pos + i),
+                    planes[kNumBytesPerCode - 1 - byte_id]);
+        }
+    }
+    //remaining tuples
+    for(; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 
@@ -839,5 +1366,38 @@ template class ByteSliceColumnBlock<29>;
 template class ByteSliceColumnBlock<30>;
 template class ByteSliceColumnBlock<31>;
 template class ByteSliceColumnBlock<32>;
+//padding: left
+template class ByteSliceColumnBlock<1, Direction::kLeft>;
+template class ByteSliceColumnBlock<2, Direction::kLeft>;
+template class ByteSliceColumnBlock<3, Direction::kLeft>;
+template class ByteSliceColumnBlock<4, Direction::kLeft>;
+template class ByteSliceColumnBlock<5, Direction::kLeft>;
+template class ByteSliceColumnBlock<6, Direction::kLeft>;
+template class ByteSliceColumnBlock<7, Direction::kLeft>;
+template class ByteSliceColumnBlock<8, Direction::kLeft>;
+template class ByteSliceColumnBlock<9, Direction::kLeft>;
+template class ByteSliceColumnBlock<10, Direction::kLeft>;
+template class ByteSliceColumnBlock<11, Direction::kLeft>;
+template class ByteSliceColumnBlock<12, Direction::kLeft>;
+template class ByteSliceColumnBlock<13, Direction::kLeft>;
+template class ByteSliceColumnBlock<14, Direction::kLeft>;
+template class ByteSliceColumnBlock<15, Direction::kLeft>;
+template class ByteSliceColumnBlock<16, Direction::kLeft>;
+template class ByteSliceColumnBlock<17, Direction::kLeft>;
+template class ByteSliceColumnBlock<18, Direction::kLeft>;
+template class ByteSliceColumnBlock<19, Direction::kLeft>;
+template class ByteSliceColumnBlock<20, Direction::kLeft>;
+template class ByteSliceColumnBlock<21, Direction::kLeft>;
+template class ByteSliceColumnBlock<22, Direction::kLeft>;
+template class ByteSliceColumnBlock<23, Direction::kLeft>;
+template class ByteSliceColumnBlock<24, Direction::kLeft>;
+template class ByteSliceColumnBlock<25, Direction::kLeft>;
+template class ByteSliceColumnBlock<26, Direction::kLeft>;
+template class ByteSliceColumnBlock<27, Direction::kLeft>;
+template class ByteSliceColumnBlock<28, Direction::kLeft>;
+template class ByteSliceColumnBlock<29, Direction::kLeft>;
+template class ByteSliceColumnBlock<30, Direction::kLeft>;
+template class ByteSliceColumnBlock<31, Direction::kLeft>;
+template class ByteSliceColumnBlock<32, Direction::kLeft>;
 
 }   //namespace
@@ -6,6 +6,8 @@
 #include	<random>
 #include	<algorithm>
 #include	<bitset>
+#include	<map>
+#include	<limits>
 
 namespace byteslice{
 
@@ -15,8 +17,17 @@ namespace byteslice{
 
 static constexpr size_t kPrefetchDistance = 512*2;
 
+constexpr size_t BytewiseScan::kMaxNumPredicates;
+constexpr size_t BytewiseScan::kMaxNumBytes;
+constexpr size_t BytewiseScan::kNumSampleUnits;
+constexpr size_t BytewiseScan::kNumBlockSampleUnits;
+constexpr size_t BytewiseScan::kMaxPlanStates;
+constexpr double BytewiseScan::kReplanRatio;
+
 void BytewiseScan::AddPredicate(BytewiseAtomPredicate predicate){
 	assert(predicate.column->type() == ColumnType::kByteSlicePadRight);
+	assert(conjunctions_.size() < kMaxNumPredicates);
+	assert(predicate.num_bytes <= kMaxNumBytes);
     conjunctions_.push_back(predicate);
     for(size_t i = 0; i < predicate.num_bytes; i++){
     	sequence_.push_back(ByteInColumn(conjunctions_.size() - 1, i));
@@ -37,17 +48,16 @@ bool BytewiseScan::ValidSequence(Sequence seq) const{
 		return false;
 
 	// counter to record next expected byte to appear in the sequence for each column/predicate
-	size_t* next_bytes = (size_t*)malloc(conjunctions_.size() * sizeof(size_t));
-	for(size_t i = 0; i < conjunctions_.size(); i++){
-		next_bytes[i] = 0;
-	}
+	// kDone once all bytes of the column have appeared
+	const size_t kDone = std::numeric_limits<size_t>::max();
+	std::vector<size_t> next_bytes(conjunctions_.size(), 0);
 
 	// validate the sequence
 	for(size_t i = 0; i < seq.size(); i++){
 		size_t col = seq[i].column_id;
 		size_t byte = seq[i].byte_id;
-		if(next_bytes[col] != -1 && next_bytes[col] == byte){
-			next_bytes[col] = (byte == conjunctions_[col].num_bytes - 1)? -1 : byte + 1;
+		if(next_bytes[col] != kDone && next_bytes[col] == byte){
+			next_bytes[col] = (byte == conjunctions_[col].num_bytes - 1)? kDone : byte + 1;
 		}
 		else
 			return false;
@@ -93,10 +103,7 @@ Sequence BytewiseScan::RandomSequence() const{
 	std::random_shuffle(seq.begin(), seq.end());
 
 	// reset valid byte_id of each ByteInColumn
-	size_t* next_bytes = (size_t*)malloc(conjunctions_.size() * sizeof(size_t));
-	for(size_t i = 0; i < conjunctions_.size(); i++){
-		next_bytes[i] = 0;
-	}
+	std::vector<size_t> next_bytes(conjunctions_.size(), 0);
 	for(size_t i = 0; i < seq.size(); i++){
 		seq[i].byte_id = next_bytes[seq[i].column_id]++;
 	}
@@ -104,136 +111,305 @@ Sequence BytewiseScan::RandomSequence() const{
 	return seq;
 }
 
+Sequence BytewiseScan::OptimizedSequence() const{
+	size_t num_tuples = conjunctions_[0].column->num_tuples();
+	return PlanSequence(SampleDecidingBytes(0, num_tuples, kNumSampleUnits));
+}
+
+void BytewiseScan::OptimizeSequence(){
+	SetSequence(OptimizedSequence());
+}
+
+double BytewiseScan::EstimateNumBytes(const Sequence &seq) const{
+	assert(ValidSequence(seq));
+	size_t num_tuples = conjunctions_[0].column->num_tuples();
+	return ExpectedNumBytes(SampleDecidingBytes(0, num_tuples, kNumSampleUnits), seq);
+}
+
+double BytewiseScan::ExpectedNumBytes(const DecidingBytes &deciding, const Sequence &seq) const{
+	std::vector<size_t> scanned(conjunctions_.size(), 0);
+	double num_bytes = 0;
+	for(size_t i = 0; i < seq.size(); i++){
+		num_bytes += NotStopped(deciding, scanned);
+		scanned[seq[i].column_id]++;
+	}
+	return num_bytes;
+}
+
+void BytewiseScan::SetAdaptive(bool adaptive){
+	adaptive_ = adaptive;
+}
+
+BytewiseScan::DecidingBytes BytewiseScan::SampleDecidingBytes(size_t begin, size_t end,
+		size_t num_units) const{
+	size_t num_cols = conjunctions_.size();
+	size_t num_all_units = std::max<size_t>(1, (end - begin) / 32);
+	num_units = std::min(num_units, num_all_units);
+
+	std::map<std::vector<size_t>, size_t> frequencies;
+	std::vector<size_t> unit_deciding(num_cols);
+	for(size_t u = 0; u < num_units; u++){
+		// evenly spaced AvxUnits
+		size_t unit_begin = begin + (u * num_all_units / num_units) * 32;
+		size_t unit_end = std::min(end, unit_begin + 32);
+		for(size_t col = 0; col < num_cols; col++){
+			const BytewiseAtomPredicate &predicate = conjunctions_[col];
+			size_t num_bits_shift = 8 * predicate.num_bytes - predicate.column->bit_width();
+			WordUnit lit = predicate.literal << num_bits_shift;
+			size_t deciding = 0;
+			for(size_t pos = unit_begin; pos < unit_end; pos++){
+				WordUnit code = predicate.column->GetTuple(pos) << num_bits_shift;
+				// number of leading bytes equal to the literal
+				size_t num_equal = 0;
+				while(num_equal < predicate.num_bytes){
+					size_t shift = 8 * (predicate.num_bytes - 1 - num_equal);
+					if(static_cast<ByteUnit>(code >> shift) != static_cast<ByteUnit>(lit >> shift))
+						break;
+					num_equal++;
+				}
+				deciding = std::max(deciding, num_equal + 1);
+			}
+			unit_deciding[col] = deciding;
+		}
+		frequencies[unit_deciding]++;
+	}
+	return DecidingBytes(frequencies.begin(), frequencies.end());
+}
+
+double BytewiseScan::NotStopped(const DecidingBytes &deciding,
+		const std::vector<size_t> &scanned) const{
+	size_t num_units = 0, num_not_stopped = 0;
+	for(size_t i = 0; i < deciding.size(); i++){
+		num_units += deciding[i].second;
+		for(size_t col = 0; col < scanned.size(); col++){
+			if(deciding[i].first[col] > scanned[col]){
+				num_not_stopped += deciding[i].second;
+				break;
+			}
+		}
+	}
+	return (0 == num_units)? 0 : double(num_not_stopped) / num_units;
+}
+
+Sequence BytewiseScan::PlanSequence(const DecidingBytes &deciding) const{
+	size_t num_cols = conjunctions_.size();
+	// states are the numbers of bytes scanned per column, in mixed radix
+	std::vector<size_t> radix(num_cols);
+	size_t num_states = 1;
+	for(size_t col = 0; col < num_cols && num_states <= kMaxPlanStates; col++){
+		radix[col] = num_states;
+		num_states *= conjunctions_[col].num_bytes + 1;
+	}
+
+	Sequence seq;
+	std::vector<size_t> scanned(num_cols, 0);
+	if(num_states <= kMaxPlanStates){
+		// exhaustive: expected cost of each state to the end, from the last state
+		std::vector<double> cost(num_states, 0);
+		std::vector<size_t> next_col(num_states, 0);
+		for(size_t state = num_states - 1; state-- > 0;){
+			for(size_t col = 0; col < num_cols; col++){
+				scanned[col] = state / radix[col] % (conjunctions_[col].num_bytes + 1);
+			}
+			double best = -1;
+			for(size_t col = 0; col < num_cols; col++){
+				if(scanned[col] < conjunctions_[col].num_bytes &&
+						(best < 0 || cost[state + radix[col]] < best)){
+					best = cost[state + radix[col]];
+					next_col[state] = col;
+				}
+			}
+			cost[state] = NotStopped(deciding, scanned) + best;
+		}
+		for(size_t state = 0; state != num_states - 1; state += radix[next_col[state]]){
+			size_t col = next_col[state];
+			size_t byte = state / radix[col] % (conjunctions_[col].num_bytes + 1);
+			seq.push_back(ByteInColumn(col, byte));
+		}
+	}
+	else{
+		// greedy: the byte after which fewest AvxUnits remain undecided
+		for(size_t i = 0; i < num_bytes_all_; i++){
+			double best = -1;
+			size_t best_col = 0;
+			for(size_t col = 0; col < num_cols; col++){
+				if(scanned[col] == conjunctions_[col].num_bytes)
+					continue;
+				scanned[col]++;
+				double not_stopped = NotStopped(deciding, scanned);
+				scanned[col]--;
+				if(best < 0 || not_stopped < best){
+					best = not_stopped;
+					best_col = col;
+				}
+			}
+			seq.push_back(ByteInColumn(best_col, scanned[best_col]++));
+		}
+	}
+	assert(ValidSequence(seq));
+	return seq;
+}
+
 void BytewiseScan::Scan(BitVector* bitvector){
 	// initialize variables reference to frequently used values
 	size_t num_blocks = conjunctions_[0].column->GetNumBlocks();
 	assert(num_blocks == bitvector->GetNumBlocks());
 	size_t num_cols = conjunctions_.size();
-	size_t* num_bytes = (size_t*)malloc(num_cols * sizeof(size_t));
-	for(size_t i = 0; i < num_cols; i++){
-		num_bytes[i] = conjunctions_[i].num_bytes;
-	}
 
 	// initailize Avx mask for each byte in each column
-	// std::vector<std::vector<AvxUnit>> mask_byte;
-	AvxUnit** mask_byte = (AvxUnit**)malloc(num_cols * sizeof(AvxUnit*));
+	AvxUnit mask_byte[kMaxNumPredicates][kMaxNumBytes];
 	for(size_t col = 0; col < num_cols; col++){
-		// std::vector<AvxUnit> col_mask_byte;
-		mask_byte[col] = (AvxUnit*)malloc(num_bytes[col] * sizeof(AvxUnit));
+		size_t num_bytes = conjunctions_[col].num_bytes;
 		WordUnit lit = conjunctions_[col].literal;
-		size_t num_bits_shift = 8 * num_bytes[col] - conjunctions_[col].column->bit_width();
+		size_t num_bits_shift = 8 * num_bytes - conjunctions_[col].column->bit_width();
 		lit <<= num_bits_shift;
 
-		for(size_t byte = 0; byte < num_bytes[col]; byte++){
-			ByteUnit lit_byte = FLIP(static_cast<ByteUnit>(lit >> 8*(num_bytes[col] - 1 - byte)));
-			// mask_byte[col][byte] = avx_set1(lit_byte);
-			AvxUnit avx_mask = avx_set1(lit_byte);
-	        _mm256_storeu_si256(&mask_byte[col][byte], avx_mask);
-	        // col_mask_byte.push_back(_mm256_set1_epi8(static_cast<int8_t>(lit_byte)));
+		for(size_t byte = 0; byte < num_bytes; byte++){
+			ByteUnit lit_byte = FLIP(static_cast<ByteUnit>(lit >> 8*(num_bytes - 1 - byte)));
+			mask_byte[col][byte] = avx_set1(lit_byte);
 		}
-		// mask_byte.push_back(col_mask_byte);
 	}
 
-
 	// do the scanning job
-#pragma omp parallel for schedule(dynamic)
-    for(size_t block_id = 0; block_id < num_blocks; block_id++){
-    	BitVectorBlock* bvblk = bitvector->GetBVBlock(block_id);
-
-    	for(size_t offset = 0, bv_word_id = 0; offset < bvblk->num(); offset += kNumWordBits, bv_word_id++){
-	        WordUnit bitvector_word = WordUnit(0);
-	        for(size_t i = 0; i < kNumWordBits; i += kNumAvxBits/8){
-	        	// initialize Avx mask for less, greater and equal results
-				AvxUnit* m_less = (AvxUnit*)malloc(num_cols * sizeof(AvxUnit));
-				AvxUnit* m_greater = (AvxUnit*)malloc(num_cols * sizeof(AvxUnit));
-				AvxUnit* m_equal = (AvxUnit*)malloc(num_cols * sizeof(AvxUnit));
-				for(size_t j = 0; j < num_cols; j++){
-					AvxUnit m_zero = avx_zero();
-					AvxUnit m_ones = avx_ones();
-					// m_less[i] = avx_zero();
-					// m_greater[i] = avx_zero();
-					// m_equal[i] = avx_ones();
-					_mm256_storeu_si256(&m_less[j], m_zero);
-					_mm256_storeu_si256(&m_greater[j], m_zero);
-					_mm256_storeu_si256(&m_equal[j], m_ones);
+#pragma omp parallel
+	{
+		// adaptive: the plan of this thread, and its expected number of bytes
+		// per AvxUnit on the sample it was planned from
+		Sequence block_sequence;
+		double planned_num_bytes = -1;
+#pragma omp for schedule(dynamic)
+		for(size_t block_id = 0; block_id < num_blocks; block_id++){
+			BitVectorBlock* bvblk = bitvector->GetBVBlock(block_id);
+			if(adaptive_){
+				size_t begin = block_id * kNumTuplesPerBlock;
+				DecidingBytes deciding =
+						SampleDecidingBytes(begin, begin + bvblk->num(), kNumBlockSampleUnits);
+				// re-plan only when the plan got meaningfully worse on this block:
+				// planning searches up to kMaxPlanStates states
+				if(planned_num_bytes < 0 || ExpectedNumBytes(deciding, block_sequence)
+						> kReplanRatio * planned_num_bytes){
+					block_sequence = PlanSequence(deciding);
+					planned_num_bytes = ExpectedNumBytes(deciding, block_sequence);
 				}
+			}
+			const Sequence &sequence = adaptive_? block_sequence : sequence_;
+			switch(num_cols){
+				case 1:
+					ScanBlock<1>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 2:
+					ScanBlock<2>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 3:
+					ScanBlock<3>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 4:
+					ScanBlock<4>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 5:
+					ScanBlock<5>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 6:
+					ScanBlock<6>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 7:
+					ScanBlock<7>(block_id, sequence, mask_byte, bvblk);
+					break;
+				case 8:
+					ScanBlock<8>(block_id, sequence, mask_byte, bvblk);
+					break;
+				default:
+					ScanBlock<0>(block_id, sequence, mask_byte, bvblk);
+					break;
+			}
+		}
+	}
+}
 
-	        	// scan each byte in the specified sequence
-	        	for(size_t j = 0; j < sequence_.size(); j++){
-	        		AvxUnit input_mask = avx_zero();
-	        		for(size_t k = 0; k < num_cols; k++){
-	        			input_mask = avx_or(input_mask, _mm256_lddqu_si256(&m_equal[k]));
-	        		} 
-
-	        		// std::cout << "Column# " <<  sequence_[j].column_id << ", "
-	        		// 	<< "Byte#" << sequence_[j].byte_id << ": "
-	        		// 	<< std::bitset<32>(_mm256_movemask_epi8(input_mask)) << std::endl;
-	        		
-	        		if(avx_iszero(input_mask))
-	        			break;
-					size_t col = sequence_[j].column_id;
-	        		size_t byte = sequence_[j].byte_id;
-	        		ColumnBlock* col_block = conjunctions_[col].column->GetBlock(block_id);
-	        		col_block->Prefetch(byte, offset + i, kPrefetchDistance);
-
-	        		AvxUnit avx_data = col_block->GetAvxUnit(offset + i, byte);
-	        		AvxUnit avx_lit = _mm256_lddqu_si256(&mask_byte[col][byte]);
-	        		AvxUnit avx_less = _mm256_lddqu_si256(&m_less[col]);
-	        		AvxUnit avx_greater = _mm256_lddqu_si256(&m_greater[col]);
-	        		AvxUnit avx_equal = _mm256_lddqu_si256(&m_equal[col]);
-	        		ScanKernel(conjunctions_[col].comparator,
-	        			avx_data,
-    					avx_lit,
-    					avx_less,
-    					avx_greater,
-    					avx_equal);
-	        		_mm256_storeu_si256(&m_less[col], avx_less);
-	        		_mm256_storeu_si256(&m_greater[col], avx_greater);
-	        		_mm256_storeu_si256(&m_equal[col], avx_equal);
-	        	}
-
-	        	// get columnar result, and combine to get the final result
-	        	uint32_t m_result = -1U;
-	        	for(size_t col = 0; col < num_cols; col++){
-	        		uint32_t m_col_result = 0U;
-	        		uint32_t m_col_less, m_col_greater, m_col_equal;
-	        		switch(conjunctions_[col].comparator){
-	        			case Comparator::kEqual:
-	        				m_col_equal = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_equal[col]));
-	        				m_col_result = m_col_equal;
-	        				break;
-	        			case Comparator::kInequal:
-	        				m_col_equal = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_equal[col]));
-	        				m_col_result = ~m_col_equal;
-	        				break;
-	        			case Comparator::kLess:
-	        				m_col_less = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_less[col]));
-	        				m_col_result = m_col_less;
-	        				break;
-	        			case Comparator::kLessEqual:
-	        				m_col_less = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_less[col]));
-	        				m_col_equal = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_equal[col]));
-	        				m_col_result = m_col_less | m_col_equal;
-	        				break;
-	        			case Comparator::kGreater:
-	        				m_col_greater = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_greater[col]));
-	        				m_col_result = m_col_greater;
-	        				break;
-	        			case Comparator::kGreaterEqual:
-	        				m_col_greater = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_greater[col]));
-	        				m_col_equal = _mm256_movemask_epi8(_mm256_lddqu_si256(&m_equal[col]));
-	        				m_col_result = m_col_greater | m_col_equal;
-	        				break;
-
-	        		}
-	        		m_result &= m_col_result;
-	        	}
-	        	bitvector_word |= (static_cast<WordUnit>(m_result) << i);
-	        }
-	        bvblk->SetWordUnit(bitvector_word, bv_word_id);
-    	}
-    	bvblk->ClearTail();
+template <size_t NUM_PREDICATES>
+void BytewiseScan::ScanBlock(size_t block_id, const Sequence &sequence,
+		const AvxUnit mask_byte[][kMaxNumBytes], BitVectorBlock* bvblk) const{
+	// NUM_PREDICATES is 0 when the number of predicates is only known at run time
+	constexpr size_t kCapacity = (0 == NUM_PREDICATES)? kMaxNumPredicates : NUM_PREDICATES;
+	const size_t num_cols = (0 == NUM_PREDICATES)? conjunctions_.size() : NUM_PREDICATES;
+	assert(num_cols == conjunctions_.size());
+
+	// byte slices of this block and comparators
+	const ByteUnit* slices[kCapacity][kMaxNumBytes];
+	Comparator comparators[kCapacity];
+	for(size_t col = 0; col < num_cols; col++){
+		const ColumnBlock* col_block = conjunctions_[col].column->GetBlock(block_id);
+		for(size_t byte = 0; byte < conjunctions_[col].num_bytes; byte++){
+			slices[col][byte] = col_block->GetByteSlice(byte);
+		}
+		comparators[col] = conjunctions_[col].comparator;
 	}
+
+	// Avx mask for less, greater and equal results
+	AvxUnit m_less[kCapacity];
+	AvxUnit m_greater[kCapacity];
+	AvxUnit m_equal[kCapacity];
+
+	for(size_t offset = 0, bv_word_id = 0; offset < bvblk->num(); offset += kNumWordBits, bv_word_id++){
+		WordUnit bitvector_word = WordUnit(0);
+		for(size_t i = 0; i < kNumWordBits; i += kNumAvxBits/8){
+			for(size_t col = 0; col < num_cols; col++){
+				m_less[col] = avx_zero();
+				m_greater[col] = avx_zero();
+				m_equal[col] = avx_ones();
+			}
+
+			// scan each byte in the specified sequence
+			for(size_t j = 0; j < sequence.size(); j++){
+				AvxUnit input_mask = avx_zero();
+				for(size_t col = 0; col < num_cols; col++){
+					input_mask = avx_or(input_mask, m_equal[col]);
+				}
+				if(avx_iszero(input_mask))
+					break;
+
+				size_t col = sequence[j].column_id;
+				size_t byte = sequence[j].byte_id;
+				const ByteUnit* data = slices[col][byte] + offset + i;
+				__builtin_prefetch(data + kPrefetchDistance);
+				ScanKernel(comparators[col],
+					_mm256_lddqu_si256(reinterpret_cast<const __m256i*>(data)),
+					mask_byte[col][byte],
+					m_less[col],
+					m_greater[col],
+					m_equal[col]);
+			}
+
+			// get columnar result, and combine to get the final result
+			uint32_t m_result = -1U;
+			for(size_t col = 0; col < num_cols; col++){
+				AvxUnit m_col_result = m_equal[col];
+				switch(comparators[col]){
+					case Comparator::kEqual:
+						break;
+					case Comparator::kInequal:
+						m_col_result = avx_not(m_equal[col]);
+						break;
+					case Comparator::kLess:
+						m_col_result = m_less[col];
+						break;
+					case Comparator::kLessEqual:
+						m_col_result = avx_or(m_less[col], m_equal[col]);
+						break;
+					case Comparator::kGreater:
+						m_col_result = m_greater[col];
+						break;
+					case Comparator::kGreaterEqual:
+						m_col_result = avx_or(m_greater[col], m_equal[col]);
+						break;
+				}
+				m_result &= _mm256_movemask_epi8(m_col_result);
+			}
+			bitvector_word |= (static_cast<WordUnit>(m_result) << i);
+		}
+		bvblk->SetWordUnit(bitvector_word, bv_word_id);
+	}
+	bvblk->ClearTail();
 }
 
 void BytewiseScan::ScanColumnwise(BitVector* bitvector){
@@ -290,37 +466,39 @@ void BytewiseScan::ScanColumnwise(BitVector* bitvector){
     	}
     }
 
-    //Calculate condensed result
+    //Calculate condensed result: every conjunction is condensed straight
+    //into the result (kAnd); <= and >= condense (less OR equal) in one pass
     bitvector->SetOnes();
     for(size_t i = 0; i < conjunctions_.size(); i++){
     	Comparator comparator = conjunctions_[i].comparator;
-    	BitVector* col_result = new BitVector(num_tuples);
 
     	switch(comparator){
     		case Comparator::kEqual:
-    			bm_equal[i]->Condense(col_result);
+    			bm_equal[i]->Condense(bitvector, Bitwise::kAnd);
     			break;
-    		case Comparator::kInequal:
+    		case Comparator::kInequal:{
+    			BitVector* col_result = new BitVector(num_tuples);
     			bm_equal[i]->Condense(col_result);
     			col_result->Not();
+    			bitvector->And(col_result);
+    			delete col_result;
     			break;
+    		}
     		case Comparator::kLess:
-    			bm_less[i]->Condense(col_result);
+    			bm_less[i]->Condense(bitvector, Bitwise::kAnd);
     			break;
     		case Comparator::kLessEqual:
-    			bm_less[i]->Condense(col_result);
-    			bm_equal[i]->Condense(col_result, Bitwise::kOr);
+    			ByteMaskVector::Condense({bm_less[i], bm_equal[i]}, Bitwise::kOr,
+    					bitvector, Bitwise::kAnd);
     			break;
     		case Comparator::kGreater:
-    			bm_greater[i]->Condense(col_result);
+    			bm_greater[i]->Condense(bitvector, Bitwise::kAnd);
     			break;
     		case Comparator::kGreaterEqual:
-    			bm_greater[i]->Condense(col_result);
-    			bm_equal[i]->Condense(col_result, Bitwise::kOr);
+    			ByteMaskVector::Condense({bm_greater[i], bm_equal[i]}, Bitwise::kOr,
+    					bitvector, Bitwise::kAnd);
     			break;
     	}
-
-    	bitvector->And(col_result);
     }
 
     //free byte mask vectors
@@ -336,28 +514,23 @@ inline void BytewiseScan::ScanKernel(Comparator comparator,
 		const AvxUnit &byteslice1, const AvxUnit &byteslice2,
         AvxUnit &mask_less, AvxUnit &mask_greater, AvxUnit &mask_equal) const{
 	 switch(comparator){
-
         case Comparator::kEqual:
         case Comparator::kInequal:
-            _mm256_storeu_si256(&mask_equal,
-                avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2)));
+            mask_equal = avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2));
             break;
         case Comparator::kLess:
         case Comparator::kLessEqual:
-            _mm256_storeu_si256(&mask_less, 
-                avx_or(mask_less, avx_and(mask_equal, avx_cmplt<ByteUnit>(byteslice1, byteslice2))));
-            _mm256_storeu_si256(&mask_equal, 
-                avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2)));
+            mask_less = avx_or(mask_less,
+                avx_and(mask_equal, avx_cmplt<ByteUnit>(byteslice1, byteslice2)));
+            mask_equal = avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2));
             break;
         case Comparator::kGreater:
         case Comparator::kGreaterEqual:
-            _mm256_storeu_si256(&mask_greater,
-                avx_or(mask_greater, avx_and(mask_equal, avx_cmpgt<ByteUnit>(byteslice1, byteslice2))));
-            _mm256_storeu_si256(&mask_equal, 
-                avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2)));
+            mask_greater = avx_or(mask_greater,
+                avx_and(mask_equal, avx_cmpgt<ByteUnit>(byteslice1, byteslice2)));
+            mask_equal = avx_and(mask_equal, avx_cmpeq<ByteUnit>(byteslice1, byteslice2));
             break;
     }
-
 }
 
 BytewiseAtomPredicate BytewiseScan::GetPredicate(size_t pid) const{
@@ -372,4 +545,8 @@ size_t BytewiseScan::num_bytes_all() const{
 	return num_bytes_all_;
 }
 
+bool BytewiseScan::adaptive() const{
+	return adaptive_;
+}
+
 }	//namespace
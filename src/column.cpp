@@ -1,14 +1,40 @@
 #include    "column.h"
+#include    "hybrid_bitvector.h"
 #include    <algorithm>
 #include    <iostream>
 #include    <fstream>
+#include    <cstring>
 #include    <omp.h>
 
 
 namespace byteslice{
 
-Column::Column(ColumnType type, size_t bit_width, size_t num):
-    type_(type), bit_width_(bit_width), num_tuples_(num){
+/**
+  On-disk layout of a column file:
+  [header][block 0]...[block n-1][block index][zone maps][index offset]
+  Every block payload starts at a kColumnFileAlignment-aligned offset.
+  The block index holds the file offset of each block, so that
+  blocks can be read independently (and in parallel).
+  The zone map of every block follows the index, in block order.
+*/
+static constexpr uint64_t kColumnFileMagic = 0x4c4f434543494c53ULL;   //"SLICECOL"
+static constexpr uint32_t kColumnFileVersion = 4;
+static constexpr size_t kColumnFileAlignment = 32;
+
+struct ColumnFileHeader{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t type;
+    uint64_t bit_width;
+    uint64_t num_tuples;
+    uint64_t num_blocks;
+    uint32_t page_policy;
+    uint32_t reserved;
+};
+
+Column::Column(ColumnType type, size_t bit_width, size_t num, PagePolicy policy):
+    type_(type), bit_width_(bit_width), num_tuples_(num), page_policy_(policy),
+    mapped_file_(NULL){
 
     for(size_t count=0; count < num; count += kNumTuplesPerBlock){
         ColumnBlock* new_block = CreateNewBlock();
@@ -30,6 +56,11 @@ void Column::Destroy(){
         delete blocks_.back();
         blocks_.pop_back();
     }
+    //mapped blocks are gone, the mapping can be released
+    if(NULL != mapped_file_){
+        delete mapped_file_;
+        mapped_file_ = NULL;
+    }
 }
 
 WordUnit Column::GetTuple(size_t id) const{
@@ -46,16 +77,193 @@ void Column::SetTuple(size_t id, WordUnit value){
 }
 
 size_t Column::LoadTextFile(std::string filepath){
-    std::ifstream infile;
-    infile.open(filepath, std::ifstream::in);
-    if(!infile.good()){
-        std::cerr << "Can't open file: " << filepath << std::endl;
+    return LoadCsvFile(filepath, std::vector<Column*>(1, this));
+}
+
+/**
+  Parse an unsigned integer at p, advancing p past its digits.
+  Eight digits are converted at a time without branches (SWAR).
+*/
+static inline WordUnit ParseUnsigned(const char* &p, const char* end){
+    WordUnit value = 0;
+    while(p + sizeof(uint64_t) <= end){
+        uint64_t chunk;
+        memcpy(&chunk, p, sizeof(chunk));
+        //all 8 bytes in '0'..'9'?
+        if(((chunk & 0xF0F0F0F0F0F0F0F0ULL) | 
+                    (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+                != 0x3333333333333333ULL){
+            break;
+        }
+        chunk -= 0x3030303030303030ULL;
+        chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+        chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+        chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+        value = value * 100000000ULL + chunk;
+        p += sizeof(uint64_t);
+    }
+    while(p < end && static_cast<unsigned char>(*p - '0') < 10){
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    return value;
+}
+
+//A line is a row if it has anything but white spaces
+static inline bool IsRow(const char* begin, const char* end){
+    for(const char* p = begin; p < end; p++){
+        if(' ' != *p && '\t' != *p && '\r' != *p){
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline const char* NextLine(const char* p, const char* end){
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    return (NULL == eol)? end : eol;
+}
+
+static constexpr size_t kTextChunkSize = 16*1024*1024;
+//one line start is kept for every kRowSampleRate rows of a chunk
+static constexpr size_t kRowSampleRate = 1024;
+
+/**
+  Parse the fields of the row at p into codes[k][row], k < num_columns.
+  A field is an unsigned integer, optionally surrounded by spaces/tabs;
+  fields past num_columns are ignored.
+  @return false on a malformed or missing field.
+*/
+static inline bool ParseRow(const char* p, const char* eol, char delimiter,
+        size_t num_columns, std::vector<std::vector<WordUnit>> &codes, size_t row){
+    for(size_t k = 0; k < num_columns; k++){
+        while(p < eol && (' ' == *p || '\t' == *p)){
+            p++;
+        }
+        const char* digits = p;
+        codes[k][row] = ParseUnsigned(p, eol);
+        if(p == digits){
+            return false;
+        }
+        while(p < eol && (' ' == *p || '\t' == *p || '\r' == *p)){
+            p++;
+        }
+        if(p < eol && delimiter != *p){
+            return false;
+        }
+        if(p == eol && k + 1 < num_columns){
+            return false;
+        }
+        p++;
+    }
+    return true;
+}
+
+size_t Column::LoadCsvFile(std::string filepath, const std::vector<Column*> &columns,
+        char delimiter){
+    if(columns.empty()){
+        return 0;
+    }
+    size_t max_rows = columns[0]->num_tuples();
+    for(Column* column : columns){
+        max_rows = std::min(max_rows, column->num_tuples());
+    }
+
+    MappedBinaryFile file;
+    if(!file.Open(filepath)){
+        return 0;
+    }
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    //line-aligned chunks
+    std::vector<const char*> bounds(1, data);
+    while(bounds.back() < end){
+        const char* p = bounds.back() + std::min(kTextChunkSize, size_t(end - bounds.back()));
+        if(p < end){
+            p = NextLine(p, end);
+            p = (p < end)? p + 1 : end;
+        }
+        bounds.push_back(p);
+    }
+    const size_t num_chunks = bounds.size() - 1;
+
+    //pass 1: count the rows of every chunk to locate its first tuple,
+    //sampling the start of every kRowSampleRate-th row
+    std::vector<size_t> num_rows(num_chunks, 0);
+    std::vector<std::vector<const char*>> samples(num_chunks);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t c = 0; c < num_chunks; c++){
+        for(const char* p = bounds[c]; p < bounds[c+1]; ){
+            const char* eol = NextLine(p, bounds[c+1]);
+            if(IsRow(p, eol)){
+                if(0 == num_rows[c] % kRowSampleRate){
+                    samples[c].push_back(p);
+                }
+                num_rows[c]++;
+            }
+            p = eol + 1;
+        }
+    }
+    std::vector<size_t> first_row(num_chunks + 1, 0);
+    for(size_t c = 0; c < num_chunks; c++){
+        first_row[c+1] = first_row[c] + num_rows[c];
+    }
+
+    //pass 2: parse and load block by block, so that every block is
+    //loaded once and by one thread, from a buffer of one block per column
+    const size_t num_loaded = std::min(first_row[num_chunks], max_rows);
+    const size_t num_blocks = (num_loaded + kNumTuplesPerBlock - 1) / kNumTuplesPerBlock;
+    size_t bad_row = num_loaded;
+#pragma omp parallel
+    {
+    std::vector<std::vector<WordUnit>> codes(columns.size(),
+            std::vector<WordUnit>(kNumTuplesPerBlock));
+#pragma omp for schedule(dynamic)
+    for(size_t block_id = 0; block_id < num_blocks; block_id++){
+        const size_t begin = block_id * kNumTuplesPerBlock;
+        const size_t num = std::min(kNumTuplesPerBlock, num_loaded - begin);
+
+        //first chunk ending past row begin, then the sample before it
+        size_t c = std::upper_bound(first_row.begin() + 1, first_row.end(), begin)
+            - (first_row.begin() + 1);
+        size_t skip = begin - first_row[c];
+        const char* p = samples[c][skip / kRowSampleRate];
+        skip %= kRowSampleRate;
+
+        size_t row = 0;
+        while(row < num){
+            const char* eol = NextLine(p, end);
+            if(IsRow(p, eol)){
+                if(skip > 0){
+                    skip--;
+                }
+                else if(ParseRow(p, eol, delimiter, columns.size(), codes, row)){
+                    row++;
+                }
+                else{
+#pragma omp critical
+                    bad_row = std::min(bad_row, begin + row);
+                    break;
+                }
+            }
+            p = eol + 1;
+        }
+        if(row < num){
+            continue;
+        }
+        for(size_t k = 0; k < columns.size(); k++){
+            columns[k]->BulkLoadArray(codes[k].data(), num, begin);
+        }
     }
-    WordUnit val;
-    for(size_t id=0; (id < num_tuples()) && (infile >> val); id++){
-        SetTuple(id, val);
     }
-    infile.close();
+
+    if(bad_row < num_loaded){
+        std::cerr << "Malformed field on row " << bad_row << " of "
+            << filepath << std::endl;
+        return 0;
+    }
+    return num_loaded;
 }
 
 void Column::Resize(size_t num){
@@ -64,7 +272,9 @@ void Column::Resize(size_t num){
     const size_t old_num_blocks = blocks_.size();
     if(new_num_blocks > old_num_blocks){    //need to add blocks
         //fill up the last block
-        blocks_[old_num_blocks-1]->Resize(kNumTuplesPerBlock);
+        if(0 < old_num_blocks){
+            blocks_[old_num_blocks-1]->Resize(kNumTuplesPerBlock);
+        }
         //append new blocks
         for(size_t bid=old_num_blocks; bid < new_num_blocks; bid++){
             ColumnBlock* new_block = CreateNewBlock();
@@ -73,48 +283,292 @@ void Column::Resize(size_t num){
         }
     }
     else if(new_num_blocks < old_num_blocks){   //need to remove blocks
-        for(size_t bid=old_num_blocks-1; bid > new_num_blocks; bid--){
+        while(blocks_.size() > new_num_blocks){
             delete blocks_.back();
             blocks_.pop_back();
         }
     }
     //now the number of block is desired
     //correct the size of the last block
-    size_t num_tuples_last_block = num % kNumTuplesPerBlock;
-    if(0 < num_tuples_last_block){
-        blocks_.back()->Resize(num_tuples_last_block);
+    if(0 < new_num_blocks){
+        blocks_.back()->Resize(num - (new_num_blocks-1)*kNumTuplesPerBlock);
     }
 
     assert(blocks_.size() == new_num_blocks);
 }
 
-void Column::SerToFile(SequentialWriteBinaryFile &file) const{
+/**
+  The header describes a layout CreateNewBlock supports,
+  with one block for every kNumTuplesPerBlock tuples, and a known page policy.
+*/
+static bool ValidHeader(const ColumnFileHeader &header){
+    if(1 > header.bit_width || 32 < header.bit_width
+            || (header.num_tuples + kNumTuplesPerBlock - 1) / kNumTuplesPerBlock
+                != header.num_blocks
+            || static_cast<uint32_t>(PagePolicy::kHugeTlb) < header.page_policy){
+        return false;
+    }
+    switch(static_cast<ColumnType>(header.type)){
+        case ColumnType::kNumpsAvx:
+        case ColumnType::kNaive:
+        case ColumnType::kNaiveAvx:
+        case ColumnType::kBitSlice:
+        case ColumnType::kVbp:
+        case ColumnType::kHbp:
+        case ColumnType::kByteSlicePadRight:
+        case ColumnType::kHybridSlice:
+        case ColumnType::kSmartHybridSlice:
+        case ColumnType::kAvx2Scan:
+        case ColumnType::kDualByteSlicePadRight:
+        case ColumnType::kSuperscalar2ByteSlicePadRight:
+        case ColumnType::kSuperscalar4ByteSlicePadRight:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Column::SerToFile(SequentialWriteBinaryFile &file) const{
+    ColumnFileHeader header;
+    header.magic = kColumnFileMagic;
+    header.version = kColumnFileVersion;
+    header.type = static_cast<uint32_t>(type_);
+    header.bit_width = bit_width_;
+    header.num_tuples = num_tuples_;
+    header.num_blocks = blocks_.size();
+    header.page_policy = static_cast<uint32_t>(page_policy_);
+    header.reserved = 0;
+    if(sizeof(header) != file.Append(&header, sizeof(header))){
+        std::cerr << "Failed to write column header." << std::endl;
+        return false;
+    }
+
+    const char padding[kColumnFileAlignment] = {0};
+    std::vector<uint64_t> block_index(blocks_.size());
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        //pad so that every block starts at an aligned offset
+        size_t pos = file.Tell();
+        size_t num_padding = CEIL(pos, kColumnFileAlignment)*kColumnFileAlignment - pos;
+        block_index[block_id] = pos + num_padding;
+        if(num_padding != file.Append(padding, num_padding)
+                || !blocks_[block_id]->SerToFile(file)){
+            std::cerr << "Failed to write column block " << block_id << "." << std::endl;
+            return false;
+        }
+    }
+
+    uint64_t index_offset = file.Tell();
+    size_t index_size = sizeof(uint64_t)*block_index.size();
+    if(index_size != file.Append(block_index.data(), index_size)){
+        std::cerr << "Failed to write column block index." << std::endl;
+        return false;
+    }
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        if(!blocks_[block_id]->zone_map().SerToFile(file)){
+            std::cerr << "Failed to write column zone maps." << std::endl;
+            return false;
+        }
+    }
+    if(sizeof(index_offset) != file.Append(&index_offset, sizeof(index_offset))){
+        std::cerr << "Failed to write column block index." << std::endl;
+        return false;
+    }
+    return file.Flush();
+}
+
+bool Column::DeserFromFile(const SequentialReadBinaryFile &file){
+    ColumnFileHeader header;
+    if(!file.Seek(0) || sizeof(header) != file.Read(&header, sizeof(header))
+            || kColumnFileMagic != header.magic){
+        std::cerr << "Not a column file: " << file.filename() << std::endl;
+        return false;
+    }
+    if(kColumnFileVersion != header.version){
+        std::cerr << "Unsupported column file version: " << header.version << std::endl;
+        return false;
+    }
+    if(!ValidHeader(header) || header.num_blocks > file.Size() / sizeof(uint64_t)){
+        std::cerr << "Corrupted column header: " << file.filename() << std::endl;
+        return false;
+    }
 
+    //locate the block index through the trailing index offset
+    uint64_t index_offset;
+    std::vector<uint64_t> block_index(header.num_blocks);
+    size_t index_size = sizeof(uint64_t)*block_index.size();
+    bool success = file.Seek(file.Size() - sizeof(index_offset))
+            && sizeof(index_offset) == file.Read(&index_offset, sizeof(index_offset))
+            && sizeof(header) <= index_offset
+            && file.Seek(index_offset)
+            && index_size == file.Read(block_index.data(), index_size);
+    for(size_t block_id = 0; success && block_id < block_index.size(); block_id++){
+        success = sizeof(header) <= block_index[block_id] && block_index[block_id] < index_offset;
+    }
+    if(!success){
+        std::cerr << "Corrupted column block index: " << file.filename() << std::endl;
+        return false;
+    }
+
+    //build the blocks aside: the column is only changed once all of them are read
+    Column staged(static_cast<ColumnType>(header.type), header.bit_width, 0,
+            static_cast<PagePolicy>(header.page_policy));
+    staged.num_tuples_ = header.num_tuples;
+    for(size_t block_id = 0; block_id < header.num_blocks; block_id++){
+        staged.blocks_.push_back(staged.CreateNewBlock());
+        if(!staged.blocks_.back()->zone_map().DeserFromFile(file)){
+            std::cerr << "Corrupted column zone maps: " << file.filename() << std::endl;
+            return false;
+        }
+    }
+
+    //Every thread reads its blocks through its own file handle
+#pragma omp parallel for schedule(dynamic) reduction(&&: success)
+    for(size_t block_id = 0; block_id < staged.blocks_.size(); block_id++){
+        SequentialReadBinaryFile blockfile;
+        ColumnBlock* block = staged.blocks_[block_id];
+        //every block but the last one is full
+        size_t num = std::min(kNumTuplesPerBlock,
+                size_t(header.num_tuples - block_id*kNumTuplesPerBlock));
+        success = success && blockfile.Open(file.filename())
+            && blockfile.Seek(block_index[block_id])
+            && block->DeserFromFile(blockfile) && num == block->num_tuples();
+        blockfile.Close();
+    }
+    if(!success){
+        std::cerr << "Corrupted column blocks: " << file.filename() << std::endl;
+        return false;
+    }
+
+    Swap(staged);
+    return true;
+}
+
+void Column::Swap(Column &other){
+    std::swap(num_tuples_, other.num_tuples_);
+    std::swap(bit_width_, other.bit_width_);
+    std::swap(type_, other.type_);
+    std::swap(page_policy_, other.page_policy_);
+    std::swap(blocks_, other.blocks_);
+    std::swap(mapped_file_, other.mapped_file_);
 }
 
-void Column::DeserFromFile(const SequentialReadBinaryFile &file){
+bool Column::MapBinaryFile(std::string filepath){
+    MappedBinaryFile* file = new MappedBinaryFile();
+    if(!file->Open(filepath)){
+        delete file;
+        return false;
+    }
+
+    ColumnFileHeader header;
+    if(sizeof(header) + sizeof(uint64_t) > file->size()){
+        std::cerr << "Not a column file: " << filepath << std::endl;
+        delete file;
+        return false;
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    if(kColumnFileMagic != header.magic){
+        std::cerr << "Not a column file: " << filepath << std::endl;
+        delete file;
+        return false;
+    }
+    if(kColumnFileVersion != header.version){
+        std::cerr << "Unsupported column file version: " << header.version << std::endl;
+        delete file;
+        return false;
+    }
 
+    if(!ValidHeader(header)){
+        std::cerr << "Corrupted column header: " << filepath << std::endl;
+        delete file;
+        return false;
+    }
+
+    ColumnType type = static_cast<ColumnType>(header.type);
+    if(ColumnType::kByteSlicePadRight != type){
+        //layout can't be backed by the mapping: copy it in
+        delete file;
+        SequentialReadBinaryFile infile;
+        if(!infile.Open(filepath)){
+            return false;
+        }
+        bool success = DeserFromFile(infile);
+        infile.Close();
+        return success;
+    }
+
+    //locate the block index through the trailing index offset
+    uint64_t index_offset;
+    const size_t index_end = file->size() - sizeof(index_offset);
+    memcpy(&index_offset, file->data() + index_end, sizeof(index_offset));
+    if(index_offset < sizeof(header) || index_offset > index_end
+            || header.num_blocks > (index_end - index_offset) / sizeof(uint64_t)){
+        std::cerr << "Corrupted column block index: " << filepath << std::endl;
+        delete file;
+        return false;
+    }
+    size_t index_size = sizeof(uint64_t)*header.num_blocks;
+    std::vector<uint64_t> block_index(header.num_blocks);
+    memcpy(block_index.data(), file->data() + index_offset, index_size);
+
+    //build the blocks aside: the column is only changed once all of them
+    //are found within the file
+    Column staged(type, header.bit_width, 0, static_cast<PagePolicy>(header.page_policy));
+    staged.num_tuples_ = header.num_tuples;
+    staged.mapped_file_ = file;
+    //zone maps are small: read them through a regular handle
+    SequentialReadBinaryFile infile;
+    bool success = infile.Open(filepath) && infile.Seek(index_offset + index_size);
+    for(size_t block_id = 0; success && block_id < header.num_blocks; block_id++){
+        //a payload ends before the next one, or before the index
+        size_t end = (block_id + 1 < header.num_blocks)? block_index[block_id + 1] : index_offset;
+        ColumnBlock* block = staged.CreateMappedBlock(file, block_index[block_id], end);
+        if(NULL == block){
+            success = false;
+            break;
+        }
+        staged.blocks_.push_back(block);
+        size_t num = std::min(kNumTuplesPerBlock,
+                size_t(header.num_tuples - block_id*kNumTuplesPerBlock));
+        success = num == block->num_tuples() && block->zone_map().DeserFromFile(infile);
+    }
+    infile.Close();
+    if(!success){
+        std::cerr << "Corrupted column blocks: " << filepath << std::endl;
+        return false;
+    }
+
+    Swap(staged);
+    return true;
 }
 
 void Column::BulkLoadArray(const WordUnit* codes, size_t num, size_t pos){
     assert(pos + num <= num_tuples_);
-    size_t block_id = pos / kNumTuplesPerBlock;
-    size_t pos_in_block = pos % kNumTuplesPerBlock;
-    size_t num_remain_tuples = num;
-    const WordUnit* data_ptr = codes;
-    while(num_remain_tuples > 0){
-        size_t size = std::min(
-                blocks_[block_id]->num_tuples() - pos_in_block,
-                num_remain_tuples);
-        blocks_[block_id]->BulkLoadArray(data_ptr, size, pos_in_block);
-        data_ptr += size;
-        num_remain_tuples -= size;
-        pos_in_block = 0;
-        block_id++;
+    if(0 == num){
+        return;
+    }
+    const size_t first_block = pos / kNumTuplesPerBlock;
+    const size_t last_block = (pos + num - 1) / kNumTuplesPerBlock;
+    //blocks are independent: load them in parallel
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = first_block; block_id <= last_block; block_id++){
+        size_t block_begin = block_id * kNumTuplesPerBlock;
+        size_t begin = std::max(pos, block_begin);
+        size_t end = std::min(pos + num, block_begin + blocks_[block_id]->num_tuples());
+        if(begin < end){
+            blocks_[block_id]->BulkLoadArray(codes + (begin - pos), end - begin,
+                    begin - block_begin);
+        }
     }
 }
 
 
+void Column::RebuildZoneMaps(){
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        blocks_[block_id]->RebuildZoneMap();
+    }
+}
+
 void Column::Scan(Comparator comparator, WordUnit literal,
             BitVector* bitvector, Bitwise bit_opt) const{
 
@@ -127,14 +581,38 @@ void Column::Scan(Comparator comparator, WordUnit literal,
 //    std::cout << "I'm thread" << omp_get_thread_num() << "/" << omp_get_num_threads();
 //    std::cout << " Block " << block_id << std::endl;
 
+        BitVectorBlock* bvblock = bitvector->GetBVBlock(block_id);
+        //skip blocks whose min/max decide the predicate
+        ZoneMatch match = blocks_[block_id]->zone_map().Match(comparator, literal);
+        if(ZoneMatch::kSome != match){
+            ZoneMap::Fill(match, bit_opt, bvblock, 0, bvblock->num_word_units());
+            bvblock->ClearTail();
+            continue;
+        }
         blocks_[block_id]->Scan(
                 comparator, 
                 literal, 
-                bitvector->GetBVBlock(block_id), 
+                bvblock, 
                 bit_opt);
     }
 }
  
+void Column::Scan(Comparator comparator, WordUnit literal, HybridBitVector* result) const{
+    assert(num_tuples_ == result->num());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        const ColumnBlock* block = blocks_[block_id];
+        ZoneMatch match = block->zone_map().Match(comparator, literal);
+        if(ZoneMatch::kSome != match){
+            result->SetBlock(block_id, ZoneMatch::kAll == match);
+            continue;
+        }
+        BitVectorBlock bvblock(block->num_tuples());
+        block->Scan(comparator, literal, &bvblock, Bitwise::kSet);
+        result->FromBVBlock(block_id, &bvblock);
+    }
+}
+
 void Column::Scan(Comparator comparator, const Column* other_column, 
             BitVector* bitvector, Bitwise bit_opt) const{
     assert(num_tuples_ == bitvector->num());
@@ -153,6 +631,175 @@ void Column::Scan(Comparator comparator, const Column* other_column,
 
 }
 
+void Column::ScanBetween(WordUnit lo, WordUnit hi,
+            BitVector* bitvector, Bitwise bit_opt) const{
+    assert(num_tuples_ == bitvector->num());
+
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        BitVectorBlock* bvblock = bitvector->GetBVBlock(block_id);
+        ZoneMatch match = blocks_[block_id]->zone_map().MatchBetween(lo, hi);
+        if(ZoneMatch::kSome != match){
+            ZoneMap::Fill(match, bit_opt, bvblock, 0, bvblock->num_word_units());
+            bvblock->ClearTail();
+            continue;
+        }
+        blocks_[block_id]->ScanBetween(lo, hi, bvblock, bit_opt);
+    }
+}
+
+void Column::ScanIn(const std::vector<WordUnit> &literals,
+            BitVector* bitvector, Bitwise bit_opt) const{
+    assert(num_tuples_ == bitvector->num());
+    //sorted, unique, and within the codes
+    std::vector<WordUnit> codes(literals);
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    const WordUnit code_mask = (1ULL << bit_width_) - 1;
+    codes.erase(std::upper_bound(codes.begin(), codes.end(), code_mask), codes.end());
+
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        BitVectorBlock* bvblock = bitvector->GetBVBlock(block_id);
+        ZoneMatch match = codes.empty()? ZoneMatch::kNone
+            : blocks_[block_id]->zone_map().MatchIn(codes);
+        if(ZoneMatch::kSome != match){
+            ZoneMap::Fill(match, bit_opt, bvblock, 0, bvblock->num_word_units());
+            bvblock->ClearTail();
+            continue;
+        }
+        blocks_[block_id]->ScanIn(codes, bvblock, bit_opt);
+    }
+}
+
+size_t Column::CountWhere(Comparator comparator, WordUnit literal) const{
+    size_t count = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+: count)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        const ColumnBlock* block = blocks_[block_id];
+        ZoneMatch match = block->zone_map().Match(comparator, literal);
+        if(ZoneMatch::kSome != match){
+            count += (ZoneMatch::kAll == match)? block->num_tuples() : 0;
+            continue;
+        }
+        count += block->CountWhere(comparator, literal);
+    }
+    return count;
+}
+
+AggregateResult Column::Aggregate(const BitVector* filter) const{
+    assert(nullptr == filter || num_tuples_ == filter->num());
+    AggregateResult result;
+#pragma omp parallel
+    {
+        AggregateResult partial;
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+            blocks_[block_id]->Aggregate(
+                    (nullptr == filter)? nullptr : filter->GetBVBlock(block_id),
+                    &partial);
+        }
+#pragma omp critical(column_aggregate)
+        result.Merge(partial);
+    }
+    return result;
+}
+
+AggregateResult Column::AggregateWhere(const Column* predicate_column,
+        Comparator comparator, WordUnit literal) const{
+    assert(num_tuples_ == predicate_column->num_tuples());
+    AggregateResult result;
+#pragma omp parallel
+    {
+        AggregateResult partial;
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+            const ColumnBlock* predicate_block = predicate_column->GetBlock(block_id);
+            ZoneMatch match = predicate_block->zone_map().Match(comparator, literal);
+            if(ZoneMatch::kSome != match){
+                if(ZoneMatch::kAll == match){
+                    blocks_[block_id]->Aggregate(nullptr, &partial);
+                }
+                continue;
+            }
+            BitVectorBlock filter(predicate_block->num_tuples());
+            predicate_block->Scan(comparator, literal, &filter, Bitwise::kSet);
+            blocks_[block_id]->Aggregate(&filter, &partial);
+        }
+#pragma omp critical(column_aggregate)
+        result.Merge(partial);
+    }
+    return result;
+}
+
+std::vector<TopKEntry> Column::TopK(size_t k, bool largest, const BitVector* filter) const{
+    assert(nullptr == filter || num_tuples_ == filter->num());
+    std::vector<std::vector<TopKEntry>> block_results(blocks_.size());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < blocks_.size(); block_id++){
+        blocks_[block_id]->TopK(k, largest,
+                (nullptr == filter)? nullptr : filter->GetBVBlock(block_id),
+                &block_results[block_id]);
+        for(TopKEntry &entry : block_results[block_id]){
+            entry.second += block_id * kNumTuplesPerBlock;
+        }
+    }
+
+    std::vector<TopKEntry> result;
+    for(const std::vector<TopKEntry> &block_result : block_results){
+        result.insert(result.end(), block_result.begin(), block_result.end());
+    }
+    size_t num = std::min(k, result.size());
+    std::partial_sort(result.begin(), result.begin() + num, result.end(),
+            [largest](const TopKEntry &a, const TopKEntry &b){
+                return TopKBetter(a, b, largest);
+            });
+    result.resize(num);
+    return result;
+}
+
+bool Column::Min(WordUnit* min, const BitVector* filter) const{
+    std::vector<TopKEntry> top = TopK(1, false, filter);
+    if(top.empty()){
+        return false;
+    }
+    *min = top[0].first;
+    return true;
+}
+
+bool Column::Max(WordUnit* max, const BitVector* filter) const{
+    std::vector<TopKEntry> top = TopK(1, true, filter);
+    if(top.empty()){
+        return false;
+    }
+    *max = top[0].first;
+    return true;
+}
+
+void Column::Gather(const TupleId* rids, size_t n, WordUnit* out) const{
+    constexpr size_t kNumIdsPerChunk = 4096;
+    const size_t num_chunks = CEIL(n, kNumIdsPerChunk);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t chunk_id = 0; chunk_id < num_chunks; chunk_id++){
+        TupleId positions[kNumIdsPerChunk];
+        const size_t end = std::min(n, (chunk_id + 1) * kNumIdsPerChunk);
+        size_t begin = chunk_id * kNumIdsPerChunk;
+        while(begin < end){
+            assert(rids[begin] < num_tuples_);
+            const size_t block_id = rids[begin] / kNumTuplesPerBlock;
+            const TupleId base = block_id * kNumTuplesPerBlock;
+            size_t i = begin;
+            //ids below base wrap around and end the run as well
+            while(i < end && rids[i] - base < kNumTuplesPerBlock){
+                positions[i - begin] = rids[i] - base;
+                i++;
+            }
+            blocks_[block_id]->Gather(positions, i - begin, out + begin);
+            begin = i;
+        }
+    }
+}
+
 void Column::ScanByte(size_t byte_id, Comparator comparator, ByteUnit literal,
         ByteMaskVector* bm_less, ByteMaskVector* bm_greater, ByteMaskVector* bm_equal, 
         ByteMaskVector* input_mask) const{
@@ -195,6 +842,8 @@ void Column::ScanByte(size_t byte_id, Comparator comparator, ByteUnit literal,
 }
 
 ColumnBlock* Column::CreateNewBlock() const{
+    //block storage is allocated under the column's page policy
+    BufferPool::PolicyScope scope(page_policy_);
     assert(0 < bit_width_ && 32 >= bit_width_);
     if(!(0<bit_width_ && 32>= bit_width_)){
         std::cerr << "Incorrect bit width: " << bit_width_ << std::endl;
@@ -597,6 +1246,72 @@ ColumnBlock* Column::CreateNewBlock() const{
             std::cerr << "Unknown column type." << std::endl;
             exit(1);
     }
+    return NULL;
+}
+
+/**
+  A block over the ByteSlice payload at offset, or NULL if the payload is
+  not aligned or does not fit in [offset, end) of the file.
+*/
+template <size_t BIT_WIDTH>
+static ColumnBlock* NewMappedByteSliceBlock(const MappedBinaryFile* file, size_t offset,
+        size_t end){
+    if(0 != offset % kColumnFileAlignment || end > file->size() || offset > end
+            || end - offset < ByteSliceColumnBlock<BIT_WIDTH>::PayloadSize()){
+        return NULL;
+    }
+    return new ByteSliceColumnBlock<BIT_WIDTH>(file, offset);
+}
+
+ColumnBlock* Column::CreateMappedBlock(const MappedBinaryFile* file, size_t offset,
+        size_t end) const{
+    assert(0 < bit_width_ && 32 >= bit_width_);
+    if(!(0<bit_width_ && 32>= bit_width_)){
+        std::cerr << "Incorrect bit width: " << bit_width_ << std::endl;
+    }
+
+    switch(type_){
+        case ColumnType::kByteSlicePadRight:
+            switch(bit_width_){
+                case 1: return NewMappedByteSliceBlock<1>(file, offset, end);
+                case 2: return NewMappedByteSliceBlock<2>(file, offset, end);
+                case 3: return NewMappedByteSliceBlock<3>(file, offset, end);
+                case 4: return NewMappedByteSliceBlock<4>(file, offset, end);
+                case 5: return NewMappedByteSliceBlock<5>(file, offset, end);
+                case 6: return NewMappedByteSliceBlock<6>(file, offset, end);
+                case 7: return NewMappedByteSliceBlock<7>(file, offset, end);
+                case 8: return NewMappedByteSliceBlock<8>(file, offset, end);
+                case 9: return NewMappedByteSliceBlock<9>(file, offset, end);
+                case 10: return NewMappedByteSliceBlock<10>(file, offset, end);
+                case 11: return NewMappedByteSliceBlock<11>(file, offset, end);
+                case 12: return NewMappedByteSliceBlock<12>(file, offset, end);
+                case 13: return NewMappedByteSliceBlock<13>(file, offset, end);
+                case 14: return NewMappedByteSliceBlock<14>(file, offset, end);
+                case 15: return NewMappedByteSliceBlock<15>(file, offset, end);
+                case 16: return NewMappedByteSliceBlock<16>(file, offset, end);
+                case 17: return NewMappedByteSliceBlock<17>(file, offset, end);
+                case 18: return NewMappedByteSliceBlock<18>(file, offset, end);
+                case 19: return NewMappedByteSliceBlock<19>(file, offset, end);
+                case 20: return NewMappedByteSliceBlock<20>(file, offset, end);
+                case 21: return NewMappedByteSliceBlock<21>(file, offset, end);
+                case 22: return NewMappedByteSliceBlock<22>(file, offset, end);
+                case 23: return NewMappedByteSliceBlock<23>(file, offset, end);
+                case 24: return NewMappedByteSliceBlock<24>(file, offset, end);
+                case 25: return NewMappedByteSliceBlock<25>(file, offset, end);
+                case 26: return NewMappedByteSliceBlock<26>(file, offset, end);
+                case 27: return NewMappedByteSliceBlock<27>(file, offset, end);
+                case 28: return NewMappedByteSliceBlock<28>(file, offset, end);
+                case 29: return NewMappedByteSliceBlock<29>(file, offset, end);
+                case 30: return NewMappedByteSliceBlock<30>(file, offset, end);
+                case 31: return NewMappedByteSliceBlock<31>(file, offset, end);
+                case 32: return NewMappedByteSliceBlock<32>(file, offset, end);
+            }
+            return NULL;
+
+        default:
+            std::cerr << "Column type can't be mapped." << std::endl;
+            return NULL;
+    }
 }
 
 }   //namespace
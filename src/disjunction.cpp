@@ -14,18 +14,23 @@ void Disjunction::AddPredicate(AtomPredicate predicate){
 void Disjunction::ExecuteBlockwise(BitVector* bitvector){
     size_t num_blocks = conjunctions_[0].column->GetNumBlocks();
 
-#pragma omp parallel for schedule(dynamic)
-    for(size_t block_id = 0; block_id < num_blocks; block_id++){
-        size_t num = conjunctions_[0].column->GetBlock(block_id)->num_tuples();
-        ByteMaskBlock* bmblk = new ByteMaskBlock(num);
-        for(size_t pid = 0; pid < conjunctions_.size(); pid++){
-            ColumnBlock* block = conjunctions_[pid].column->GetBlock(block_id);
-            block->Scan(conjunctions_[pid].comparator,
-                        conjunctions_[pid].literal,
-                        bmblk,
-                        (0 == pid)? Bitwise::kSet : Bitwise::kOr);
+    //one byte mask block per thread, reused across blocks
+#pragma omp parallel
+    {
+        ByteMaskBlock* bmblk = new ByteMaskBlock(kNumTuplesPerBlock);
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < num_blocks; block_id++){
+            size_t num = conjunctions_[0].column->GetBlock(block_id)->num_tuples();
+            bmblk->Resize(num);
+            for(size_t pid = 0; pid < conjunctions_.size(); pid++){
+                ColumnBlock* block = conjunctions_[pid].column->GetBlock(block_id);
+                block->Scan(conjunctions_[pid].comparator,
+                            conjunctions_[pid].literal,
+                            bmblk,
+                            (0 == pid)? Bitwise::kSet : Bitwise::kOr);
+            }
+            bmblk->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
         }
-        bmblk->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
         delete bmblk;
     }
 }
@@ -58,6 +63,7 @@ void Disjunction::ExecuteColumnwise(BitVector* bitvector){
     }
 
     //Condense into result
+#   pragma omp parallel for schedule(dynamic)
     for(size_t block_id = 0; block_id < num_blocks; block_id++){
         bmvector[block_id]->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
     }
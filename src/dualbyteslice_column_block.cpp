@@ -2,6 +2,8 @@
 #include    <cstdlib>
 #include    <cstring>
 #include    <include/avx-utility.h>
+#include    "include/buffer_pool.h"
+#include    "include/range_scan.h"
 
 namespace byteslice{
     
@@ -22,42 +24,49 @@ DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::DualByteSliceColumnBlock(size_t
     //allocate memory space
     assert(num <= kNumTuplesPerBlock);
     for(size_t i=0; i < kNumDualBytesPerCode; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerDualByteSlice);                    
-        ret = ret;
+        data_[i] = static_cast<DualByteUnit*>(BufferPool::Allocate(kMemSizePerDualByteSlice));
         memset(data_[i], 0x0, kMemSizePerDualByteSlice);
     }
 
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::~DualByteSliceColumnBlock(){
     for(size_t i=0; i < kNumDualBytesPerCode; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerDualByteSlice);
     }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 bool DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
     for(size_t dualbyte_id = 0; dualbyte_id < kNumDualBytesPerCode; dualbyte_id++){
-        file.Append(data_[dualbyte_id], kMemSizePerDualByteSlice);
+        success = success
+                && kMemSizePerDualByteSlice == file.Append(data_[dualbyte_id], kMemSizePerDualByteSlice);
     }
+    return success;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
     for(size_t dualbyte_id = 0; dualbyte_id < kNumDualBytesPerCode; dualbyte_id++){
-        file.Read(data_[dualbyte_id], kMemSizePerDualByteSlice);
+        success = success
+                && kMemSizePerDualByteSlice == file.Read(data_[dualbyte_id], kMemSizePerDualByteSlice);
     }
+    return success;
 }
 
 
@@ -82,6 +91,16 @@ void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator comparator
     }
 }
 
+//Range scan: both bounds in one pass
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetween(WordUnit lo, WordUnit hi,
+        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+    assert(bvblock->num() == num_tuples_);
+    const size_t padding = (Direction::kRight == PDIRECTION)? kNumPaddingBits : 0;
+    ScanBetweenSlices<DualByteUnit, kNumDualBytesPerCode, 1>(data_, num_tuples_, BIT_WIDTH, padding,
+            lo, hi, zone_map_, bvblock, bit_opt);
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP>
 void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper1(WordUnit literal,
@@ -510,6 +529,7 @@ void DualByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::BulkLoadArray(const WordUn
     for(size_t i = 0; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 
@@ -2,6 +2,7 @@
 #include    <cstdlib>
 #include    <cstring>
 #include    "include/avx-utility.h"
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -15,8 +16,7 @@ HbpColumnBlock<BIT_WIDTH>::HbpColumnBlock(size_t num):
     assert(num <= kNumTuplesPerBlock);
 
     for(size_t i=0; i < kNumWordsPerSegment; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerWordId);
-        ret = ret;
+        data_[i] = static_cast<WordUnit*>(BufferPool::Allocate(kMemSizePerWordId));
         memset(data_[i], 0x0, kMemSizePerWordId);
     }
 
@@ -25,39 +25,46 @@ HbpColumnBlock<BIT_WIDTH>::HbpColumnBlock(size_t num):
         seek_helpers_[id].word_id_in_segment = id % kNumWordsPerSegment;
         seek_helpers_[id].shift_in_word = (id / kNumWordsPerSegment) * (BIT_WIDTH + 1);
     }
+
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH>
 bool HbpColumnBlock<BIT_WIDTH>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
     num_segments_ = CEIL(num_tuples_, kNumCodesPerSegment);
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH>
 HbpColumnBlock<BIT_WIDTH>::~HbpColumnBlock(){
     for(size_t i = 0; i < kNumWordsPerSegment; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerWordId);
     }
 }
 
 template <size_t BIT_WIDTH>
-void HbpColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
+bool HbpColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
 
     for(size_t i=0; i < kNumWordsPerSegment; i++){
-        file.Append(data_[i], kMemSizePerWordId);
+        success = success && kMemSizePerWordId == file.Append(data_[i], kMemSizePerWordId);
     }
+    return success;
 }
 
 template <size_t BIT_WIDTH>
-void HbpColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
+bool HbpColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
     num_segments_ = CEIL(num_tuples_, kNumCodesPerSegment);
 
     for(size_t i=0; i < kNumWordsPerSegment; i++){
-        file.Read(data_[i], kMemSizePerWordId);
+        success = success && kMemSizePerWordId == file.Read(data_[i], kMemSizePerWordId);
     }
+    return success;
 }
 
 //Scan against literal
@@ -350,6 +357,7 @@ void HbpColumnBlock<BIT_WIDTH>::BulkLoadArray(const WordUnit* codes,
     for(size_t i = 0; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 //explict specialization
@@ -0,0 +1,384 @@
+#include    "include/hybrid_bitvector.h"
+#include    <algorithm>
+#include    <iterator>
+#include    <omp.h>
+
+namespace byteslice{
+
+static constexpr size_t kNumContainersPerBlock =
+    kNumTuplesPerBlock / BitContainer::kNumTuplesPerContainer;
+static_assert(0 == kNumTuplesPerBlock % BitContainer::kNumTuplesPerContainer,
+        "a block must hold a whole number of containers");
+
+//An array is never larger than a bitmap beyond this many 1's
+static constexpr size_t kMaxArraySize = BitContainer::kNumWordsPerContainer * sizeof(WordUnit)
+    / sizeof(uint16_t);
+
+void BitContainer::FromWords(const WordUnit* words, size_t num_words){
+    assert(num_words <= kNumWordsPerContainer);
+    Pack(words, num_words);
+}
+
+void BitContainer::Pack(const WordUnit* words, size_t num_words){
+    //count the 1's and the runs of 1's (a run starts at a 1 after a 0)
+    size_t count = 0;
+    size_t num_runs = 0;
+    WordUnit carry = 0;
+    for(size_t i = 0; i < num_words; i++){
+        count += POPCNT64(words[i]);
+        num_runs += POPCNT64(words[i] & ~((words[i] << 1) | carry));
+        carry = words[i] >> (kNumWordBits - 1);
+    }
+
+    const size_t array_bytes = count * sizeof(uint16_t);
+    const size_t run_bytes = 2 * num_runs * sizeof(uint16_t);
+    const size_t bitmap_bytes = kNumWordsPerContainer * sizeof(WordUnit);
+    count_ = count;
+    array_.clear();
+    bitmap_.clear();
+    if(array_bytes <= run_bytes && array_bytes <= bitmap_bytes){
+        type_ = ContainerType::kArray;
+        array_.reserve(count);
+        for(size_t i = 0; i < num_words; i++){
+            WordUnit word = words[i];
+            while(0 != word){
+                array_.push_back(i * kNumWordBits + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+    else if(run_bytes <= bitmap_bytes){
+        type_ = ContainerType::kRun;
+        array_.reserve(2 * num_runs);
+        size_t i = 0;
+        while(i < num_words * kNumWordBits){
+            //skip the 0's, then the 1's
+            WordUnit word = words[i / kNumWordBits] >> (i % kNumWordBits);
+            if(0 == word){
+                i = (i / kNumWordBits + 1) * kNumWordBits;
+                continue;
+            }
+            i += __builtin_ctzll(word);
+            size_t first = i;
+            while(i < num_words * kNumWordBits){
+                WordUnit zeros = ~words[i / kNumWordBits] >> (i % kNumWordBits);
+                if(0 == zeros){
+                    i = (i / kNumWordBits + 1) * kNumWordBits;
+                    continue;
+                }
+                i += __builtin_ctzll(zeros);
+                break;
+            }
+            i = std::min(i, num_words * kNumWordBits);
+            array_.push_back(first);
+            array_.push_back(i - 1);
+        }
+    }
+    else{
+        type_ = ContainerType::kBitmap;
+        bitmap_.assign(kNumWordsPerContainer, 0);
+        std::copy(words, words + num_words, bitmap_.begin());
+    }
+    array_.shrink_to_fit();
+    bitmap_.shrink_to_fit();
+}
+
+void BitContainer::ToWords(WordUnit* words, size_t num_words) const{
+    assert(num_words <= kNumWordsPerContainer);
+    switch(type_){
+        case ContainerType::kArray:
+            std::fill(words, words + num_words, 0);
+            for(uint16_t offset : array_){
+                words[offset / kNumWordBits] |= 1ULL << (offset % kNumWordBits);
+            }
+            break;
+        case ContainerType::kRun:
+            std::fill(words, words + num_words, 0);
+            for(size_t r = 0; r < array_.size(); r += 2){
+                const size_t first = array_[r];
+                const size_t last = array_[r + 1];
+                const size_t first_word = first / kNumWordBits;
+                const size_t last_word = last / kNumWordBits;
+                const WordUnit head = ~0ULL << (first % kNumWordBits);
+                const WordUnit tail = ~0ULL >> (kNumWordBits - 1 - last % kNumWordBits);
+                if(first_word == last_word){
+                    words[first_word] |= head & tail;
+                    continue;
+                }
+                words[first_word] |= head;
+                std::fill(words + first_word + 1, words + last_word, ~0ULL);
+                words[last_word] |= tail;
+            }
+            break;
+        case ContainerType::kBitmap:
+            std::copy(bitmap_.begin(), bitmap_.begin() + num_words, words);
+            break;
+    }
+}
+
+void BitContainer::SetRange(size_t num){
+    assert(num <= kNumTuplesPerContainer);
+    if(0 == num){
+        Clear();
+        return;
+    }
+    type_ = ContainerType::kRun;
+    count_ = num;
+    array_.assign({0, static_cast<uint16_t>(num - 1)});
+    bitmap_.clear();
+    bitmap_.shrink_to_fit();
+}
+
+void BitContainer::Clear(){
+    type_ = ContainerType::kArray;
+    count_ = 0;
+    array_.clear();
+    array_.shrink_to_fit();
+    bitmap_.clear();
+    bitmap_.shrink_to_fit();
+}
+
+void BitContainer::And(const BitContainer &other){
+    if(ContainerType::kArray == type_ || ContainerType::kArray == other.type_){
+        //the result is within the array: keep what the other side has
+        std::vector<uint16_t> result;
+        if(ContainerType::kArray == type_ && ContainerType::kArray == other.type_){
+            std::set_intersection(array_.begin(), array_.end(),
+                    other.array_.begin(), other.array_.end(), std::back_inserter(result));
+        }
+        else{
+            const BitContainer &array = (ContainerType::kArray == type_)? *this : other;
+            const BitContainer &probe = (ContainerType::kArray == type_)? other : *this;
+            for(uint16_t offset : array.array_){
+                if(probe.GetBit(offset)){
+                    result.push_back(offset);
+                }
+            }
+        }
+        type_ = ContainerType::kArray;
+        count_ = result.size();
+        array_.swap(result);
+        array_.shrink_to_fit();
+        bitmap_.clear();
+        bitmap_.shrink_to_fit();
+        return;
+    }
+    WordUnit words[kNumWordsPerContainer];
+    WordUnit other_words[kNumWordsPerContainer];
+    ToWords(words, kNumWordsPerContainer);
+    other.ToWords(other_words, kNumWordsPerContainer);
+    for(size_t i = 0; i < kNumWordsPerContainer; i++){
+        words[i] &= other_words[i];
+    }
+    Pack(words, kNumWordsPerContainer);
+}
+
+void BitContainer::Or(const BitContainer &other){
+    if(ContainerType::kArray == type_ && ContainerType::kArray == other.type_
+            && count_ + other.count_ <= kMaxArraySize){
+        std::vector<uint16_t> result;
+        result.reserve(count_ + other.count_);
+        std::set_union(array_.begin(), array_.end(),
+                other.array_.begin(), other.array_.end(), std::back_inserter(result));
+        count_ = result.size();
+        array_.swap(result);
+        array_.shrink_to_fit();
+        return;
+    }
+    WordUnit words[kNumWordsPerContainer];
+    WordUnit other_words[kNumWordsPerContainer];
+    ToWords(words, kNumWordsPerContainer);
+    other.ToWords(other_words, kNumWordsPerContainer);
+    for(size_t i = 0; i < kNumWordsPerContainer; i++){
+        words[i] |= other_words[i];
+    }
+    Pack(words, kNumWordsPerContainer);
+}
+
+bool BitContainer::GetBit(size_t offset) const{
+    switch(type_){
+        case ContainerType::kArray:
+            return std::binary_search(array_.begin(), array_.end(), offset);
+        case ContainerType::kRun:{
+            //the last run starting at or before offset
+            size_t lo = 0;
+            size_t hi = array_.size() / 2;
+            while(lo < hi){
+                size_t mid = (lo + hi) / 2;
+                if(array_[2 * mid] <= offset){
+                    lo = mid + 1;
+                }
+                else{
+                    hi = mid;
+                }
+            }
+            return 0 != lo && offset <= array_[2 * (lo - 1) + 1];
+        }
+        case ContainerType::kBitmap:
+            return (bitmap_[offset / kNumWordBits] >> (offset % kNumWordBits)) & 1ULL;
+    }
+    return false;
+}
+
+size_t BitContainer::GetPositions(TupleId base, TupleId* positions) const{
+    size_t n = 0;
+    switch(type_){
+        case ContainerType::kArray:
+            for(uint16_t offset : array_){
+                positions[n++] = base + offset;
+            }
+            break;
+        case ContainerType::kRun:
+            for(size_t r = 0; r < array_.size(); r += 2){
+                for(size_t offset = array_[r]; offset <= array_[r + 1]; offset++){
+                    positions[n++] = base + offset;
+                }
+            }
+            break;
+        case ContainerType::kBitmap:{
+            //8 at a time while there is room (see BitVectorBlock::GetPositions)
+            size_t word_id = 0;
+            for(; word_id < kNumWordsPerContainer; word_id++){
+                WordUnit word = bitmap_[word_id];
+                if(n + POPCNT64(word) + 8 > count_){
+                    break;
+                }
+                if(0 != word){
+                    n += BitVectorBlock::ExpandWord(word, base + word_id * kNumWordBits,
+                            positions + n);
+                }
+            }
+            for(; word_id < kNumWordsPerContainer; word_id++){
+                WordUnit word = bitmap_[word_id];
+                while(0 != word){
+                    positions[n++] = base + word_id * kNumWordBits + __builtin_ctzll(word);
+                    word &= word - 1;
+                }
+            }
+            break;
+        }
+    }
+    return n;
+}
+
+size_t BitContainer::GetNumBytes() const{
+    return sizeof(BitContainer) + array_.capacity() * sizeof(uint16_t)
+        + bitmap_.capacity() * sizeof(WordUnit);
+}
+
+HybridBitVector::HybridBitVector(size_t num):
+    containers_(CEIL(num, BitContainer::kNumTuplesPerContainer)),
+    num_(num){
+}
+
+size_t HybridBitVector::ContainerSize(size_t id) const{
+    return std::min(BitContainer::kNumTuplesPerContainer,
+            num_ - id * BitContainer::kNumTuplesPerContainer);
+}
+
+void HybridBitVector::FromBVBlock(size_t block_id, const BitVectorBlock* bvblock){
+    WordUnit words[BitContainer::kNumWordsPerContainer];
+    const size_t end = std::min(containers_.size(), (block_id + 1) * kNumContainersPerBlock);
+    for(size_t id = block_id * kNumContainersPerBlock; id < end; id++){
+        const size_t first_word = (id % kNumContainersPerBlock) * BitContainer::kNumWordsPerContainer;
+        const size_t num_words = CEIL(ContainerSize(id), kNumWordBits);
+        for(size_t i = 0; i < num_words; i++){
+            words[i] = bvblock->GetWordUnit(first_word + i);
+        }
+        containers_[id].FromWords(words, num_words);
+    }
+}
+
+void HybridBitVector::ToBVBlock(size_t block_id, BitVectorBlock* bvblock) const{
+    WordUnit words[BitContainer::kNumWordsPerContainer];
+    const size_t end = std::min(containers_.size(), (block_id + 1) * kNumContainersPerBlock);
+    for(size_t id = block_id * kNumContainersPerBlock; id < end; id++){
+        const size_t first_word = (id % kNumContainersPerBlock) * BitContainer::kNumWordsPerContainer;
+        const size_t num_words = CEIL(ContainerSize(id), kNumWordBits);
+        containers_[id].ToWords(words, num_words);
+        for(size_t i = 0; i < num_words; i++){
+            bvblock->SetWordUnit(words[i], first_word + i);
+        }
+    }
+    bvblock->ClearTail();
+}
+
+void HybridBitVector::FromBitVector(const BitVector* bitvector){
+    assert(num_ == bitvector->num());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < bitvector->GetNumBlocks(); block_id++){
+        FromBVBlock(block_id, bitvector->GetBVBlock(block_id));
+    }
+}
+
+void HybridBitVector::ToBitVector(BitVector* bitvector) const{
+    assert(num_ == bitvector->num());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < bitvector->GetNumBlocks(); block_id++){
+        ToBVBlock(block_id, bitvector->GetBVBlock(block_id));
+    }
+}
+
+void HybridBitVector::SetBlock(size_t block_id, bool one){
+    const size_t end = std::min(containers_.size(), (block_id + 1) * kNumContainersPerBlock);
+    for(size_t id = block_id * kNumContainersPerBlock; id < end; id++){
+        if(one){
+            containers_[id].SetRange(ContainerSize(id));
+        }
+        else{
+            containers_[id].Clear();
+        }
+    }
+}
+
+void HybridBitVector::And(const HybridBitVector* other){
+    assert(num_ == other->num());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t id = 0; id < containers_.size(); id++){
+        containers_[id].And(other->containers_[id]);
+    }
+}
+
+void HybridBitVector::Or(const HybridBitVector* other){
+    assert(num_ == other->num());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t id = 0; id < containers_.size(); id++){
+        containers_[id].Or(other->containers_[id]);
+    }
+}
+
+bool HybridBitVector::GetBit(size_t pos) const{
+    return containers_[pos / BitContainer::kNumTuplesPerContainer].GetBit(
+            pos % BitContainer::kNumTuplesPerContainer);
+}
+
+size_t HybridBitVector::CountOnes() const{
+    size_t count = 0;
+    for(const BitContainer &container : containers_){
+        count += container.CountOnes();
+    }
+    return count;
+}
+
+void HybridBitVector::ToPositions(std::vector<TupleId>* positions) const{
+    std::vector<size_t> offsets(containers_.size() + 1, 0);
+    for(size_t id = 0; id < containers_.size(); id++){
+        offsets[id + 1] = offsets[id] + containers_[id].CountOnes();
+    }
+    positions->resize(offsets.back());
+#pragma omp parallel for schedule(dynamic)
+    for(size_t id = 0; id < containers_.size(); id++){
+        containers_[id].GetPositions(id * BitContainer::kNumTuplesPerContainer,
+                positions->data() + offsets[id]);
+    }
+}
+
+size_t HybridBitVector::GetNumBytes() const{
+    size_t num_bytes = 0;
+    for(const BitContainer &container : containers_){
+        num_bytes += container.GetNumBytes();
+    }
+    return num_bytes;
+}
+
+}   //namespace
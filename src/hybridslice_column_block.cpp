@@ -3,6 +3,9 @@
 #include    <cstring>
 #include    <algorithm>
 #include    <include/avx-utility.h>
+#include    "include/bit_transpose.h"
+#include    "include/buffer_pool.h"
+#include    "include/in_list_scan.h"
 
 namespace byteslice{
 
@@ -15,48 +18,63 @@ HybridSliceColumnBlock<BIT_WIDTH>::HybridSliceColumnBlock(size_t num):
 
     //allocate byteslice space
     for(size_t i=0; i < kNumByteSlices; i++){
-        size_t size = CEIL(kNumTuplesPerBlock, sizeof(AvxUnit))*sizeof(AvxUnit);
-        size_t ret = posix_memalign((void**)&data_[i], 32, size);
-        ret = ret;
-        memset(data_[i], 0x0, size);
+        data_[i] = static_cast<ByteUnit*>(BufferPool::Allocate(kMemSizePerByteSlice));
+        memset(data_[i], 0x0, kMemSizePerByteSlice);
     }
 
     //allocate bitslice space
     for(size_t i=0; i < kNumBitSlices; i++){
-        size_t size = sizeof(AvxUnit) * CEIL(kNumTuplesPerBlock, kNumAvxBits);
-        size_t ret = posix_memalign((void**)&bit_data_[i], 32, size);
-        ret = ret;
-        memset(bit_data_[i], 0x0, size);
+        bit_data_[i] = static_cast<WordUnit*>(BufferPool::Allocate(kMemSizePerBitSlice));
+        memset(bit_data_[i], 0x0, kMemSizePerBitSlice);
     }
+
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH>
 HybridSliceColumnBlock<BIT_WIDTH>::~HybridSliceColumnBlock(){
     //free byteslice
     for(size_t i=0; i < kNumByteSlices; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerByteSlice);
     }
 
     //free bit slice
     for(size_t i=0; i < kNumBitSlices; i++){
-        free(bit_data_[i]);
+        BufferPool::Release(bit_data_[i], kMemSizePerBitSlice);
     }
 }
 
 template <size_t BIT_WIDTH>
 bool HybridSliceColumnBlock<BIT_WIDTH>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH>
-void HybridSliceColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
-
+bool HybridSliceColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
+    for(size_t i=0; i < kNumByteSlices; i++){
+        success = success && kMemSizePerByteSlice == file.Append(data_[i], kMemSizePerByteSlice);
+    }
+    for(size_t i=0; i < kNumBitSlices; i++){
+        success = success && kMemSizePerBitSlice == file.Append(bit_data_[i], kMemSizePerBitSlice);
+    }
+    return success;
 }
 
 template <size_t BIT_WIDTH>
-void HybridSliceColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
-
+bool HybridSliceColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
+    for(size_t i=0; i < kNumByteSlices; i++){
+        success = success && kMemSizePerByteSlice == file.Read(data_[i], kMemSizePerByteSlice);
+    }
+    for(size_t i=0; i < kNumBitSlices; i++){
+        success = success && kMemSizePerBitSlice == file.Read(bit_data_[i], kMemSizePerBitSlice);
+    }
+    return success;
 }
 
 //Scan literal
@@ -83,6 +101,15 @@ void HybridSliceColumnBlock<BIT_WIDTH>::Scan(Comparator comparator,
 
 }
 
+template <size_t BIT_WIDTH>
+void HybridSliceColumnBlock<BIT_WIDTH>::ScanIn(const std::vector<WordUnit> &literals,
+        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+    assert(bvblock->num() == num_tuples_);
+    ScanInSlices<HybridSliceColumnBlock<BIT_WIDTH>, kNumByteSlices, kNumBitSlices>(
+            this, data_, bit_data_, num_tuples_, BIT_WIDTH, kNumPaddingBits,
+            literals, zone_map_, bvblock, bit_opt);
+}
+
 template <size_t BIT_WIDTH>
 template <Comparator CMP>
 void HybridSliceColumnBlock<BIT_WIDTH>::ScanHelper1(WordUnit literal,
@@ -713,9 +740,33 @@ void HybridSliceColumnBlock<BIT_WIDTH>::BulkLoadArray(const WordUnit* codes,
                                                       size_t num,
                                                       size_t start_pos){
     assert(start_pos + num <= num_tuples_);
-    for(size_t i = 0; i < num; i++){
+    size_t i = 0;
+    //head: up to the next segment boundary
+    for(; i < num && 0 != (start_pos + i) % kNumAvxBits; i++){
+        SetTuple(start_pos+i, codes[i]);
+    }
+    //whole segments: transpose the bit-sliced part at once
+    AvxUnit slices[64];
+    for(; i + kNumAvxBits <= num; i += kNumAvxBits){
+        size_t pos = start_pos + i;
+        if(kNumBitSlices > 0){
+            TransposeBits256(codes + i, slices);
+            size_t word_id = pos / kNumWordBits;
+            for(size_t bit_id = 0; bit_id < kNumBitSlices; bit_id++){
+                _mm256_storeu_si256(
+                        reinterpret_cast<__m256i*>(bit_data_[bit_id] + word_id),
+                        slices[kNumBitSlices - 1 - bit_id]);
+            }
+        }
+        for(size_t k = 0; k < kNumAvxBits; k++){
+            SetByteSlices(pos + k, codes[i + k] >> kNumBitSlices);
+        }
+    }
+    //tail
+    for(; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 //explicit specialization
@@ -0,0 +1,61 @@
+#include    "mapped_binary_file.h"
+
+#include    <iostream>
+#include    <fcntl.h>
+#include    <unistd.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+
+namespace byteslice{
+
+MappedBinaryFile::~MappedBinaryFile(){
+    if(NULL != data_){
+        Close();
+    }
+}
+
+bool MappedBinaryFile::Open(const std::string filename){
+    if(NULL != data_){
+        std::cerr << "Already mapped file: " << filename_ << std::endl;
+        return false;
+    }
+    filename_ = filename;
+    int fd = open(filename_.c_str(), O_RDONLY);
+    if(fd < 0){
+        std::cerr << "Can't open file: " << filename_ << std::endl;
+        return false;
+    }
+    struct stat st;
+    if(0 != fstat(fd, &st) || 0 == st.st_size){
+        std::cerr << "Can't map empty file: " << filename_ << std::endl;
+        close(fd);
+        return false;
+    }
+    size_ = st.st_size;
+    void* addr = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    //the mapping stays valid after the descriptor is closed
+    close(fd);
+    if(MAP_FAILED == addr){
+        std::cerr << "Can't map file: " << filename_ << std::endl;
+        size_ = 0;
+        return false;
+    }
+    data_ = static_cast<char*>(addr);
+    return true;
+}
+
+bool MappedBinaryFile::Close(){
+    if(NULL == data_){
+        std::cerr << "No file mapped." << std::endl;
+        return false;
+    }
+    if(0 != munmap(data_, size_)){
+        std::cerr << "Error happens when unmapping file: " << filename_ << std::endl;
+        return false;
+    }
+    data_ = NULL;
+    size_ = 0;
+    return true;
+}
+
+}   //namespace
@@ -3,6 +3,7 @@
 #include    <cstdint>
 #include    <cstring>
 #include    "include/avx-utility.h"
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -10,33 +11,40 @@ template <typename DTYPE>
 NaiveAvxColumnBlock<DTYPE>::NaiveAvxColumnBlock(size_t num):
     ColumnBlock(ColumnType::kNaiveAvx, sizeof(DTYPE)*8, num){
     assert(num <= kNumTuplesPerBlock);
-    size_t ret = posix_memalign((void**)&data_, 32, sizeof(DTYPE)*kNumTuplesPerBlock);
-    ret = ret;
+    data_ = static_cast<DTYPE*>(BufferPool::Allocate(sizeof(DTYPE)*kNumTuplesPerBlock));
     memset(data_, 0x0, sizeof(DTYPE)*kNumTuplesPerBlock);
 
+    InitZoneMap();
 }
 
 template <typename DTYPE>
 NaiveAvxColumnBlock<DTYPE>::~NaiveAvxColumnBlock(){
-    free(data_);
+    BufferPool::Release(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
 }
 
 template <typename DTYPE>
 bool NaiveAvxColumnBlock<DTYPE>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <typename DTYPE>
-void NaiveAvxColumnBlock<DTYPE>::SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
-    file.Append(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+bool NaiveAvxColumnBlock<DTYPE>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
+    success = success
+            && sizeof(DTYPE)*kNumTuplesPerBlock == file.Append(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+    return success;
 }
 
 template <typename DTYPE>
-void NaiveAvxColumnBlock<DTYPE>::DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
-    file.Read(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+bool NaiveAvxColumnBlock<DTYPE>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
+    success = success
+            && sizeof(DTYPE)*kNumTuplesPerBlock == file.Read(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+    return success;
 }
 
 //Scan against a literal
@@ -288,6 +296,7 @@ void NaiveAvxColumnBlock<DTYPE>::BulkLoadArray(const WordUnit* codes, size_t num
         data_[start_pos+i] = FLIP<DTYPE>(static_cast<DTYPE>(codes[i]));
     }
 
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 //explict specialization
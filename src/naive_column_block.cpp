@@ -1,36 +1,46 @@
 #include    "include/naive_column_block.h"
 #include    <cstring>
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
 template <typename DTYPE>
 NaiveColumnBlock<DTYPE>::NaiveColumnBlock(size_t num):
     ColumnBlock(ColumnType::kNaive, sizeof(DTYPE)*8, num){
-        data_ = new DTYPE[kNumTuplesPerBlock];
+        data_ = static_cast<DTYPE*>(BufferPool::Allocate(sizeof(DTYPE)*kNumTuplesPerBlock));
         memset(data_, 0x0, sizeof(DTYPE)*kNumTuplesPerBlock);
+
+        InitZoneMap();
 }
 
 template <typename DTYPE>
 NaiveColumnBlock<DTYPE>::~NaiveColumnBlock(){
-    delete[] data_;
+    BufferPool::Release(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
 }
 
 template <typename DTYPE>
 bool NaiveColumnBlock<DTYPE>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <typename DTYPE>
-void NaiveColumnBlock<DTYPE>::SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
-    file.Append(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+bool NaiveColumnBlock<DTYPE>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
+    success = success
+            && sizeof(DTYPE)*kNumTuplesPerBlock == file.Append(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+    return success;
 }
 
 template <typename DTYPE>
-void NaiveColumnBlock<DTYPE>::DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
-    file.Read(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+bool NaiveColumnBlock<DTYPE>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
+    success = success
+            && sizeof(DTYPE)*kNumTuplesPerBlock == file.Read(data_, sizeof(DTYPE)*kNumTuplesPerBlock);
+    return success;
 }
 
 //Scan against a literal
@@ -230,6 +240,7 @@ void NaiveColumnBlock<DTYPE>::BulkLoadArray(const WordUnit* codes, size_t num,
     for(size_t i = 0; i < num; i++){
         data_[start_pos+i] = static_cast<DTYPE>(codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 
@@ -2,32 +2,120 @@
 #include    "include/byte_mask_block.h"
 #include    <omp.h>
 #include    <vector>
+#include    <algorithm>
+#include    <limits>
 
 namespace byteslice{
 
+constexpr size_t PipelineScan::kStatsInterval;
+
 void PipelineScan::AddPredicate(AtomPredicate predicate){
     //assert(conjunctions_.size() == 0 || predicate.column->num_tuples() == conjunctions_[0].column->num_tuples());
     assert(predicate.column->type() == ColumnType::kByteSlicePadRight);
     conjunctions_.push_back(predicate);
+    order_.push_back(conjunctions_.size() - 1);
+    stats_.push_back(PredicateStats());
+}
+
+void PipelineScan::SetAdaptive(bool adaptive){
+    adaptive_ = adaptive;
+}
+
+void PipelineScan::ResetStats(){
+    stats_.assign(conjunctions_.size(), PredicateStats());
+}
+
+void PipelineScan::Reorder(){
+    //Expected cost per tuple: c1 + s1*c2 + s1*s2*c3 + ...
+    //is minimal with the predicates sorted by c / (1 - s).
+    std::vector<double> ranks(conjunctions_.size());
+    for(size_t pid = 0; pid < conjunctions_.size(); pid++){
+        const PredicateStats &stats = stats_[pid];
+        if(0 == stats.num_blocks){
+            //not measured yet: keep the order
+            return;
+        }
+        //a predicate that only saw empty inputs is ranked last
+        double drop = 1.0 - stats.selectivity();
+        ranks[pid] = (drop > 0)? stats.cycles_per_tuple() / drop
+                               : std::numeric_limits<double>::max();
+    }
+    std::stable_sort(order_.begin(), order_.end(),
+            [&ranks](size_t a, size_t b){ return ranks[a] < ranks[b]; });
+}
+
+void PipelineScan::ScanBlock(size_t block_id, ByteMaskBlock* bmblk,
+        std::vector<size_t> &order){
+    const size_t num_predicates = conjunctions_.size();
+    size_t num = conjunctions_[0].column->GetBlock(block_id)->num_tuples();
+    bmblk->Resize(num);
+    bool measured = adaptive_ && (0 == block_id % kStatsInterval);
+#pragma omp critical(pipeline_scan_order)
+    order = order_;
+
+    size_t num_input = num;
+    for(size_t i = 0; i < num_predicates; i++){
+        size_t pid = order[i];
+        ColumnBlock* block = conjunctions_[pid].column->GetBlock(block_id);
+        uint64_t start = measured? __rdtsc() : 0;
+        block->Scan(conjunctions_[pid].comparator,
+                    conjunctions_[pid].literal,
+                    bmblk,
+                    (0 == i)? Bitwise::kSet : Bitwise::kAnd);
+        if(measured){
+            uint64_t num_cycles = __rdtsc() - start;
+            size_t num_output = bmblk->CountTrue();
+#pragma omp critical(pipeline_scan_order)
+            {
+                PredicateStats &stats = stats_[pid];
+                stats.num_blocks++;
+                stats.num_tuples += num;
+                stats.num_input += num_input;
+                stats.num_output += num_output;
+                stats.num_cycles += num_cycles;
+            }
+            num_input = num_output;
+        }
+    }
+    if(measured){
+#pragma omp critical(pipeline_scan_order)
+        Reorder();
+    }
 }
 
 void PipelineScan::ExecuteBlockwise(BitVector* bitvector){
     size_t num_blocks = conjunctions_[0].column->GetNumBlocks();
 
-#pragma omp parallel for schedule(dynamic)
-    for(size_t block_id = 0; block_id < num_blocks; block_id++){
-        size_t num = conjunctions_[0].column->GetBlock(block_id)->num_tuples();
-        ByteMaskBlock* bmblk = new ByteMaskBlock(num);
-        for(size_t pid = 0; pid < conjunctions_.size(); pid++){
-            ColumnBlock* block = conjunctions_[pid].column->GetBlock(block_id);
-            block->Scan(conjunctions_[pid].comparator,
-                        conjunctions_[pid].literal,
-                        bmblk,
-                        (0 == pid)? Bitwise::kSet : Bitwise::kAnd);
+    //one byte mask block per thread, reused across blocks
+#pragma omp parallel
+    {
+        ByteMaskBlock* bmblk = new ByteMaskBlock(kNumTuplesPerBlock);
+        std::vector<size_t> order(conjunctions_.size());
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < num_blocks; block_id++){
+            ScanBlock(block_id, bmblk, order);
+            bmblk->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
+        }
+        delete bmblk;
+    }
+}
+
+size_t PipelineScan::CountBlockwise(){
+    size_t num_blocks = conjunctions_[0].column->GetNumBlocks();
+    size_t count = 0;
+
+#pragma omp parallel reduction(+: count)
+    {
+        ByteMaskBlock* bmblk = new ByteMaskBlock(kNumTuplesPerBlock);
+        std::vector<size_t> order(conjunctions_.size());
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < num_blocks; block_id++){
+            ScanBlock(block_id, bmblk, order);
+            count += bmblk->CountTrue();
         }
-        bmblk->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
         delete bmblk;
     }
+    return count;
 }
 
 void PipelineScan::ExecuteColumnwise(BitVector* bitvector){
@@ -58,6 +146,7 @@ void PipelineScan::ExecuteColumnwise(BitVector* bitvector){
     }
 
     //Condense into result
+#   pragma omp parallel for schedule(dynamic)
     for(size_t block_id = 0; block_id < num_blocks; block_id++){
         bmvector[block_id]->Condense(bitvector->GetBVBlock(block_id), Bitwise::kSet);
     }
@@ -0,0 +1,268 @@
+#include    "include/predicate_tree.h"
+#include    <omp.h>
+#include    <algorithm>
+
+namespace byteslice{
+
+static constexpr size_t kPrefetchDistance = 512*2;
+
+constexpr size_t PredicateTree::kNumUnits;
+constexpr size_t PredicateTree::kMaxNumBytes;
+
+size_t PredicateTree::AddPredicate(BytewiseAtomPredicate predicate){
+    assert(predicate.column->type() == ColumnType::kByteSlicePadRight);
+    //align the literal to the byte slices (padded right)
+    WordUnit literal = predicate.literal << (8 * predicate.num_bytes - predicate.column->bit_width());
+    std::vector<ByteUnit> bytes;
+    for(size_t byte_id = 0; byte_id < predicate.num_bytes; byte_id++){
+        bytes.push_back(FLIP(static_cast<ByteUnit>(
+                        literal >> 8*(predicate.num_bytes - 1 - byte_id))));
+    }
+    predicates_.push_back(predicate);
+    literal_bytes_.push_back(bytes);
+    return AddNode(PredicateNodeType::kPredicate, std::vector<size_t>(), predicates_.size() - 1);
+}
+
+size_t PredicateTree::AddAnd(const std::vector<size_t> &children){
+    return AddNode(PredicateNodeType::kAnd, children);
+}
+
+size_t PredicateTree::AddOr(const std::vector<size_t> &children){
+    return AddNode(PredicateNodeType::kOr, children);
+}
+
+size_t PredicateTree::AddNot(size_t child){
+    return AddNode(PredicateNodeType::kNot, std::vector<size_t>(1, child));
+}
+
+size_t PredicateTree::AddNode(PredicateNodeType type, const std::vector<size_t> &children,
+        size_t predicate_id){
+    assert(PredicateNodeType::kPredicate == type || !children.empty());
+    for(size_t child : children){
+        assert(child < nodes_.size());
+        (void) child;
+    }
+    Node node;
+    node.type = type;
+    node.predicate_id = predicate_id;
+    node.children = children;
+    nodes_.push_back(node);
+    root_ = nodes_.size() - 1;
+    return root_;
+}
+
+void PredicateTree::SetRoot(size_t node_id){
+    assert(node_id < nodes_.size());
+    root_ = node_id;
+}
+
+void PredicateTree::Scan(BitVector* bitvector) const{
+    assert(!nodes_.empty());
+    const size_t num_blocks = predicates_[0].column->GetNumBlocks();
+    assert(num_blocks == bitvector->GetNumBlocks());
+
+#pragma omp parallel
+    {
+        //per thread: the byte slices and zone map match of every predicate
+        std::vector<const ByteUnit*> slices(kMaxNumBytes * predicates_.size());
+        std::vector<ZoneMatch> matches(predicates_.size());
+        AvxUnit all[kNumUnits];
+        std::fill(all, all + kNumUnits, avx_ones());
+
+#pragma omp for schedule(dynamic)
+        for(size_t block_id = 0; block_id < num_blocks; block_id++){
+            BitVectorBlock* bvblk = bitvector->GetBVBlock(block_id);
+            for(size_t p = 0; p < predicates_.size(); p++){
+                const BytewiseAtomPredicate &predicate = predicates_[p];
+                const ColumnBlock* block = predicate.column->GetBlock(block_id);
+                for(size_t byte_id = 0; byte_id < predicate.num_bytes; byte_id++){
+                    slices[kMaxNumBytes * p + byte_id] = block->GetByteSlice(byte_id);
+                }
+                matches[p] = block->zone_map().Match(predicate.comparator, predicate.literal);
+            }
+
+            //For every kNumUnits AVX units of tuples
+            AvxUnit result[kNumUnits];
+            for(size_t offset = 0; offset < bvblk->num(); offset += kNumUnits * kNumAvxBits / 8){
+                Evaluate(root_, offset, all, slices.data(), matches.data(), result);
+                for(size_t u = 0; u < kNumUnits; u += 2){
+                    WordUnit word = static_cast<uint32_t>(_mm256_movemask_epi8(result[u]))
+                        | (static_cast<WordUnit>(static_cast<uint32_t>(
+                                        _mm256_movemask_epi8(result[u + 1]))) << 32);
+                    bvblk->SetWordUnit(word, offset / kNumWordBits + u / 2);
+                }
+            }
+            bvblk->ClearTail();
+        }
+    }
+}
+
+void PredicateTree::Evaluate(size_t node_id, size_t offset, const AvxUnit relevant[],
+        const ByteUnit* const slices[], const ZoneMatch matches[], AvxUnit result[]) const{
+    const Node &node = nodes_[node_id];
+    AvxUnit m_relevant[kNumUnits];
+    AvxUnit m_child[kNumUnits];
+    switch(node.type){
+        case PredicateNodeType::kPredicate:
+            switch(matches[node.predicate_id]){
+                case ZoneMatch::kNone:
+                    std::fill(result, result + kNumUnits, avx_zero());
+                    return;
+                case ZoneMatch::kAll:
+                    std::fill(result, result + kNumUnits, avx_ones());
+                    return;
+                case ZoneMatch::kSome:
+                    break;
+            }
+            return EvaluatePredicate(node.predicate_id, offset, relevant,
+                    slices + kMaxNumBytes * node.predicate_id, result);
+        case PredicateNodeType::kAnd:{
+            //tuples already false are decided
+            Evaluate(node.children[0], offset, relevant, slices, matches, result);
+            AvxUnit m_any = avx_zero();
+            for(size_t u = 0; u < kNumUnits; u++){
+                m_relevant[u] = avx_and(relevant[u], result[u]);
+                m_any = avx_or(m_any, m_relevant[u]);
+            }
+            for(size_t i = 1; i < node.children.size() && !avx_iszero(m_any); i++){
+                Evaluate(node.children[i], offset, m_relevant, slices, matches, m_child);
+                m_any = avx_zero();
+                for(size_t u = 0; u < kNumUnits; u++){
+                    result[u] = avx_and(result[u], m_child[u]);
+                    m_relevant[u] = avx_and(m_relevant[u], m_child[u]);
+                    m_any = avx_or(m_any, m_relevant[u]);
+                }
+            }
+            return;
+        }
+        case PredicateNodeType::kOr:{
+            //tuples already true are decided
+            Evaluate(node.children[0], offset, relevant, slices, matches, result);
+            AvxUnit m_any = avx_zero();
+            for(size_t u = 0; u < kNumUnits; u++){
+                m_relevant[u] = avx_andnot(result[u], relevant[u]);
+                m_any = avx_or(m_any, m_relevant[u]);
+            }
+            for(size_t i = 1; i < node.children.size() && !avx_iszero(m_any); i++){
+                Evaluate(node.children[i], offset, m_relevant, slices, matches, m_child);
+                m_any = avx_zero();
+                for(size_t u = 0; u < kNumUnits; u++){
+                    result[u] = avx_or(result[u], m_child[u]);
+                    m_relevant[u] = avx_andnot(m_child[u], m_relevant[u]);
+                    m_any = avx_or(m_any, m_relevant[u]);
+                }
+            }
+            return;
+        }
+        case PredicateNodeType::kNot:
+            Evaluate(node.children[0], offset, relevant, slices, matches, result);
+            for(size_t u = 0; u < kNumUnits; u++){
+                result[u] = avx_not(result[u]);
+            }
+            return;
+    }
+}
+
+/**
+  The atom predicate over NUM_UNITS AVX units of tuples. The first byte is
+  scanned over all units, then every next byte only over the units that
+  still have a relevant tuple equal to the literal so far.
+*/
+template <Comparator CMP, size_t NUM_UNITS, size_t MAX_NUM_BYTES>
+static inline void ScanSlices(const ByteUnit* const slices[], const std::vector<ByteUnit> &bytes,
+        size_t offset, const AvxUnit relevant[], AvxUnit result[]){
+    constexpr bool kLessType = (Comparator::kLess == CMP || Comparator::kLessEqual == CMP);
+    constexpr bool kGreaterType = (Comparator::kGreater == CMP || Comparator::kGreaterEqual == CMP);
+    static_assert(NUM_UNITS <= 32, "one bit of undecided per unit");
+    assert(bytes.size() <= MAX_NUM_BYTES);
+    AvxUnit m_order[NUM_UNITS];
+    AvxUnit m_equal[NUM_UNITS];
+
+    const ByteUnit* data = slices[0] + offset;
+    AvxUnit avx_lit = avx_set1<ByteUnit>(bytes[0]);
+    //bit u: unit u still has a relevant tuple equal to the literal
+    uint32_t undecided = 0;
+    //the second byte is read sparsely, but for most groups: prefetch it
+    //with the first. Later bytes are rarely read.
+    for(size_t byte_id = 0; byte_id < std::min<size_t>(2, bytes.size()); byte_id++){
+        for(size_t line = 0; line < 32 * NUM_UNITS; line += 64){
+            __builtin_prefetch(slices[byte_id] + offset + line + kPrefetchDistance);
+        }
+    }
+    for(size_t u = 0; u < NUM_UNITS; u++){
+        AvxUnit avx_data = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(data + 32 * u));
+        if(kLessType){
+            m_order[u] = avx_cmplt<ByteUnit>(avx_data, avx_lit);
+        }
+        if(kGreaterType){
+            m_order[u] = avx_cmpgt<ByteUnit>(avx_data, avx_lit);
+        }
+        m_equal[u] = avx_cmpeq<ByteUnit>(avx_data, avx_lit);
+        undecided |= static_cast<uint32_t>(!avx_iszero(avx_and(m_equal[u], relevant[u]))) << u;
+    }
+    for(size_t byte_id = 1; byte_id < bytes.size() && 0 != undecided; byte_id++){
+        data = slices[byte_id] + offset;
+        avx_lit = avx_set1<ByteUnit>(bytes[byte_id]);
+        for(uint32_t units = undecided; 0 != units; units &= units - 1){
+            size_t u = __builtin_ctz(units);
+            AvxUnit avx_data = _mm256_lddqu_si256(reinterpret_cast<const __m256i*>(data + 32 * u));
+            if(kLessType){
+                m_order[u] = avx_or(m_order[u],
+                        avx_and(m_equal[u], avx_cmplt<ByteUnit>(avx_data, avx_lit)));
+            }
+            if(kGreaterType){
+                m_order[u] = avx_or(m_order[u],
+                        avx_and(m_equal[u], avx_cmpgt<ByteUnit>(avx_data, avx_lit)));
+            }
+            m_equal[u] = avx_and(m_equal[u], avx_cmpeq<ByteUnit>(avx_data, avx_lit));
+            undecided &= ~(static_cast<uint32_t>(
+                        avx_iszero(avx_and(m_equal[u], relevant[u]))) << u);
+        }
+    }
+
+    for(size_t u = 0; u < NUM_UNITS; u++){
+        switch(CMP){
+            case Comparator::kLessEqual:
+            case Comparator::kGreaterEqual:
+                result[u] = avx_or(m_order[u], m_equal[u]);
+                break;
+            case Comparator::kLess:
+            case Comparator::kGreater:
+                result[u] = m_order[u];
+                break;
+            case Comparator::kEqual:
+                result[u] = m_equal[u];
+                break;
+            case Comparator::kInequal:
+                result[u] = avx_not(m_equal[u]);
+                break;
+        }
+    }
+}
+
+void PredicateTree::EvaluatePredicate(size_t predicate_id, size_t offset,
+        const AvxUnit relevant[], const ByteUnit* const slices[], AvxUnit result[]) const{
+    const std::vector<ByteUnit> &bytes = literal_bytes_[predicate_id];
+    switch(predicates_[predicate_id].comparator){
+        case Comparator::kLess:
+            return ScanSlices<Comparator::kLess, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+        case Comparator::kLessEqual:
+            return ScanSlices<Comparator::kLessEqual, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+        case Comparator::kGreater:
+            return ScanSlices<Comparator::kGreater, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+        case Comparator::kGreaterEqual:
+            return ScanSlices<Comparator::kGreaterEqual, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+        case Comparator::kEqual:
+            return ScanSlices<Comparator::kEqual, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+        case Comparator::kInequal:
+            return ScanSlices<Comparator::kInequal, kNumUnits, kMaxNumBytes>(
+                    slices, bytes, offset, relevant, result);
+    }
+}
+
+}   //namespace
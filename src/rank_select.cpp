@@ -0,0 +1,156 @@
+#include    "include/rank_select.h"
+#include    <algorithm>
+#include    <omp.h>
+
+namespace byteslice{
+
+constexpr size_t RankSelect::kNumWordsPerLine;
+constexpr size_t RankSelect::kNumBitsPerLine;
+constexpr size_t RankSelect::kSampleRate;
+
+//The index of the r-th 1 of word, counted from 0
+static inline size_t SelectInWord(WordUnit word, size_t r){
+#ifdef __BMI2__
+    return __builtin_ctzll(_pdep_u64(1ULL << r, word));
+#else
+    for(size_t i = 0; i < r; i++){
+        word &= word - 1;
+    }
+    return __builtin_ctzll(word);
+#endif
+}
+
+RankSelect::RankSelect(const BitVector* bitvector):
+    bitvector_(bitvector){
+    Build();
+}
+
+void RankSelect::Build(){
+    const size_t num_blocks = bitvector_->GetNumBlocks();
+    block_ranks_.assign(num_blocks + 1, 0);
+    line_ranks_.resize(num_blocks);
+    samples_.resize(num_blocks);
+#pragma omp parallel for schedule(dynamic)
+    for(size_t block_id = 0; block_id < num_blocks; block_id++){
+        block_ranks_[block_id + 1] = BuildBlock(block_id);
+    }
+    for(size_t block_id = 0; block_id < num_blocks; block_id++){
+        block_ranks_[block_id + 1] += block_ranks_[block_id];
+    }
+}
+
+size_t RankSelect::BuildBlock(size_t block_id){
+    const BitVectorBlock* bvblock = bitvector_->GetBVBlock(block_id);
+    const size_t num_words = bvblock->num_word_units();
+    std::vector<uint32_t> &line_ranks = line_ranks_[block_id];
+    std::vector<uint32_t> &samples = samples_[block_id];
+    line_ranks.resize(CEIL(num_words, kNumWordsPerLine));
+    samples.clear();
+    size_t count = 0;
+    for(size_t line = 0; line < line_ranks.size(); line++){
+        line_ranks[line] = count;
+        const size_t end = std::min(num_words, (line + 1) * kNumWordsPerLine);
+        for(size_t word_id = line * kNumWordsPerLine; word_id < end; word_id++){
+            count += POPCNT64(bvblock->GetWordUnit(word_id));
+        }
+        //the line holds the (samples.size() * kSampleRate)-th 1
+        while(samples.size() * kSampleRate < count){
+            samples.push_back(line);
+        }
+    }
+    return count;
+}
+
+size_t RankSelect::Rank(size_t pos) const{
+    assert(pos <= num());
+    if(num() == pos){
+        return CountOnes();
+    }
+    const size_t block_id = pos / kNumTuplesPerBlock;
+    const size_t offset = pos % kNumTuplesPerBlock;
+    const size_t line = offset / kNumBitsPerLine;
+    const BitVectorBlock* bvblock = bitvector_->GetBVBlock(block_id);
+    size_t rank = block_ranks_[block_id] + line_ranks_[block_id][line];
+    const size_t last_word_id = offset / kNumWordBits;
+    for(size_t word_id = line * kNumWordsPerLine; word_id < last_word_id; word_id++){
+        rank += POPCNT64(bvblock->GetWordUnit(word_id));
+    }
+    const size_t num_bits = offset % kNumWordBits;
+    if(0 != num_bits){
+        rank += POPCNT64(bvblock->GetWordUnit(last_word_id) & ((1ULL << num_bits) - 1));
+    }
+    return rank;
+}
+
+size_t RankSelect::Select(size_t k) const{
+    if(k >= CountOnes()){
+        return num();
+    }
+    //the last block starting at or before the k-th 1
+    const size_t block_id = std::upper_bound(block_ranks_.begin(), block_ranks_.end(), k)
+        - block_ranks_.begin() - 1;
+    size_t rank = k - block_ranks_[block_id];
+
+    //the line is between the samples around rank
+    const std::vector<uint32_t> &line_ranks = line_ranks_[block_id];
+    const std::vector<uint32_t> &samples = samples_[block_id];
+    const size_t sample_id = rank / kSampleRate;
+    const size_t lo = samples[sample_id];
+    const size_t hi = (sample_id + 1 < samples.size())? samples[sample_id + 1] + 1 : line_ranks.size();
+    const size_t line = std::upper_bound(line_ranks.begin() + lo, line_ranks.begin() + hi, rank)
+        - line_ranks.begin() - 1;
+    rank -= line_ranks[line];
+
+    const BitVectorBlock* bvblock = bitvector_->GetBVBlock(block_id);
+    for(size_t word_id = line * kNumWordsPerLine; ; word_id++){
+        WordUnit word = bvblock->GetWordUnit(word_id);
+        size_t count = POPCNT64(word);
+        if(rank < count){
+            return block_id * kNumTuplesPerBlock + word_id * kNumWordBits + SelectInWord(word, rank);
+        }
+        rank -= count;
+    }
+}
+
+size_t RankSelect::SelectRange(size_t first, size_t n, TupleId* positions) const{
+    if(first >= CountOnes() || 0 == n){
+        return 0;
+    }
+    //from the first-th 1 on, word by word
+    const size_t pos = Select(first);
+    size_t block_id = pos / kNumTuplesPerBlock;
+    size_t word_id = pos % kNumTuplesPerBlock / kNumWordBits;
+    const BitVectorBlock* bvblock = bitvector_->GetBVBlock(block_id);
+    WordUnit word = bvblock->GetWordUnit(word_id) & (~0ULL << (pos % kNumWordBits));
+    size_t count = 0;
+    while(true){
+        while(0 != word && count < n){
+            positions[count++] = block_id * kNumTuplesPerBlock + word_id * kNumWordBits
+                + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+        if(count == n){
+            break;
+        }
+        if(++word_id == bvblock->num_word_units()){
+            if(++block_id == bitvector_->GetNumBlocks()){
+                break;
+            }
+            bvblock = bitvector_->GetBVBlock(block_id);
+            word_id = 0;
+        }
+        word = bvblock->GetWordUnit(word_id);
+    }
+    return count;
+}
+
+size_t RankSelect::GetNumBytes() const{
+    size_t num_bytes = block_ranks_.capacity() * sizeof(size_t);
+    for(size_t block_id = 0; block_id < line_ranks_.size(); block_id++){
+        num_bytes += line_ranks_[block_id].capacity() * sizeof(uint32_t)
+            + samples_[block_id].capacity() * sizeof(uint32_t);
+    }
+    return num_bytes;
+}
+
+}   //namespace
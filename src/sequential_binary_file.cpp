@@ -2,6 +2,7 @@
 
 #include    <iostream>
 #include    <cassert>
+#include    <sys/stat.h>
 
 namespace byteslice{
 
@@ -40,6 +41,23 @@ size_t SequentialReadBinaryFile::Read(void* buf, size_t size) const{
     return count;
 }
 
+bool SequentialReadBinaryFile::Seek(size_t offset) const{
+    return 0 == fseeko(file_, static_cast<off_t>(offset), SEEK_SET);
+}
+
+size_t SequentialReadBinaryFile::Tell() const{
+    return static_cast<size_t>(ftello(file_));
+}
+
+size_t SequentialReadBinaryFile::Size() const{
+    struct stat st;
+    if(0 != fstat(fileno(file_), &st)){
+        std::cerr << "Can't stat file: " << filename_ << std::endl;
+        return 0;
+    }
+    return static_cast<size_t>(st.st_size);
+}
+
 
 bool SequentialWriteBinaryFile::Open(const std::string filename){
     if(NULL != file_){
@@ -72,6 +90,10 @@ size_t SequentialWriteBinaryFile::Append(const void* data, size_t size){
     return count;
 }
 
+size_t SequentialWriteBinaryFile::Tell() const{
+    return static_cast<size_t>(ftello(file_));
+}
+
 bool SequentialWriteBinaryFile::Flush(){
     if(0 != fflush(file_)){
         return false;
@@ -2,6 +2,8 @@
 #include    <cstdlib>
 #include    <cstring>
 #include    <include/avx-utility.h>
+#include    "include/buffer_pool.h"
+#include    "include/range_scan.h"
 
 namespace byteslice{
     
@@ -22,42 +24,49 @@ Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Superscalar2ByteSliceCo
     //allocate memory space
     assert(num <= kNumTuplesPerBlock);
     for(size_t i=0; i < kNumBytesPerCode; i++){
-        size_t ret = posix_memalign((void**)&data_[i], 32, kMemSizePerSuperscalar2ByteSlice);                    
-        ret = ret;
+        data_[i] = static_cast<ByteUnit*>(BufferPool::Allocate(kMemSizePerSuperscalar2ByteSlice));
         memset(data_[i], 0x0, kMemSizePerSuperscalar2ByteSlice);
     }
 
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::~Superscalar2ByteSliceColumnBlock(){
     for(size_t i=0; i < kNumBytesPerCode; i++){
-        free(data_[i]);
+        BufferPool::Release(data_[i], kMemSizePerSuperscalar2ByteSlice);
     }
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 bool Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     SerToFile(SequentialWriteBinaryFile &file) const{
-    file.Append(&num_tuples_, sizeof(num_tuples_));
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
     for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
-        file.Append(data_[byte_id], kMemSizePerSuperscalar2ByteSlice);
+        success = success
+                && kMemSizePerSuperscalar2ByteSlice == file.Append(data_[byte_id], kMemSizePerSuperscalar2ByteSlice);
     }
+    return success;
 }
 
 template <size_t BIT_WIDTH, Direction PDIRECTION>
-void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
+bool Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::
                     DeserFromFile(const SequentialReadBinaryFile &file){
-    file.Read(&num_tuples_, sizeof(num_tuples_));
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
     for(size_t byte_id = 0; byte_id < kNumBytesPerCode; byte_id++){
-        file.Read(data_[byte_id], kMemSizePerSuperscalar2ByteSlice);
+        success = success
+                && kMemSizePerSuperscalar2ByteSlice == file.Read(data_[byte_id], kMemSizePerSuperscalar2ByteSlice);
     }
+    return success;
 }
 
 //Scan that takes in and output ByteMask
@@ -232,6 +241,16 @@ void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::Scan(Comparator co
     }
 }
 
+//Range scan: both bounds in one pass
+template <size_t BIT_WIDTH, Direction PDIRECTION>
+void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanBetween(WordUnit lo, WordUnit hi,
+        BitVectorBlock* bvblock, Bitwise bit_opt) const{
+    assert(bvblock->num() == num_tuples_);
+    const size_t padding = (Direction::kRight == PDIRECTION)? kNumPaddingBits : 0;
+    ScanBetweenSlices<ByteUnit, kNumBytesPerCode, 2>(data_, num_tuples_, BIT_WIDTH, padding,
+            lo, hi, zone_map_, bvblock, bit_opt);
+}
+
 template <size_t BIT_WIDTH, Direction PDIRECTION>
 template <Comparator CMP>
 void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::ScanHelper1(WordUnit literal,
@@ -822,6 +841,7 @@ void Superscalar2ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>::BulkLoadArray(cons
     for(size_t i = 0; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 
@@ -0,0 +1,268 @@
+#include    "table.h"
+#include    <iostream>
+#include    <fstream>
+#include    <cstdio>
+#include    <cctype>
+#include    <sys/stat.h>
+
+namespace byteslice{
+
+/**
+  Catalog file of a table directory, in text format:
+  first line: <#tuples> <#columns>
+  followed by one line per column: <name> <page policy>.
+  Column <name> is stored in <name>.col next to the catalog.
+*/
+static const std::string kCatalogFileName = "CATALOG";
+static const std::string kColumnFileSuffix = ".col";
+//files are written under a temporary name and renamed into place
+static const std::string kTempFileSuffix = ".tmp";
+
+//A column name is stored in the catalog and names its column file
+static bool ValidColumnName(const std::string &name){
+    if(name.empty()){
+        return false;
+    }
+    for(char c : name){
+        if('/' == c || std::isspace(static_cast<unsigned char>(c))){
+            return false;
+        }
+    }
+    return true;
+}
+
+Table::Table(size_t num):
+    num_tuples_(num){
+}
+
+Table::~Table(){
+    Destroy();
+}
+
+void Table::Destroy(){
+    for(auto &entry : map_){
+        delete entry.second;
+    }
+    map_.clear();
+}
+
+bool Table::Open(std::string path, Option option){
+    path_ = path;
+    struct stat st;
+    if(0 != stat(path_.c_str(), &st)){
+        if(!option.create_if_missing){
+            std::cerr << "Table does not exist: " << path_ << std::endl;
+            return false;
+        }
+        if(0 != mkdir(path_.c_str(), 0755)){
+            std::cerr << "Can't create table directory: " << path_ << std::endl;
+            return false;
+        }
+        Destroy();
+        num_tuples_ = 0;
+        return true;
+    }
+    if(!S_ISDIR(st.st_mode)){
+        std::cerr << "Not a directory: " << path_ << std::endl;
+        return false;
+    }
+
+    std::ifstream catalog(path_ + "/" + kCatalogFileName, std::ifstream::in);
+    if(!catalog.good()){
+        if(option.create_if_missing){   //empty directory
+            Destroy();
+            num_tuples_ = 0;
+            return true;
+        }
+        std::cerr << "Can't open table catalog in: " << path_ << std::endl;
+        return false;
+    }
+    size_t num_tuples, num_columns;
+    std::vector<std::string> names;
+    std::vector<PagePolicy> policies;
+    if(!(catalog >> num_tuples >> num_columns)){
+        std::cerr << "Corrupted table catalog in: " << path_ << std::endl;
+        return false;
+    }
+    for(size_t i=0; i < num_columns; i++){
+        std::string name;
+        uint32_t policy;
+        if(!(catalog >> name >> policy) || static_cast<uint32_t>(PagePolicy::kHugeTlb) < policy){
+            std::cerr << "Corrupted table catalog in: " << path_ << std::endl;
+            return false;
+        }
+        names.push_back(name);
+        policies.push_back(static_cast<PagePolicy>(policy));
+    }
+    catalog.close();
+
+    Destroy();
+    num_tuples_ = num_tuples;
+    for(size_t i=0; i < names.size(); i++){
+        const std::string &name = names[i];
+        std::string filepath = path_ + "/" + name + kColumnFileSuffix;
+        Column* column = new Column();
+        bool success;
+        if(option.in_memory){
+            SequentialReadBinaryFile infile;
+            success = infile.Open(filepath) && column->DeserFromFile(infile);
+            infile.Close();
+        }
+        else{
+            success = column->MapBinaryFile(filepath);
+        }
+        //the column file records the policy too: both must agree
+        success = success && policies[i] == column->page_policy();
+        if(!success || !AddColumn(name, column)){
+            std::cerr << "Failed to load column: " << name << std::endl;
+            delete column;
+            Destroy();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Table::Persist() const{
+    return Persist(path_);
+}
+
+bool Table::Persist(std::string path) const{
+    struct stat st;
+    if(0 != stat(path.c_str(), &st) && 0 != mkdir(path.c_str(), 0755)){
+        std::cerr << "Can't create table directory: " << path << std::endl;
+        return false;
+    }
+
+    //write every file aside, so that a failed persist leaves the table as it was
+    for(const auto &entry : map_){
+        std::string filepath = path + "/" + entry.first + kColumnFileSuffix + kTempFileSuffix;
+        SequentialWriteBinaryFile outfile;
+        if(!outfile.Open(filepath)){
+            return false;
+        }
+        bool success = entry.second->SerToFile(outfile);
+        outfile.Close();
+        if(!success){
+            std::cerr << "Failed to persist column: " << entry.first << std::endl;
+            std::remove(filepath.c_str());
+            return false;
+        }
+    }
+    std::string catalog_path = path + "/" + kCatalogFileName;
+    std::ofstream catalog(catalog_path + kTempFileSuffix, std::ofstream::out);
+    catalog << num_tuples_ << " " << map_.size() << std::endl;
+    for(const auto &entry : map_){
+        catalog << entry.first << " "
+            << static_cast<uint32_t>(entry.second->page_policy()) << std::endl;
+    }
+    catalog.close();
+    if(!catalog){
+        std::cerr << "Can't write table catalog in: " << path << std::endl;
+        return false;
+    }
+
+    //the old catalog goes first and the new one comes last:
+    //a persist interrupted in between leaves a table that can't be opened,
+    //rather than one mixing old and new columns
+    if(0 != std::remove(catalog_path.c_str()) && 0 == stat(catalog_path.c_str(), &st)){
+        std::cerr << "Can't replace table catalog in: " << path << std::endl;
+        return false;
+    }
+    for(const auto &entry : map_){
+        std::string filepath = path + "/" + entry.first + kColumnFileSuffix;
+        if(0 != std::rename((filepath + kTempFileSuffix).c_str(), filepath.c_str())){
+            std::cerr << "Failed to persist column: " << entry.first << std::endl;
+            return false;
+        }
+    }
+    if(0 != std::rename((catalog_path + kTempFileSuffix).c_str(), catalog_path.c_str())){
+        std::cerr << "Can't write table catalog in: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Column* Table::CreateColumn(std::string name, ColumnType type, size_t bit_width,
+        PagePolicy policy){
+    if(!ValidColumnName(name)){
+        std::cerr << "Invalid column name: \"" << name << "\"" << std::endl;
+        return NULL;
+    }
+    if(HasColumn(name)){
+        std::cerr << "Column already exists: " << name << std::endl;
+        return NULL;
+    }
+    Column* column = new Column(type, bit_width, num_tuples_, policy);
+    map_[name] = column;
+    return column;
+}
+
+bool Table::AddColumn(std::string name, Column* column){
+    if(!ValidColumnName(name)){
+        std::cerr << "Invalid column name: \"" << name << "\"" << std::endl;
+        return false;
+    }
+    if(HasColumn(name)){
+        std::cerr << "Column already exists: " << name << std::endl;
+        return false;
+    }
+    if(column->num_tuples() != num_tuples_){
+        std::cerr << "Column " << name << " has " << column->num_tuples()
+            << " tuples, table has " << num_tuples_ << std::endl;
+        return false;
+    }
+    map_[name] = column;
+    return true;
+}
+
+bool Table::DropColumn(std::string name){
+    auto it = map_.find(name);
+    if(map_.end() == it){
+        std::cerr << "No such column: " << name << std::endl;
+        return false;
+    }
+    delete it->second;
+    map_.erase(it);
+    return true;
+}
+
+Column* Table::GetColumn(std::string name) const{
+    auto it = map_.find(name);
+    return (map_.end() == it)? NULL : it->second;
+}
+
+bool Table::HasColumn(std::string name) const{
+    return map_.end() != map_.find(name);
+}
+
+std::vector<std::string> Table::GetColumnNames() const{
+    std::vector<std::string> names;
+    for(const auto &entry : map_){
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+void Table::Resize(size_t num){
+    num_tuples_ = num;
+    for(auto &entry : map_){
+        entry.second->Resize(num);
+    }
+}
+
+size_t Table::LoadCsvFile(std::string filepath, const std::vector<std::string> &names,
+        char delimiter){
+    std::vector<Column*> columns;
+    for(const std::string &name : names){
+        Column* column = GetColumn(name);
+        if(NULL == column){
+            std::cerr << "No such column: " << name << std::endl;
+            return 0;
+        }
+        columns.push_back(column);
+    }
+    return Column::LoadCsvFile(filepath, columns, delimiter);
+}
+
+}   //namespace
@@ -87,4 +87,20 @@ std::ostream& operator<< (std::ostream &out, Comparator comp){
 }
 
 
+//for debug purpose
+std::ostream& operator<< (std::ostream &out, PagePolicy policy){
+    switch(policy){
+        case PagePolicy::kDefault:
+            out << "Default";
+            break;
+        case PagePolicy::kTransparentHugePage:
+            out << "TransparentHugePage";
+            break;
+        case PagePolicy::kHugeTlb:
+            out << "HugeTlb";
+            break;
+    }
+    return out;
+}
+
 }   //namespace
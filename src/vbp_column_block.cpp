@@ -3,6 +3,8 @@
 #include    <cstring>
 #include    <algorithm>
 #include    "include/avx-utility.h"
+#include    "include/bit_transpose.h"
+#include    "include/buffer_pool.h"
 
 namespace byteslice{
 
@@ -21,32 +23,48 @@ VbpColumnBlock<BIT_WIDTH>::VbpColumnBlock(size_t num):
     for(size_t gid = 0; gid < kNumBitGroups; gid++){
         size_t size = 
             sizeof(AvxUnit) * bitgroup_helper_[gid] * CEIL(kNumTuplesPerBlock, kNumAvxBits);
-        size_t ret =
-            posix_memalign((void**)&data_[gid], 32, size);
-        ret = ret;
+        data_[gid] = static_cast<WordUnit*>(BufferPool::Allocate(size));
         memset(data_[gid], 0x0, size);
     }
+
+    InitZoneMap();
 }
 
 template <size_t BIT_WIDTH>
 VbpColumnBlock<BIT_WIDTH>::~VbpColumnBlock(){
     for(size_t gid = 0; gid < kNumBitGroups; gid++){
-        free(data_[gid]);
+        BufferPool::Release(data_[gid],
+                sizeof(AvxUnit) * bitgroup_helper_[gid] * CEIL(kNumTuplesPerBlock, kNumAvxBits));
     }
 }
 
 template <size_t BIT_WIDTH>
 bool VbpColumnBlock<BIT_WIDTH>::Resize(size_t num){
+    size_t old_num = num_tuples_;
     num_tuples_ = num;
+    ResizeZoneMap(old_num);
     return true;
 }
 
 template <size_t BIT_WIDTH>
-void VbpColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
+bool VbpColumnBlock<BIT_WIDTH>::SerToFile(SequentialWriteBinaryFile &file) const{
+    bool success = sizeof(num_tuples_) == file.Append(&num_tuples_, sizeof(num_tuples_));
+    for(size_t gid = 0; gid < kNumBitGroups; gid++){
+        size_t size = sizeof(AvxUnit) * bitgroup_helper_[gid] * CEIL(kNumTuplesPerBlock, kNumAvxBits);
+        success = success && size == file.Append(data_[gid], size);
+    }
+    return success;
 }
 
 template <size_t BIT_WIDTH>
-void VbpColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
+bool VbpColumnBlock<BIT_WIDTH>::DeserFromFile(const SequentialReadBinaryFile &file){
+    bool success = sizeof(num_tuples_) == file.Read(&num_tuples_, sizeof(num_tuples_));
+    success = success && num_tuples_ <= kNumTuplesPerBlock;
+    for(size_t gid = 0; gid < kNumBitGroups; gid++){
+        size_t size = sizeof(AvxUnit) * bitgroup_helper_[gid] * CEIL(kNumTuplesPerBlock, kNumAvxBits);
+        success = success && size == file.Read(data_[gid], size);
+    }
+    return success;
 }
 
 //Scan against literal
@@ -331,9 +349,31 @@ template <size_t BIT_WIDTH>
 void VbpColumnBlock<BIT_WIDTH>::BulkLoadArray(const WordUnit* codes,
         size_t num, size_t start_pos){
     assert(start_pos + num <= num_tuples_);
-    for(size_t i = 0; i < num; i++){
+    constexpr size_t stride = sizeof(AvxUnit) / sizeof(WordUnit);
+    size_t i = 0;
+    //head: up to the next segment boundary
+    for(; i < num && 0 != (start_pos + i) % kNumAvxBits; i++){
+        SetTuple(start_pos+i, codes[i]);
+    }
+    //whole segments: each bit of the segment is one AVX word in its group
+    AvxUnit slices[64];
+    for(; i + kNumAvxBits <= num; i += kNumAvxBits){
+        TransposeBits256(codes + i, slices);
+        size_t segment_id = (start_pos + i) / kNumAvxBits;
+        for(size_t gid = 0; gid < kNumBitGroups; gid++){
+            WordUnit* base = data_[gid] + segment_id * bitgroup_helper_[gid] * stride;
+            for(size_t j = 0; j < bitgroup_helper_[gid]; j++){
+                size_t bit_id = gid * kNumBitsPerGroup + j;
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(base + j * stride),
+                        slices[BIT_WIDTH - 1 - bit_id]);
+            }
+        }
+    }
+    //tail
+    for(; i < num; i++){
         SetTuple(start_pos+i, codes[i]);
     }
+    zone_map_.Update(codes, num, start_pos, num_tuples_);
 }
 
 //explict specialization
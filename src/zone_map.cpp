@@ -0,0 +1,182 @@
+#include    "include/zone_map.h"
+#include    <algorithm>
+#include    <limits>
+
+namespace byteslice{
+
+constexpr size_t ZoneMap::kNumTuplesPerZone;
+constexpr size_t ZoneMap::kNumZones;
+constexpr size_t ZoneMap::kNumWordsPerZone;
+
+static constexpr uint32_t kEmptyMin = std::numeric_limits<uint32_t>::max();
+static constexpr uint32_t kEmptyMax = 0;
+
+ZoneMap::ZoneMap(size_t bit_width):
+    code_mask_((1ULL << bit_width) - 1){
+    Clear();
+}
+
+void ZoneMap::Clear(){
+    min_ = kEmptyMin;
+    max_ = kEmptyMax;
+    std::fill(mins_, mins_ + kNumZones, kEmptyMin);
+    std::fill(maxs_, maxs_ + kNumZones, kEmptyMax);
+}
+
+void ZoneMap::Update(const WordUnit* codes, size_t num, size_t start_pos,
+        size_t num_tuples){
+    assert(start_pos + num <= num_tuples && num_tuples <= kNumTuplesPerBlock);
+    const size_t end_pos = start_pos + num;
+    for(size_t zone_begin = start_pos; zone_begin < end_pos; ){
+        size_t zone_id = zone_begin / kNumTuplesPerZone;
+        size_t zone_end = std::min(end_pos, (zone_id + 1) * kNumTuplesPerZone);
+        uint32_t zone_min = kEmptyMin;
+        uint32_t zone_max = kEmptyMax;
+        for(size_t i = zone_begin - start_pos; i < zone_end - start_pos; i++){
+            uint32_t code = static_cast<uint32_t>(codes[i] & code_mask_);
+            zone_min = std::min(zone_min, code);
+            zone_max = std::max(zone_max, code);
+        }
+        if(zone_begin == zone_id * kNumTuplesPerZone
+                && zone_end == std::min(num_tuples, (zone_id + 1) * kNumTuplesPerZone)){
+            //every tuple of the zone was overwritten
+            mins_[zone_id] = zone_min;
+            maxs_[zone_id] = zone_max;
+        }
+        else{
+            mins_[zone_id] = std::min(mins_[zone_id], zone_min);
+            maxs_[zone_id] = std::max(maxs_[zone_id], zone_max);
+        }
+        zone_begin = zone_end;
+    }
+
+    //zones may have shrunk: recompute the block summary
+    min_ = *std::min_element(mins_, mins_ + kNumZones);
+    max_ = *std::max_element(maxs_, maxs_ + kNumZones);
+}
+
+void ZoneMap::Widen(size_t begin, size_t end, WordUnit value){
+    assert(end <= kNumTuplesPerBlock);
+    if(begin >= end){
+        return;
+    }
+    uint32_t code = static_cast<uint32_t>(value & code_mask_);
+    for(size_t zone_id = begin / kNumTuplesPerZone; zone_id < CEIL(end, kNumTuplesPerZone); zone_id++){
+        mins_[zone_id] = std::min(mins_[zone_id], code);
+        maxs_[zone_id] = std::max(maxs_[zone_id], code);
+    }
+    min_ = std::min(min_, code);
+    max_ = std::max(max_, code);
+}
+
+void ZoneMap::Truncate(size_t num_tuples){
+    assert(num_tuples <= kNumTuplesPerBlock);
+    size_t num_zones = CEIL(num_tuples, kNumTuplesPerZone);
+    std::fill(mins_ + num_zones, mins_ + kNumZones, kEmptyMin);
+    std::fill(maxs_ + num_zones, maxs_ + kNumZones, kEmptyMax);
+    min_ = *std::min_element(mins_, mins_ + kNumZones);
+    max_ = *std::max_element(maxs_, maxs_ + kNumZones);
+}
+
+ZoneMatch ZoneMap::Match(uint32_t min, uint32_t max, Comparator comparator,
+        WordUnit literal) const{
+    //unknown range, or a literal wider than the codes
+    if(min > max || literal > code_mask_){
+        return ZoneMatch::kSome;
+    }
+    switch(comparator){
+        case Comparator::kLess:
+            if(max < literal) return ZoneMatch::kAll;
+            if(min >= literal) return ZoneMatch::kNone;
+            break;
+        case Comparator::kLessEqual:
+            if(max <= literal) return ZoneMatch::kAll;
+            if(min > literal) return ZoneMatch::kNone;
+            break;
+        case Comparator::kGreater:
+            if(min > literal) return ZoneMatch::kAll;
+            if(max <= literal) return ZoneMatch::kNone;
+            break;
+        case Comparator::kGreaterEqual:
+            if(min >= literal) return ZoneMatch::kAll;
+            if(max < literal) return ZoneMatch::kNone;
+            break;
+        case Comparator::kEqual:
+            if(min == literal && max == literal) return ZoneMatch::kAll;
+            if(literal < min || literal > max) return ZoneMatch::kNone;
+            break;
+        case Comparator::kInequal:
+            if(min == literal && max == literal) return ZoneMatch::kNone;
+            if(literal < min || literal > max) return ZoneMatch::kAll;
+            break;
+    }
+    return ZoneMatch::kSome;
+}
+
+ZoneMatch ZoneMap::MatchBetween(uint32_t min, uint32_t max, WordUnit lo, WordUnit hi) const{
+    ZoneMatch lower = Match(min, max, Comparator::kGreaterEqual, lo);
+    ZoneMatch upper = Match(min, max, Comparator::kLessEqual, hi);
+    if(ZoneMatch::kNone == lower || ZoneMatch::kNone == upper){
+        return ZoneMatch::kNone;
+    }
+    if(ZoneMatch::kAll == lower && ZoneMatch::kAll == upper){
+        return ZoneMatch::kAll;
+    }
+    return ZoneMatch::kSome;
+}
+
+ZoneMatch ZoneMap::MatchIn(uint32_t min, uint32_t max,
+        const std::vector<WordUnit> &literals) const{
+    if(min > max){
+        return ZoneMatch::kSome;
+    }
+    //the smallest literal not below min
+    auto it = std::lower_bound(literals.begin(), literals.end(), WordUnit(min));
+    if(literals.end() == it || *it > max){
+        return ZoneMatch::kNone;
+    }
+    if(min == max){
+        return ZoneMatch::kAll;
+    }
+    return ZoneMatch::kSome;
+}
+
+void ZoneMap::Fill(ZoneMatch match, Bitwise bit_opt, BitVectorBlock* bvblock,
+        size_t begin_word, size_t end_word){
+    WordUnit word;
+    switch(match){
+        case ZoneMatch::kNone:
+            if(Bitwise::kOr == bit_opt){
+                return;
+            }
+            word = 0ULL;
+            break;
+        case ZoneMatch::kAll:
+            if(Bitwise::kAnd == bit_opt){
+                return;
+            }
+            word = ~0ULL;
+            break;
+        default:
+            return;
+    }
+    for(size_t word_id = begin_word; word_id < end_word; word_id++){
+        bvblock->SetWordUnit(word, word_id);
+    }
+}
+
+bool ZoneMap::SerToFile(SequentialWriteBinaryFile &file) const{
+    return sizeof(min_) == file.Append(&min_, sizeof(min_))
+        && sizeof(max_) == file.Append(&max_, sizeof(max_))
+        && sizeof(mins_) == file.Append(mins_, sizeof(mins_))
+        && sizeof(maxs_) == file.Append(maxs_, sizeof(maxs_));
+}
+
+bool ZoneMap::DeserFromFile(const SequentialReadBinaryFile &file){
+    return sizeof(min_) == file.Read(&min_, sizeof(min_))
+        && sizeof(max_) == file.Read(&max_, sizeof(max_))
+        && sizeof(mins_) == file.Read(mins_, sizeof(mins_))
+        && sizeof(maxs_) == file.Read(maxs_, sizeof(maxs_));
+}
+
+}   //namespace
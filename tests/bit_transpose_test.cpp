@@ -0,0 +1,79 @@
+#include    "include/bit_transpose.h"
+#include    "include/bitslice_column_block.h"
+#include    "include/vbp_column_block.h"
+#include    "include/hybridslice_column_block.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+#include    <ctime>
+
+namespace byteslice{
+
+class BitTransposeTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+        for(size_t i=0; i < kNumCodes; i++){
+            codes_[i] = (static_cast<WordUnit>(std::rand()) << 33)
+                ^ (static_cast<WordUnit>(std::rand()) << 2) ^ std::rand();
+        }
+    }
+
+protected:
+    static const size_t kNumCodes = 256;
+    WordUnit codes_[kNumCodes];
+};
+
+TEST_F(BitTransposeTest, Transpose64x64){
+    WordUnit rows[64];
+    for(size_t r=0; r < 64; r++){
+        rows[r] = codes_[r];
+    }
+    Transpose64x64(rows);
+    for(size_t b=0; b < 64; b++){
+        for(size_t r=0; r < 64; r++){
+            ASSERT_EQ((codes_[r] >> b) & 1ULL, (rows[b] >> r) & 1ULL);
+        }
+    }
+}
+
+TEST_F(BitTransposeTest, TransposeBits256){
+    AvxUnit slices[64];
+    TransposeBits256(codes_, slices);
+    for(size_t b=0; b < 64; b++){
+        WordUnit words[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(words), slices[b]);
+        for(size_t i=0; i < kNumCodes; i++){
+            ASSERT_EQ((codes_[i] >> b) & 1ULL, (words[i / 64] >> (i % 64)) & 1ULL);
+        }
+    }
+}
+
+template <class Block>
+void CheckBulkLoadArray(Block* block, size_t bit_width, size_t start_pos, size_t num){
+    WordUnit* codes = new WordUnit[num];
+    const WordUnit mask = (1ULL << bit_width) - 1;
+    for(size_t i=0; i < num; i++){
+        codes[i] = std::rand() & mask;
+    }
+    block->BulkLoadArray(codes, num, start_pos);
+    for(size_t i=0; i < num; i++){
+        ASSERT_EQ(codes[i], block->GetTuple(start_pos + i)) << bit_width << " at " << i;
+    }
+    delete[] codes;
+    delete block;
+}
+
+TEST_F(BitTransposeTest, BulkLoadArray){
+    //unaligned start position, whole segments, words and a partial tail
+    CheckBulkLoadArray(new BitSliceColumnBlock(1), 1, 3, 5000);
+    CheckBulkLoadArray(new BitSliceColumnBlock(13), 13, 70, 5000);
+    CheckBulkLoadArray(new BitSliceColumnBlock(31), 31, 0, 4000);
+    CheckBulkLoadArray(new VbpColumnBlock<1>(kNumTuplesPerBlock), 1, 3, 5000);
+    CheckBulkLoadArray(new VbpColumnBlock<13>(kNumTuplesPerBlock), 13, 300, 5000);
+    CheckBulkLoadArray(new VbpColumnBlock<31>(kNumTuplesPerBlock), 31, 0, 4000);
+    CheckBulkLoadArray(new HybridSliceColumnBlock<3>(), 3, 3, 5000);
+    CheckBulkLoadArray(new HybridSliceColumnBlock<13>(), 13, 300, 5000);
+    CheckBulkLoadArray(new HybridSliceColumnBlock<26>(), 26, 0, 4000);
+}
+
+}   //namespace
@@ -1,6 +1,7 @@
 #include    "include/bitvector_iterator.h"
 #include    "gtest/gtest.h"
 #include    <cstdlib>
+#include    <vector>
 
 namespace byteslice{
 
@@ -56,6 +57,47 @@ TEST_F(BitVectorIteratorTest, Random){
     delete itor;
 }
 
+TEST_F(BitVectorIteratorTest, NextBatch){
+    //sparse (with runs of zero words), dense, and all
+    for(size_t one_in : {size_t(1000), size_t(3), size_t(1)}){
+        bitvector_->SetZeros();
+        std::vector<TupleId> expected;
+        for(size_t i=0; i < num_; i++){
+            if(0 == std::rand() % one_in){
+                bitvector_->SetBit(i);
+                expected.push_back(i);
+            }
+        }
+        for(size_t max : {size_t(1), size_t(7), size_t(64), size_t(100000)}){
+            BitVectorIterator* itor = new BitVectorIterator(bitvector_);
+            std::vector<TupleId> batch(max);
+            std::vector<TupleId> positions;
+            size_t n = 0;
+            bool more = true;
+            while(more && 0 != (n = itor->NextBatch(batch.data(), max))){
+                ASSERT_LE(n, max);
+                positions.insert(positions.end(), batch.begin(), batch.begin() + n);
+                //interleave single steps
+                more = itor->Next();
+                if(more){
+                    positions.push_back(itor->GetPosition());
+                }
+            }
+            //Next() must not be called again once it has returned false
+            if(more){
+                EXPECT_FALSE(itor->Next());
+            }
+            EXPECT_EQ(0u, itor->NextBatch(batch.data(), max));
+            ASSERT_EQ(expected.size(), positions.size()) << "one in " << one_in << " max " << max;
+            for(size_t i=0; i < expected.size(); i++){
+                ASSERT_EQ(expected[i], positions[i]) << "one in " << one_in << " max " << max
+                    << " at " << i;
+            }
+            delete itor;
+        }
+    }
+}
+
 TEST_F(BitVectorIteratorTest, AllOnes){
     bitvector_->SetOnes();
     //Verify
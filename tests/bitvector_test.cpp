@@ -1,7 +1,10 @@
 #include    "include/common.h"
 #include    "include/types.h"
 #include    "include/bitvector.h"
+#include    "include/bitvector_expression.h"
 #include    "gtest/gtest.h"
+#include    <cstdlib>
+#include    <vector>
 
 namespace byteslice{
 
@@ -29,5 +32,93 @@ TEST_F(BitVectorTest, Ctor){
     delete bitvector;
 }
 
+TEST_F(BitVectorTest, ToPositions){
+    BitVector *bitvector = new BitVector(num_);
+    //none, sparse, dense, and all
+    for(size_t one_in : {size_t(0), size_t(97), size_t(3), size_t(1)}){
+        bitvector->SetZeros();
+        std::vector<TupleId> expected;
+        for(size_t i=0; 0 != one_in && i < num_; i++){
+            if(0 == std::rand() % one_in){
+                bitvector->SetBit(i);
+                expected.push_back(i);
+            }
+        }
+        std::vector<TupleId> positions(5, 0);
+        bitvector->ToPositions(&positions);
+        ASSERT_EQ(expected.size(), positions.size()) << "one in " << one_in;
+        for(size_t i=0; i < expected.size(); i++){
+            ASSERT_EQ(expected[i], positions[i]) << "one in " << one_in << " at " << i;
+        }
+    }
+    delete bitvector;
+}
+
+TEST_F(BitVectorTest, Combine){
+    //operands of different densities; a is empty in its second block
+    std::vector<BitVector*> operands;
+    for(size_t one_in : {size_t(2), size_t(3), size_t(97), size_t(2), size_t(5)}){
+        BitVector* bitvector = new BitVector(num_);
+        bitvector->SetZeros();
+        for(size_t i=0; i < num_; i++){
+            if(0 == std::rand() % one_in){
+                bitvector->SetBit(i);
+            }
+        }
+        operands.push_back(bitvector);
+    }
+    for(size_t i=kNumTuplesPerBlock; i < 2*kNumTuplesPerBlock; i++){
+        operands[0]->UnsetBit(i);
+    }
+    BitVector *a = operands[0], *b = operands[1], *c = operands[2],
+              *d = operands[3], *e = operands[4];
+
+    //(a AND b AND NOT c) OR (d AND NOT (a OR e)) OR NOT (b OR c OR d)
+    BitVectorExpression expression;
+    size_t op_a = expression.AddOperand(a);
+    size_t op_b = expression.AddOperand(b);
+    size_t op_c = expression.AddOperand(c);
+    size_t op_d = expression.AddOperand(d);
+    size_t op_e = expression.AddOperand(e);
+    size_t left = expression.AddAnd({op_a, op_b, expression.AddNot(op_c)});
+    size_t middle = expression.AddAndNot(op_d, expression.AddOr({op_a, op_e}));
+    size_t right = expression.AddNot(expression.AddOr({op_b, op_c, op_d}));
+    expression.AddOr({left, middle, right});
+
+    std::vector<bool> expected(num_);
+    size_t expected_count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool va = a->GetBit(i), vb = b->GetBit(i), vc = c->GetBit(i),
+             vd = d->GetBit(i), ve = e->GetBit(i);
+        expected[i] = (va && vb && !vc) || (vd && !(va || ve)) || !(vb || vc || vd);
+        expected_count += expected[i];
+    }
+
+    BitVector* result = new BitVector(num_);
+    EXPECT_EQ(expected_count, result->Combine(expression, true));
+    EXPECT_EQ(0u, result->Combine(expression));
+    EXPECT_EQ(expected_count, result->CountOnes());
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(expected[i], result->GetBit(i)) << "at " << i;
+    }
+
+    //in place: a = a AND b AND NOT c AND d
+    BitVectorExpression chain;
+    chain.AddAnd({chain.AddOperand(a), chain.AddOperand(b),
+            chain.AddNot(chain.AddOperand(c)), chain.AddOperand(d)});
+    std::vector<bool> expected_chain(num_);
+    for(size_t i=0; i < num_; i++){
+        expected_chain[i] = a->GetBit(i) && b->GetBit(i) && !c->GetBit(i) && d->GetBit(i);
+    }
+    a->Combine(chain);
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(expected_chain[i], a->GetBit(i)) << "at " << i;
+    }
+
+    delete result;
+    for(BitVector* bitvector : operands){
+        delete bitvector;
+    }
+}
 
 }   //namespace
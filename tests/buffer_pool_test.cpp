@@ -0,0 +1,146 @@
+#include    "include/buffer_pool.h"
+#include    "include/byte_mask_block.h"
+#include    "include/column.h"
+#include    "gtest/gtest.h"
+#include    <cstdint>
+#include    <cstring>
+#include    <vector>
+
+namespace byteslice{
+
+class BufferPoolTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        BufferPool::Clear();
+    }
+
+    virtual void TearDown(){
+        BufferPool::SetPagePolicy(PagePolicy::kDefault);
+        BufferPool::Clear();
+    }
+};
+
+TEST_F(BufferPoolTest, ReuseReleasedBuffer){
+    const size_t size = 1024*1024;
+    void* ptr = BufferPool::Allocate(size);
+    ASSERT_TRUE(NULL != ptr);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr) % 32);
+    memset(ptr, 0xff, size);
+    BufferPool::Release(ptr, size);
+    EXPECT_EQ(1u, BufferPool::GetNumCached());
+
+    //same size: reused
+    EXPECT_EQ(ptr, BufferPool::Allocate(size));
+    EXPECT_EQ(0u, BufferPool::GetNumCached());
+    //other size: not reused
+    BufferPool::Release(ptr, size);
+    void* ptr2 = BufferPool::Allocate(size/2);
+    EXPECT_NE(ptr, ptr2);
+    EXPECT_EQ(1u, BufferPool::GetNumCached());
+    BufferPool::Release(ptr2, size/2);
+    EXPECT_EQ(2u, BufferPool::GetNumCached());
+
+    BufferPool::Clear();
+    EXPECT_EQ(0u, BufferPool::GetNumCached());
+}
+
+TEST_F(BufferPoolTest, BoundedCache){
+    const size_t size = 4096;
+    std::vector<void*> buffers;
+    for(size_t i=0; i < 2*BufferPool::kMaxNumCachedPerSize; i++){
+        buffers.push_back(BufferPool::Allocate(size));
+    }
+    for(void* ptr : buffers){
+        BufferPool::Release(ptr, size);
+    }
+    EXPECT_EQ(BufferPool::kMaxNumCachedPerSize, BufferPool::GetNumCached());
+    EXPECT_EQ(BufferPool::kMaxNumCachedPerSize * size, BufferPool::GetNumCachedBytes());
+
+    //the total size is bounded too
+    BufferPool::Clear();
+    const size_t large_size = BufferPool::kMaxNumCachedBytes / 8;
+    buffers.clear();
+    for(size_t i=0; i < 12; i++){
+        buffers.push_back(BufferPool::Allocate(large_size));
+    }
+    for(void* ptr : buffers){
+        BufferPool::Release(ptr, large_size);
+    }
+    EXPECT_EQ(8u, BufferPool::GetNumCached());
+    EXPECT_EQ(BufferPool::kMaxNumCachedBytes, BufferPool::GetNumCachedBytes());
+    void* ptr = BufferPool::Allocate(large_size);
+    EXPECT_EQ(BufferPool::kMaxNumCachedBytes - large_size, BufferPool::GetNumCachedBytes());
+    BufferPool::Release(ptr, large_size);
+}
+
+TEST_F(BufferPoolTest, HugePage){
+    for(PagePolicy policy : {PagePolicy::kTransparentHugePage, PagePolicy::kHugeTlb}){
+        BufferPool::PolicyScope scope(policy);
+        EXPECT_EQ(policy, BufferPool::GetPagePolicy());
+        const size_t num_pages = BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage)
+            + BufferPool::GetNumHugePages(PagePolicy::kHugeTlb);
+
+        //two 1MB slices share a huge page
+        const size_t size = BufferPool::kHugePageSize / 2;
+        void* ptr1 = BufferPool::Allocate(size);
+        void* ptr2 = BufferPool::Allocate(size);
+        ASSERT_TRUE(NULL != ptr1 && NULL != ptr2);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr1) / BufferPool::kHugePageSize,
+                reinterpret_cast<uintptr_t>(ptr2) / BufferPool::kHugePageSize);
+        memset(ptr1, 0xff, size);
+        memset(ptr2, 0xff, size);
+        EXPECT_EQ(num_pages + 1, BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage)
+            + BufferPool::GetNumHugePages(PagePolicy::kHugeTlb));
+
+        //large buffers are 2MB aligned
+        void* ptr3 = BufferPool::Allocate(3*size);
+        ASSERT_TRUE(NULL != ptr3);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(ptr3) % BufferPool::kHugePageSize);
+        memset(ptr3, 0, 3*size);
+
+        //released huge-page buffers are never kept by the thread cache
+        BufferPool::Release(ptr1, size);
+        BufferPool::Release(ptr2, size);
+        BufferPool::Release(ptr3, 3*size);
+        EXPECT_EQ(0u, BufferPool::GetNumCached());
+        EXPECT_EQ(num_pages, BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage)
+            + BufferPool::GetNumHugePages(PagePolicy::kHugeTlb));
+    }
+    EXPECT_EQ(PagePolicy::kDefault, BufferPool::GetPagePolicy());
+}
+
+TEST_F(BufferPoolTest, ColumnPagePolicy){
+    const size_t num = 2.5*kNumTuplesPerBlock;
+    Column* column = new Column(ColumnType::kByteSlicePadRight, 12, num,
+            PagePolicy::kTransparentHugePage);
+    EXPECT_EQ(PagePolicy::kTransparentHugePage, column->page_policy());
+    //3 blocks x 2 byte slices of 1MB
+    EXPECT_EQ(3u, BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage)
+            + BufferPool::GetNumHugePages(PagePolicy::kHugeTlb));
+    for(size_t i=0; i < num; i++){
+        column->SetTuple(i, i & 0xfff);
+    }
+    for(size_t i=0; i < num; i++){
+        ASSERT_EQ(i & 0xfff, column->GetTuple(i));
+    }
+    delete column;
+    EXPECT_EQ(0u, BufferPool::GetNumHugePages(PagePolicy::kTransparentHugePage)
+            + BufferPool::GetNumHugePages(PagePolicy::kHugeTlb));
+}
+
+TEST_F(BufferPoolTest, ByteMaskBlockReuse){
+    ByteMaskBlock* bmblk = new ByteMaskBlock(kNumTuplesPerBlock);
+    delete bmblk;
+    EXPECT_EQ(1u, BufferPool::GetNumCached());
+    //reused buffer is initialized again
+    bmblk = new ByteMaskBlock(100);
+    EXPECT_EQ(0u, BufferPool::GetNumCached());
+    EXPECT_TRUE(bmblk->GetByteMask(99));
+    EXPECT_FALSE(bmblk->GetByteMask(100));
+    bmblk->Resize(50);
+    EXPECT_EQ(50u, bmblk->num());
+    EXPECT_FALSE(bmblk->GetByteMask(50));
+    delete bmblk;
+}
+
+}   //namespace
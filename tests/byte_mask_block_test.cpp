@@ -1,6 +1,8 @@
 #include    "include/byte_mask_block.h"
+#include    "include/avx-utility.h"
 #include    "gtest/gtest.h"
 #include    <cstdlib>
+#include    <vector>
 
 namespace byteslice{
 
@@ -42,4 +44,92 @@ TEST_F(ByteMaskBlockTest, Condense){
     delete bvblk;
 }
 
+TEST_F(ByteMaskBlockTest, CountTrue){
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        count += block_->GetByteMask(i);
+    }
+    EXPECT_EQ(count, block_->CountTrue());
+
+    //a tail that is not a whole AvxUnit; masks beyond num are ignored
+    block_->Resize(1000);
+    block_->SetAvxUnit(992, avx_ones());
+    block_->SetByteMask(999, false);
+    count = 7;
+    for(size_t i=0; i < 992; i++){
+        count += block_->GetByteMask(i);
+    }
+    EXPECT_EQ(count, block_->CountTrue());
+}
+
+TEST_F(ByteMaskBlockTest, Bitwise){
+    ByteMaskBlock* other = new ByteMaskBlock(num_);
+    ByteMaskBlock* result = new ByteMaskBlock(num_);
+    for(size_t i=0; i < num_; i++){
+        other->SetByteMask(i, (0 == std::rand() % 2));
+    }
+
+    result->Set(block_);
+    result->And(other);
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(block_->GetByteMask(i) && other->GetByteMask(i), result->GetByteMask(i));
+    }
+    result->Set(block_);
+    result->Or(other);
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(block_->GetByteMask(i) || other->GetByteMask(i), result->GetByteMask(i));
+    }
+
+    delete result;
+    delete other;
+}
+
+TEST_F(ByteMaskBlockTest, CondenseCombined){
+    std::vector<ByteMaskBlock*> others;
+    std::vector<const ByteMaskBlock*> blocks(1, block_);
+    for(size_t b=0; b < 2; b++){
+        ByteMaskBlock* other = new ByteMaskBlock(num_);
+        for(size_t i=0; i < num_; i++){
+            other->SetByteMask(i, (0 != std::rand() % 3));
+        }
+        others.push_back(other);
+        blocks.push_back(other);
+    }
+    BitVectorBlock* bvblk = new BitVectorBlock(num_);
+    BitVectorBlock* input = new BitVectorBlock(num_);
+    for(size_t i=0; i < num_; i++){
+        if(0 == std::rand() % 2){
+            input->UnsetBit(i);
+        }
+    }
+
+    for(Bitwise combine : {Bitwise::kAnd, Bitwise::kOr}){
+        for(Bitwise opt : {Bitwise::kSet, Bitwise::kAnd, Bitwise::kOr}){
+            bvblk->Set(input);
+            ByteMaskBlock::Condense(blocks, combine, bvblk, opt);
+            size_t count = 0;
+            for(size_t i=0; i < num_; i++){
+                bool expected = (Bitwise::kAnd == combine)?
+                    (block_->GetByteMask(i) && others[0]->GetByteMask(i) && others[1]->GetByteMask(i)) :
+                    (block_->GetByteMask(i) || others[0]->GetByteMask(i) || others[1]->GetByteMask(i));
+                if(Bitwise::kAnd == opt){
+                    expected = expected && input->GetBit(i);
+                }
+                else if(Bitwise::kOr == opt){
+                    expected = expected || input->GetBit(i);
+                }
+                ASSERT_EQ(expected, bvblk->GetBit(i)) << "at " << i;
+                count += expected;
+            }
+            EXPECT_EQ(count, bvblk->CountOnes());
+        }
+    }
+
+    delete input;
+    delete bvblk;
+    for(ByteMaskBlock* other : others){
+        delete other;
+    }
+}
+
 }   //namespace
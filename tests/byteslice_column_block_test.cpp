@@ -1,5 +1,6 @@
 #include    "include/byteslice_column_block.h"
 #include    <cstdlib>
+#include    <ctime>
 #include    "gtest/gtest.h"
 #include    "include/bitvector_block.h"
 
@@ -115,4 +116,67 @@ TEST_F(ByteSliceColumnBlockTest, ScanOtherBlock){
     delete bvblock;
 }
 
+template <size_t BIT_WIDTH, Direction PDIRECTION = Direction::kRight>
+void CheckBulkLoadArray(size_t start_pos, size_t num){
+    ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>* block =
+        new ByteSliceColumnBlock<BIT_WIDTH, PDIRECTION>();
+    WordUnit* codes = new WordUnit[num];
+    const WordUnit mask = (1ULL << BIT_WIDTH) - 1;
+    for(size_t i=0; i < num; i++){
+        codes[i] = (static_cast<WordUnit>(std::rand()) * 2654435761ULL) & mask;
+    }
+    block->BulkLoadArray(codes, num, start_pos);
+    for(size_t i=0; i < num; i++){
+        ASSERT_EQ(codes[i], block->GetTuple(start_pos + i)) << BIT_WIDTH << " at " << i;
+    }
+
+    //scans read the transposed byte slices
+    BitVectorBlock* bvblock = new BitVectorBlock(block->num_tuples());
+    const WordUnit literal = codes[num / 2];
+    for(Comparator comparator : {Comparator::kLess, Comparator::kEqual,
+            Comparator::kGreaterEqual}){
+        block->Scan(comparator, literal, bvblock, Bitwise::kSet);
+        for(size_t i=0; i < num; i++){
+            bool expected = (Comparator::kLess == comparator)? codes[i] < literal :
+                (Comparator::kEqual == comparator)? codes[i] == literal : codes[i] >= literal;
+            ASSERT_EQ(expected, bvblock->GetBit(start_pos + i))
+                << BIT_WIDTH << " " << comparator << " at " << i;
+        }
+    }
+    delete bvblock;
+    delete[] codes;
+    delete block;
+}
+
+TEST_F(ByteSliceColumnBlockTest, BulkLoadArrayAllWidths){
+    std::srand(std::time(0));
+    //unaligned start position and a partial tail
+    CheckBulkLoadArray<1>(3, 1000);
+    CheckBulkLoadArray<7>(3, 1000);
+    CheckBulkLoadArray<8>(3, 1000);
+    CheckBulkLoadArray<9>(17, 1001);
+    CheckBulkLoadArray<16>(17, 1001);
+    CheckBulkLoadArray<17>(32, 1024);
+    CheckBulkLoadArray<24>(5, 999);
+    CheckBulkLoadArray<25>(5, 999);
+    CheckBulkLoadArray<31>(0, 1023);
+    CheckBulkLoadArray<32>(0, 1023);
+}
+
+TEST_F(ByteSliceColumnBlockTest, BulkLoadArrayPadLeft){
+    std::srand(std::time(0));
+    //codes are padded on the left: the low bits of the last byte are spare
+    CheckBulkLoadArray<1, Direction::kLeft>(3, 1000);
+    CheckBulkLoadArray<7, Direction::kLeft>(3, 1000);
+    CheckBulkLoadArray<8, Direction::kLeft>(3, 1000);
+    CheckBulkLoadArray<9, Direction::kLeft>(17, 1001);
+    CheckBulkLoadArray<12, Direction::kLeft>(17, 1001);
+    CheckBulkLoadArray<17, Direction::kLeft>(32, 1024);
+    CheckBulkLoadArray<20, Direction::kLeft>(5, 999);
+    CheckBulkLoadArray<25, Direction::kLeft>(5, 999);
+    CheckBulkLoadArray<31, Direction::kLeft>(0, 1023);
+    CheckBulkLoadArray<32, Direction::kLeft>(0, 1023);
+    CheckBulkLoadArray<21, Direction::kLeft>(0, kNumTuplesPerBlock);
+}
+
 }   //namespace
@@ -0,0 +1,189 @@
+#include    "include/bytewise_scan.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+
+namespace byteslice{
+
+enum class Order{
+    kNatural,
+    kRandom,
+    kOptimized,
+    kAdaptive
+};
+
+class BytewiseScanTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+        for(size_t c = 0; c < kNumColumns; c++){
+            const size_t bit_width = kBitWidths[c];
+            Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width, num_);
+            for(size_t i=0; i < num_; i++){
+                column->SetTuple(i, std::rand() & ((1ULL << bit_width) - 1));
+            }
+            columns.push_back(column);
+        }
+    }
+
+    virtual void TearDown(){
+        for(Column* column : columns){
+            delete column;
+        }
+    }
+
+protected:
+    static constexpr size_t kNumColumns = 10;
+    const size_t kBitWidths[kNumColumns] = {8, 12, 16, 20, 25, 32, 5, 14, 17, 9};
+    const Comparator kComparators[6] = {Comparator::kLess, Comparator::kGreaterEqual,
+        Comparator::kInequal, Comparator::kLessEqual, Comparator::kGreater, Comparator::kEqual};
+    size_t num_ = 2.5*kNumTuplesPerBlock;
+    std::vector<Column*> columns;
+
+    //A conjunction of the first num_predicates columns, mostly true
+    void Check(size_t num_predicates, Order order, bool columnwise = false){
+        BytewiseScan scan;
+        std::vector<WordUnit> literals;
+        for(size_t c = 0; c < num_predicates; c++){
+            const WordUnit mask = (1ULL << kBitWidths[c]) - 1;
+            Comparator comparator = kComparators[c % 6];
+            WordUnit literal = 0;
+            switch(comparator){
+                case Comparator::kLess:
+                case Comparator::kLessEqual:
+                    literal = mask * 0.95;
+                    break;
+                case Comparator::kGreater:
+                case Comparator::kGreaterEqual:
+                    literal = mask * 0.05;
+                    break;
+                default:
+                    literal = std::rand() & mask;
+                    break;
+            }
+            literals.push_back(literal);
+            scan.AddPredicate(BytewiseAtomPredicate(columns[c], comparator, literal));
+        }
+        switch(order){
+            case Order::kNatural:
+                break;
+            case Order::kRandom:
+                scan.ShuffleSequence();
+                break;
+            case Order::kOptimized:
+                scan.OptimizeSequence();
+                break;
+            case Order::kAdaptive:
+                scan.SetAdaptive(true);
+                break;
+        }
+        EXPECT_TRUE(scan.ValidSequence(scan.sequence()));
+
+        BitVector* bitvector = new BitVector(num_);
+        if(columnwise){
+            scan.ScanColumnwise(bitvector);
+        }
+        else{
+            scan.Scan(bitvector);
+        }
+        size_t count = 0;
+        for(size_t i=0; i < num_; i++){
+            bool expected = true;
+            for(size_t c = 0; c < num_predicates; c++){
+                WordUnit value = columns[c]->GetTuple(i);
+                switch(kComparators[c % 6]){
+                    case Comparator::kLess:
+                        expected = expected && (value < literals[c]);
+                        break;
+                    case Comparator::kLessEqual:
+                        expected = expected && (value <= literals[c]);
+                        break;
+                    case Comparator::kGreater:
+                        expected = expected && (value > literals[c]);
+                        break;
+                    case Comparator::kGreaterEqual:
+                        expected = expected && (value >= literals[c]);
+                        break;
+                    case Comparator::kEqual:
+                        expected = expected && (value == literals[c]);
+                        break;
+                    case Comparator::kInequal:
+                        expected = expected && (value != literals[c]);
+                        break;
+                }
+            }
+            count += expected;
+            ASSERT_EQ(expected, bitvector->GetBit(i)) << "at " << i;
+        }
+        EXPECT_EQ(count, bitvector->CountOnes());
+        delete bitvector;
+    }
+};
+
+TEST_F(BytewiseScanTest, OnePredicate){
+    Check(1, Order::kNatural);
+}
+
+TEST_F(BytewiseScanTest, Conjunction){
+    //with an inequality predicate
+    Check(3, Order::kNatural);
+    Check(5, Order::kRandom);
+    Check(4, Order::kRandom);
+    Check(5, Order::kOptimized);
+    Check(3, Order::kAdaptive);
+}
+
+TEST_F(BytewiseScanTest, ManyPredicates){
+    //more predicates than the specialised scans
+    Check(kNumColumns, Order::kNatural);
+    Check(kNumColumns, Order::kRandom);
+    //too many plan states for the exhaustive search
+    Check(kNumColumns, Order::kOptimized);
+    Check(kNumColumns, Order::kAdaptive);
+}
+
+TEST_F(BytewiseScanTest, Columnwise){
+    //every comparator, through byte mask vectors
+    Check(6, Order::kNatural, true);
+    Check(6, Order::kRandom, true);
+}
+
+TEST_F(BytewiseScanTest, OptimizedSequence){
+    //column 0 is decided by its only byte, column 5 rarely by its first
+    BytewiseScan scan;
+    scan.AddPredicate(BytewiseAtomPredicate(columns[5], Comparator::kLess, 0x7f000000));
+    scan.AddPredicate(BytewiseAtomPredicate(columns[0], Comparator::kLess, 200));
+    Sequence optimized = scan.OptimizedSequence();
+    ASSERT_TRUE(scan.ValidSequence(optimized));
+    double cost = scan.EstimateNumBytes(optimized);
+    EXPECT_LE(cost, scan.EstimateNumBytes(scan.NaturalSequence()));
+    for(size_t i = 0; i < 10; i++){
+        EXPECT_LE(cost, scan.EstimateNumBytes(scan.RandomSequence()));
+    }
+    //both columns must be scanned at least once
+    EXPECT_GE(cost, 2);
+    EXPECT_LE(cost, scan.num_bytes_all());
+}
+
+TEST_F(BytewiseScanTest, ValidSequence){
+    BytewiseScan scan;
+    scan.AddPredicate(BytewiseAtomPredicate(columns[0], Comparator::kLess, 3));
+    scan.AddPredicate(BytewiseAtomPredicate(columns[2], Comparator::kLess, 3));
+    EXPECT_EQ(3u, scan.num_bytes_all());
+    EXPECT_TRUE(scan.ValidSequence(scan.NaturalSequence()));
+    EXPECT_TRUE(scan.ValidSequence(scan.RandomSequence()));
+
+    Sequence seq;
+    seq.push_back(ByteInColumn(1, 0));
+    seq.push_back(ByteInColumn(0, 0));
+    seq.push_back(ByteInColumn(1, 1));
+    EXPECT_TRUE(scan.ValidSequence(seq));
+    //bytes of a column out of order
+    seq[0].byte_id = 1;
+    seq[2].byte_id = 0;
+    EXPECT_FALSE(scan.ValidSequence(seq));
+    //wrong length
+    seq.pop_back();
+    EXPECT_FALSE(scan.ValidSequence(seq));
+}
+
+}   //namespace
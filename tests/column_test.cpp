@@ -1,8 +1,14 @@
 #include    "include/column.h"
 #include    "gtest/gtest.h"
+#include    <algorithm>
 #include    <cstdlib>
+#include    <cstdio>
+#include    <cstring>
 #include    <fstream>
+#include    <iterator>
 #include    <string>
+#include    <utility>
+#include    <vector>
 
 namespace byteslice{
 
@@ -27,7 +33,7 @@ protected:
     const WordUnit mask_ = (1ULL << bit_width_) - 1 ;
 };
 
-TEST_F(ColumnTest, DISABLED_LoadTextFile){
+TEST_F(ColumnTest, LoadTextFile){
     std::string filepath = "columntest.tmp";
     
     //write data to a text file
@@ -39,11 +45,759 @@ TEST_F(ColumnTest, DISABLED_LoadTextFile){
 
     //Verify
     Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
-    column->LoadTextFile(filepath);
+    EXPECT_EQ(num_, column->LoadTextFile(filepath));
     for(size_t i=0; i < num_; i++){
-        EXPECT_EQ(data_[i], column->GetTuple(i));
+        ASSERT_EQ(data_[i], column->GetTuple(i)) << "at " << i;
+    }
+    delete column;
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, LoadCsvFile){
+    std::string filepath = "columntest.csv";
+    const size_t num = 3*kNumTuplesPerBlock + 100;
+
+    //write a csv file with irregular spacing and blank lines
+    std::ofstream outfile(filepath, std::ofstream::out);
+    for(size_t i=0; i < num; i++){
+        outfile << data_[i] << ", " << (i * 1234567891ULL) % 4000000000ULL
+            << "," << i % 7 << "\r\n";
+        if(0 == i % 100000){
+            outfile << "\n";
+        }
+    }
+    outfile.close();
+
+    std::vector<Column*> columns = {
+        new Column(ColumnType::kByteSlicePadRight, bit_width_, num),
+        new Column(ColumnType::kNaive, 32, num),
+        new Column(ColumnType::kBitSlice, 3, num)};
+    EXPECT_EQ(num, Column::LoadCsvFile(filepath, columns));
+    for(size_t i=0; i < num; i++){
+        ASSERT_EQ(data_[i], columns[0]->GetTuple(i)) << "at " << i;
+        ASSERT_EQ((i * 1234567891ULL) % 4000000000ULL, columns[1]->GetTuple(i)) << "at " << i;
+        ASSERT_EQ(i % 7, columns[2]->GetTuple(i)) << "at " << i;
+    }
+
+    //a shorter column bounds the number of loaded lines
+    Column* column = new Column(ColumnType::kNaive, bit_width_, 1000);
+    EXPECT_EQ(1000u, Column::LoadCsvFile(filepath, std::vector<Column*>(1, column)));
+    for(size_t i=0; i < 1000; i++){
+        ASSERT_EQ(data_[i], column->GetTuple(i));
+    }
+
+    //malformed or missing fields are rejected
+    const char* bad_rows[] = {"12,x3\n", "12,\n", "12\n", "12 3,4\n", "-1,4\n"};
+    for(const char* bad_row : bad_rows){
+        outfile.open(filepath, std::ofstream::out);
+        outfile << "1,2\n" << bad_row << "5,6\n";
+        outfile.close();
+        EXPECT_EQ(0u, Column::LoadCsvFile(filepath, {columns[1], columns[2]})) << bad_row;
+    }
+
+    delete column;
+    for(Column* c : columns){
+        delete c;
+    }
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, SerDeser){
+    std::string filepath = "columntest.dat";
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kNaiveAvx, ColumnType::kBitSlice,
+        ColumnType::kHbp, ColumnType::kVbp, ColumnType::kAvx2Scan,
+        ColumnType::kByteSlicePadRight, ColumnType::kHybridSlice,
+        ColumnType::kDualByteSlicePadRight, ColumnType::kSuperscalar2ByteSlicePadRight};
+
+    for(ColumnType type : types){
+        Column* column = new Column(type, bit_width_, num_);
+        column->BulkLoadArray(data_, num_);
+
+        SequentialWriteBinaryFile outfile;
+        ASSERT_TRUE(outfile.Open(filepath));
+        EXPECT_TRUE(column->SerToFile(outfile));
+        outfile.Close();
+
+        //Deserialize into a column created with different parameters
+        Column* column2 = new Column();
+        SequentialReadBinaryFile infile;
+        ASSERT_TRUE(infile.Open(filepath));
+        EXPECT_TRUE(column2->DeserFromFile(infile));
+        infile.Close();
+
+        //Verify
+        EXPECT_EQ(type, column2->type());
+        EXPECT_EQ(bit_width_, column2->bit_width());
+        EXPECT_EQ(num_, column2->num_tuples());
+        EXPECT_EQ(column->GetNumBlocks(), column2->GetNumBlocks());
+        for(size_t i=0; i < num_; i++){
+            ASSERT_EQ(data_[i], column2->GetTuple(i)) << type << " at " << i;
+        }
+        delete column;
+        delete column2;
+    }
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, DeserCorrupted){
+    std::string filepath = "columntest_corrupted.dat";
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    column->BulkLoadArray(data_, num_);
+    SequentialWriteBinaryFile outfile;
+    ASSERT_TRUE(outfile.Open(filepath));
+    EXPECT_TRUE(column->SerToFile(outfile));
+    outfile.Close();
+    std::ifstream infile(filepath, std::ifstream::binary);
+    std::string content((std::istreambuf_iterator<char>(infile)),
+            std::istreambuf_iterator<char>());
+    infile.close();
+
+    //header: magic, version, type, bit width at offset 16;
+    //trailer: offset of the block index
+    uint64_t index_offset;
+    memcpy(&index_offset, &content[content.size() - sizeof(index_offset)], sizeof(index_offset));
+    std::vector<std::string> corrupted(4, content);
+    corrupted[0].resize(content.size() / 2);
+    corrupted[1][16] = 0;
+    corrupted[2][16] = 40;
+    //the last block payload runs past the end of the file
+    uint64_t short_block = index_offset - 64;
+    memcpy(&corrupted[3][index_offset + 8*(column->GetNumBlocks()-1)],
+            &short_block, sizeof(short_block));
+
+    for(const std::string &bytes : corrupted){
+        std::ofstream out(filepath, std::ofstream::binary);
+        out.write(bytes.data(), bytes.size());
+        out.close();
+
+        //a failed load leaves the column as it was
+        Column* column2 = new Column(ColumnType::kNaive, 8, 10);
+        column2->SetTuple(3, 42);
+        SequentialReadBinaryFile file;
+        ASSERT_TRUE(file.Open(filepath));
+        EXPECT_FALSE(column2->DeserFromFile(file));
+        file.Close();
+        EXPECT_EQ(ColumnType::kNaive, column2->type());
+        EXPECT_EQ(8u, column2->bit_width());
+        EXPECT_EQ(10u, column2->num_tuples());
+        EXPECT_EQ(42u, column2->GetTuple(3));
+        delete column2;
+    }
+    delete column;
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, PagePolicyPersisted){
+    std::string filepath = "columntest_policy.dat";
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_,
+            PagePolicy::kTransparentHugePage);
+    column->BulkLoadArray(data_, num_);
+    SequentialWriteBinaryFile outfile;
+    ASSERT_TRUE(outfile.Open(filepath));
+    EXPECT_TRUE(column->SerToFile(outfile));
+    outfile.Close();
+
+    //the policy of the file wins over the one of the column
+    Column* column2 = new Column(ColumnType::kNaive, 8, 10, PagePolicy::kHugeTlb);
+    SequentialReadBinaryFile infile;
+    ASSERT_TRUE(infile.Open(filepath));
+    EXPECT_TRUE(column2->DeserFromFile(infile));
+    infile.Close();
+    EXPECT_EQ(PagePolicy::kTransparentHugePage, column2->page_policy());
+    Column* column3 = new Column();
+    EXPECT_TRUE(column3->MapBinaryFile(filepath));
+    EXPECT_EQ(PagePolicy::kTransparentHugePage, column3->page_policy());
+
+    //header: page policy at offset 40
+    std::ifstream in(filepath, std::ifstream::binary);
+    std::string content((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+    in.close();
+    content[40] = 7;
+    std::ofstream out(filepath, std::ofstream::binary);
+    out.write(content.data(), content.size());
+    out.close();
+    SequentialReadBinaryFile infile2;
+    ASSERT_TRUE(infile2.Open(filepath));
+    EXPECT_FALSE(column2->DeserFromFile(infile2));
+    infile2.Close();
+    EXPECT_FALSE(column3->MapBinaryFile(filepath));
+
+    delete column;
+    delete column2;
+    delete column3;
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, MapBinaryFile){
+    std::string filepath = "columntest_mapped.dat";
+    WordUnit literal = std::rand() & mask_;
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    column->BulkLoadArray(data_, num_);
+
+    SequentialWriteBinaryFile outfile;
+    ASSERT_TRUE(outfile.Open(filepath));
+    EXPECT_TRUE(column->SerToFile(outfile));
+    outfile.Close();
+
+    Column* column2 = new Column();
+    EXPECT_TRUE(column2->MapBinaryFile(filepath));
+    EXPECT_EQ(ColumnType::kByteSlicePadRight, column2->type());
+    EXPECT_EQ(bit_width_, column2->bit_width());
+    EXPECT_EQ(num_, column2->num_tuples());
+    EXPECT_EQ(column->GetNumBlocks(), column2->GetNumBlocks());
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(data_[i], column2->GetTuple(i)) << "at " << i;
+    }
+
+    //Scan on the mapped column
+    BitVector* bitvector = new BitVector(column);
+    BitVector* bitvector2 = new BitVector(column2);
+    column->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+    column2->Scan(Comparator::kLess, literal, bitvector2, Bitwise::kSet);
+    EXPECT_EQ(bitvector->CountOnes(), bitvector2->CountOnes());
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(bitvector->GetBit(i), bitvector2->GetBit(i)) << "at " << i;
+    }
+
+    //Writes go to private pages and never reach the file
+    column2->SetTuple(0, data_[0] ^ 1);
+    EXPECT_EQ(data_[0] ^ 1, column2->GetTuple(0));
+    Column* column3 = new Column();
+    EXPECT_TRUE(column3->MapBinaryFile(filepath));
+    EXPECT_EQ(data_[0], column3->GetTuple(0));
+
+    delete bitvector;
+    delete bitvector2;
+    delete column;
+    delete column2;
+    delete column3;
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, MapCorrupted){
+    std::string filepath = "columntest_mapcorrupted.dat";
+    Column* column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num_);
+    column->BulkLoadArray(data_, num_);
+    SequentialWriteBinaryFile outfile;
+    ASSERT_TRUE(outfile.Open(filepath));
+    EXPECT_TRUE(column->SerToFile(outfile));
+    outfile.Close();
+    std::ifstream infile(filepath, std::ifstream::binary);
+    std::string content((std::istreambuf_iterator<char>(infile)),
+            std::istreambuf_iterator<char>());
+    infile.close();
+
+    uint64_t index_offset;
+    memcpy(&index_offset, &content[content.size() - sizeof(index_offset)], sizeof(index_offset));
+    const size_t last_entry = index_offset + 8*(column->GetNumBlocks()-1);
+    std::vector<std::string> corrupted(4, content);
+    corrupted[0].resize(content.size() / 2);
+    corrupted[1][16] = 0;
+    //the last block payload runs into the index
+    uint64_t short_block = index_offset - 64;
+    memcpy(&corrupted[2][last_entry], &short_block, sizeof(short_block));
+    //a misaligned payload
+    uint64_t misaligned;
+    memcpy(&misaligned, &content[last_entry], sizeof(misaligned));
+    misaligned += 8;
+    memcpy(&corrupted[3][last_entry], &misaligned, sizeof(misaligned));
+
+    for(const std::string &bytes : corrupted){
+        std::ofstream out(filepath, std::ofstream::binary);
+        out.write(bytes.data(), bytes.size());
+        out.close();
+
+        //a failed mapping leaves the column as it was
+        Column* column2 = new Column(ColumnType::kNaive, 8, 10);
+        column2->SetTuple(3, 42);
+        EXPECT_FALSE(column2->MapBinaryFile(filepath));
+        EXPECT_EQ(ColumnType::kNaive, column2->type());
+        EXPECT_EQ(10u, column2->num_tuples());
+        EXPECT_EQ(42u, column2->GetTuple(3));
+        delete column2;
     }
     delete column;
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, ZoneMapScan){
+    std::string filepath = "columntest_zonemap.dat";
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kBitSlice, ColumnType::kByteSlicePadRight};
+    //sorted, like a timestamp column
+    for(size_t i=0; i < num_; i++){
+        data_[i] = i * mask_ / num_;
+    }
+    WordUnit literal = data_[num_ / 3];
+
+    for(ColumnType type : types){
+        Column* column = new Column(type, bit_width_, num_);
+        column->BulkLoadArray(data_, num_);
+        EXPECT_EQ(ZoneMatch::kAll,
+                column->GetBlock(0)->zone_map().Match(Comparator::kLess, literal));
+        EXPECT_EQ(ZoneMatch::kNone,
+                column->GetBlock(column->GetNumBlocks()-1)->zone_map().Match(
+                    Comparator::kLess, literal));
+
+        //zone maps survive serialization, whether copied or mapped
+        SequentialWriteBinaryFile outfile;
+        ASSERT_TRUE(outfile.Open(filepath));
+        EXPECT_TRUE(column->SerToFile(outfile));
+        outfile.Close();
+        Column* column2 = new Column();
+        SequentialReadBinaryFile infile;
+        ASSERT_TRUE(infile.Open(filepath));
+        EXPECT_TRUE(column2->DeserFromFile(infile));
+        infile.Close();
+        Column* column3 = new Column();
+        EXPECT_TRUE(column3->MapBinaryFile(filepath));
+
+        for(Column* c : {column, column2, column3}){
+            for(size_t block_id = 0; block_id < c->GetNumBlocks(); block_id++){
+                EXPECT_EQ(column->GetBlock(block_id)->zone_map().min(),
+                        c->GetBlock(block_id)->zone_map().min());
+                EXPECT_EQ(column->GetBlock(block_id)->zone_map().max(),
+                        c->GetBlock(block_id)->zone_map().max());
+            }
+            BitVector* bitvector = new BitVector(c);
+            c->Scan(Comparator::kLess, literal, bitvector, Bitwise::kSet);
+            c->Scan(Comparator::kGreaterEqual, data_[num_ / 4], bitvector, Bitwise::kAnd);
+            c->Scan(Comparator::kEqual, data_[num_ - 1], bitvector, Bitwise::kOr);
+            size_t count = 0;
+            for(size_t i=0; i < num_; i++){
+                bool expected = (data_[i] < literal && data_[i] >= data_[num_ / 4])
+                    || data_[i] == data_[num_ - 1];
+                count += expected;
+                ASSERT_EQ(expected, bitvector->GetBit(i)) << type << " at " << i;
+            }
+            EXPECT_EQ(count, bitvector->CountOnes());
+            delete bitvector;
+        }
+
+        //in-place updates keep scans correct
+        column->SetTuple(num_ - 1, 0);
+        BitVector* bitvector = new BitVector(column);
+        column->Scan(Comparator::kLess, 1, bitvector, Bitwise::kSet);
+        EXPECT_TRUE(bitvector->GetBit(num_ - 1));
+        EXPECT_TRUE(bitvector->GetBit(0));
+        delete bitvector;
+
+        delete column;
+        delete column2;
+        delete column3;
+    }
+    std::remove(filepath.c_str());
+}
+
+TEST_F(ColumnTest, ScanBetween){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kByteSlicePadRight,
+        ColumnType::kSuperscalar2ByteSlicePadRight,
+        ColumnType::kSuperscalar4ByteSlicePadRight, ColumnType::kDualByteSlicePadRight};
+    const size_t num = 2.5*kNumTuplesPerBlock;
+    WordUnit lo = std::rand() & mask_;
+    WordUnit hi = std::rand() & mask_;
+    if(lo > hi){
+        std::swap(lo, hi);
+    }
+    //bounds shared with stored values, an empty range and an unbounded one
+    data_[7] = lo;
+    data_[8] = hi;
+    std::vector<std::pair<WordUnit, WordUnit>> ranges = {
+        {lo, hi}, {lo, lo}, {hi, lo + (hi == lo)}, {0, mask_ + 100}};
+
+    for(ColumnType type : types){
+        Column* column = new Column(type, bit_width_, num);
+        column->BulkLoadArray(data_, num);
+        BitVector* bitvector = new BitVector(column);
+        for(const auto &range : ranges){
+            for(Bitwise opt : {Bitwise::kSet, Bitwise::kAnd, Bitwise::kOr}){
+                //input: every third tuple
+                bitvector->SetZeros();
+                for(size_t i=0; i < num; i += 3){
+                    bitvector->SetBit(i);
+                }
+                column->ScanBetween(range.first, range.second, bitvector, opt);
+                size_t count = 0;
+                for(size_t i=0; i < num; i++){
+                    bool result = range.first <= data_[i] && data_[i] <= range.second;
+                    bool input = (0 == i % 3);
+                    bool expected = (Bitwise::kAnd == opt)? (result && input) :
+                        (Bitwise::kOr == opt)? (result || input) : result;
+                    count += expected;
+                    ASSERT_EQ(expected, bitvector->GetBit(i))
+                        << type << " [" << range.first << ", " << range.second << "] at " << i;
+                }
+                EXPECT_EQ(count, bitvector->CountOnes());
+            }
+        }
+        delete bitvector;
+        delete column;
+    }
+}
+
+TEST_F(ColumnTest, ScanIn){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kByteSlicePadRight, ColumnType::kHybridSlice};
+    //byte slices only, one byte + bit slices, bit slices only, and wide codes
+    std::vector<size_t> bit_widths = {8, 11, 5, bit_width_};
+    const size_t num = 1.5*kNumTuplesPerBlock;
+
+    for(size_t bit_width : bit_widths){
+        const WordUnit mask = (1ULL << bit_width) - 1;
+        std::vector<WordUnit> codes(num);
+        for(size_t i=0; i < num; i++){
+            codes[i] = data_[i] & mask;
+        }
+        //a small list with a duplicate and a literal out of the domain,
+        //and a large one
+        std::vector<std::vector<WordUnit>> lists = {
+            {codes[3], codes[5], 0, mask + 7, codes[3]}, {}};
+        for(size_t i=0; i < 40; i++){
+            lists[1].push_back(codes[i * 1000]);
+            lists[1].push_back(std::rand() & mask);
+        }
+
+        for(ColumnType type : types){
+            Column* column = new Column(type, bit_width, num);
+            column->BulkLoadArray(codes.data(), num);
+            BitVector* bitvector = new BitVector(column);
+            for(const auto &list : lists){
+                for(Bitwise opt : {Bitwise::kSet, Bitwise::kAnd, Bitwise::kOr}){
+                    //input: every third tuple
+                    bitvector->SetZeros();
+                    for(size_t i=0; i < num; i += 3){
+                        bitvector->SetBit(i);
+                    }
+                    column->ScanIn(list, bitvector, opt);
+                    size_t count = 0;
+                    for(size_t i=0; i < num; i++){
+                        bool result = list.end() != std::find(list.begin(), list.end(), codes[i]);
+                        bool input = (0 == i % 3);
+                        bool expected = (Bitwise::kAnd == opt)? (result && input) :
+                            (Bitwise::kOr == opt)? (result || input) : result;
+                        count += expected;
+                        ASSERT_EQ(expected, bitvector->GetBit(i))
+                            << type << " width " << bit_width << " list of "
+                            << list.size() << " at " << i;
+                    }
+                    EXPECT_EQ(count, bitvector->CountOnes());
+                }
+            }
+            delete bitvector;
+            delete column;
+        }
+    }
+}
+
+TEST_F(ColumnTest, CountWhere){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kBitSlice, ColumnType::kByteSlicePadRight};
+    //a partial last block and a partial last AVX unit
+    const size_t num = 2.3*kNumTuplesPerBlock + 7;
+    //the first zone sorted, so zone maps decide some of it
+    for(size_t i=0; i < ZoneMap::kNumTuplesPerZone; i++){
+        data_[i] = i;
+    }
+    const std::vector<Comparator> comparators = {Comparator::kLess, Comparator::kGreater,
+        Comparator::kLessEqual, Comparator::kGreaterEqual, Comparator::kEqual, Comparator::kInequal};
+    const std::vector<WordUnit> literals = {data_[num - 1], mask_ / 3, 0, mask_};
+
+    for(ColumnType type : types){
+        Column* column = new Column(type, bit_width_, num);
+        column->BulkLoadArray(data_, num);
+        for(Comparator comparator : comparators){
+            for(WordUnit literal : literals){
+                size_t expected = 0;
+                for(size_t i=0; i < num; i++){
+                    WordUnit value = data_[i];
+                    switch(comparator){
+                        case Comparator::kLess:
+                            expected += value < literal;
+                            break;
+                        case Comparator::kGreater:
+                            expected += value > literal;
+                            break;
+                        case Comparator::kLessEqual:
+                            expected += value <= literal;
+                            break;
+                        case Comparator::kGreaterEqual:
+                            expected += value >= literal;
+                            break;
+                        case Comparator::kEqual:
+                            expected += value == literal;
+                            break;
+                        case Comparator::kInequal:
+                            expected += value != literal;
+                            break;
+                    }
+                }
+                EXPECT_EQ(expected, column->CountWhere(comparator, literal))
+                    << type << " " << comparator << " " << literal;
+            }
+        }
+        delete column;
+    }
+}
+
+TEST_F(ColumnTest, ZoneMapUnwritten){
+    //tuples never written keep the value of zeroed storage (128 for
+    //ByteSlice), which zone maps must account for
+    Column* column = new Column(ColumnType::kByteSlicePadRight, 8, 10000);
+    column->SetTuple(0, 100);
+    size_t expected = 0;
+    for(size_t i=0; i < column->num_tuples(); i++){
+        expected += column->GetTuple(i) > 110;
+    }
+    EXPECT_EQ(9999u, expected);
+    BitVector* bitvector = new BitVector(column);
+    column->Scan(Comparator::kGreater, 110, bitvector, Bitwise::kSet);
+    EXPECT_EQ(expected, bitvector->CountOnes());
+    EXPECT_EQ(expected, column->CountWhere(Comparator::kGreater, 110));
+    delete bitvector;
+    delete column;
+
+    //tuples added by Resize
+    std::vector<WordUnit> codes(5000, 20);
+    column = new Column(ColumnType::kByteSlicePadRight, 8, codes.size());
+    column->BulkLoadArray(codes.data(), codes.size());
+    column->Resize(9000);
+    bitvector = new BitVector(column);
+    column->Scan(Comparator::kGreater, 110, bitvector, Bitwise::kSet);
+    EXPECT_EQ(4000u, bitvector->CountOnes());
+    EXPECT_EQ(4000u, column->CountWhere(Comparator::kGreater, 110));
+    //shrunk, overwritten, then grown back over the old values
+    column->Resize(4000);
+    column->RebuildZoneMaps();
+    column->Resize(9000);
+    EXPECT_EQ(4000u, column->CountWhere(Comparator::kGreater, 110));
+    delete bitvector;
+    delete column;
+}
+
+TEST_F(ColumnTest, Aggregate){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kBitSlice, ColumnType::kByteSlicePadRight,
+        ColumnType::kHybridSlice};
+    //one byte slice, and padded bytes
+    std::vector<size_t> bit_widths = {8, bit_width_, 32};
+    const size_t num = 2.3*kNumTuplesPerBlock + 7;
+
+    for(size_t bit_width : bit_widths){
+        const WordUnit mask = (1ULL << bit_width) - 1;
+        std::vector<WordUnit> codes(num);
+        std::vector<WordUnit> predicate_codes(num);
+        for(size_t i=0; i < num; i++){
+            codes[i] = (data_[i] * 2654435761ULL) & mask;
+            predicate_codes[i] = data_[num - 1 - i];
+        }
+        const WordUnit literal = mask_ / 10;
+        Column* predicate_column = new Column(ColumnType::kByteSlicePadRight, bit_width_, num);
+        predicate_column->BulkLoadArray(predicate_codes.data(), num);
+
+        for(ColumnType type : types){
+            Column* column = new Column(type, bit_width, num);
+            column->BulkLoadArray(codes.data(), num);
+            BitVector* bitvector = new BitVector(column);
+            //every tuple, every third one, a single one and none
+            std::vector<std::vector<size_t>> selections = {{}, {}, {num - 1}, {}};
+            for(size_t i=0; i < num; i += 3){
+                selections[1].push_back(i);
+            }
+            for(size_t s = 0; s < selections.size(); s++){
+                AggregateResult expected;
+                AggregateResult result;
+                if(0 == s){
+                    for(size_t i=0; i < num; i++){
+                        expected.Add(codes[i]);
+                    }
+                    result = column->Aggregate();
+                }
+                else{
+                    bitvector->SetZeros();
+                    for(size_t i : selections[s]){
+                        bitvector->SetBit(i);
+                        expected.Add(codes[i]);
+                    }
+                    result = column->Aggregate(bitvector);
+                }
+                ASSERT_EQ(expected.count, result.count) << type << " width " << bit_width;
+                EXPECT_EQ(expected.sum, result.sum) << type << " width " << bit_width;
+                EXPECT_DOUBLE_EQ(expected.avg(), result.avg()) << type << " width " << bit_width;
+                if(0 != expected.count){
+                    EXPECT_EQ(expected.min, result.min) << type << " width " << bit_width;
+                    EXPECT_EQ(expected.max, result.max) << type << " width " << bit_width;
+                }
+            }
+
+            //fused with a predicate on another column
+            AggregateResult expected;
+            for(size_t i=0; i < num; i++){
+                if(predicate_codes[i] < literal){
+                    expected.Add(codes[i]);
+                }
+            }
+            AggregateResult result = column->AggregateWhere(predicate_column,
+                    Comparator::kLess, literal);
+            EXPECT_EQ(expected.count, result.count) << type << " width " << bit_width;
+            EXPECT_EQ(expected.sum, result.sum) << type << " width " << bit_width;
+            EXPECT_EQ(expected.min, result.min) << type << " width " << bit_width;
+            EXPECT_EQ(expected.max, result.max) << type << " width " << bit_width;
+            delete bitvector;
+            delete column;
+        }
+        delete predicate_column;
+    }
+}
+
+TEST_F(ColumnTest, TopK){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kBitSlice, ColumnType::kByteSlicePadRight,
+        ColumnType::kHybridSlice};
+    std::vector<size_t> bit_widths = {8, bit_width_, 32};
+    const size_t num = 2.3*kNumTuplesPerBlock + 7;
+
+    for(size_t bit_width : bit_widths){
+        const WordUnit mask = (1ULL << bit_width) - 1;
+        //random, ascending with duplicates, and a single value (all ties)
+        std::vector<std::vector<WordUnit>> datasets(3, std::vector<WordUnit>(num));
+        for(size_t i=0; i < num; i++){
+            datasets[0][i] = (data_[i] * 2654435761ULL) & mask;
+            datasets[1][i] = (i / 3) & mask;
+            datasets[2][i] = mask / 3;
+        }
+        for(ColumnType type : types){
+            for(const std::vector<WordUnit> &codes : datasets){
+                Column* column = new Column(type, bit_width, num);
+                column->BulkLoadArray(codes.data(), num);
+                BitVector* bitvector = new BitVector(column);
+                bitvector->SetZeros();
+                for(size_t i=0; i < num; i += 3){
+                    bitvector->SetBit(i);
+                }
+                for(BitVector* filter : {static_cast<BitVector*>(nullptr), bitvector}){
+                    for(bool largest : {false, true}){
+                        std::vector<TopKEntry> all;
+                        for(size_t i=0; i < num; i++){
+                            if(nullptr == filter || filter->GetBit(i)){
+                                all.push_back(TopKEntry(codes[i], i));
+                            }
+                        }
+                        std::sort(all.begin(), all.end(),
+                                [largest](const TopKEntry &a, const TopKEntry &b){
+                                    return TopKBetter(a, b, largest);
+                                });
+                        for(size_t k : {size_t(1), size_t(10), size_t(3000)}){
+                            std::vector<TopKEntry> result = column->TopK(k, largest, filter);
+                            ASSERT_EQ(std::min(k, all.size()), result.size())
+                                << type << " width " << bit_width;
+                            for(size_t i=0; i < result.size(); i++){
+                                ASSERT_EQ(all[i], result[i]) << type << " width " << bit_width
+                                    << " k " << k << " largest " << largest << " at " << i;
+                            }
+                        }
+                        WordUnit extreme = 0;
+                        bool found = largest? column->Max(&extreme, filter)
+                                            : column->Min(&extreme, filter);
+                        ASSERT_TRUE(found);
+                        EXPECT_EQ(all[0].first, extreme) << type << " width " << bit_width;
+                    }
+                }
+                //nothing selected
+                bitvector->SetZeros();
+                WordUnit extreme = 0;
+                EXPECT_FALSE(column->Min(&extreme, bitvector));
+                EXPECT_FALSE(column->Max(&extreme, bitvector));
+                EXPECT_TRUE(column->TopK(10, false, bitvector).empty());
+                delete bitvector;
+                delete column;
+            }
+        }
+    }
+}
+
+TEST_F(ColumnTest, Gather){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kHbp, ColumnType::kVbp, ColumnType::kBitSlice,
+        ColumnType::kByteSlicePadRight, ColumnType::kHybridSlice, ColumnType::kNaiveAvx};
+    std::vector<size_t> bit_widths = {3, 8, 12, 17, bit_width_, 25, 32};
+    const size_t num = 2.3*kNumTuplesPerBlock + 7;
+
+    //sorted, shuffled with repeats, and the last tuples of each block
+    std::vector<std::vector<TupleId>> rid_lists(3);
+    for(size_t i=0; i < num; i += 7){
+        rid_lists[0].push_back(i);
+    }
+    for(size_t i=0; i < 100003; i++){
+        rid_lists[1].push_back(std::rand() % num);
+    }
+    for(size_t i=0; i < 40; i++){
+        rid_lists[2].push_back(kNumTuplesPerBlock - 1 - i);
+        rid_lists[2].push_back(2*kNumTuplesPerBlock - 1 - i);
+        rid_lists[2].push_back(num - 1 - i);
+    }
+
+    for(size_t bit_width : bit_widths){
+        const WordUnit mask = (1ULL << bit_width) - 1;
+        std::vector<WordUnit> codes(num);
+        for(size_t i=0; i < num; i++){
+            codes[i] = (data_[i] * 2654435761ULL) & mask;
+        }
+        for(ColumnType type : types){
+            Column* column = new Column(type, bit_width, num);
+            column->BulkLoadArray(codes.data(), num);
+            for(const std::vector<TupleId> &rids : rid_lists){
+                std::vector<WordUnit> values(rids.size());
+                column->Gather(rids.data(), rids.size(), values.data());
+                for(size_t i=0; i < rids.size(); i++){
+                    ASSERT_EQ(codes[rids[i]], values[i]) << type << " width " << bit_width
+                        << " rid " << rids[i];
+                }
+            }
+            delete column;
+        }
+    }
+}
+
+TEST_F(ColumnTest, ScanPositions){
+    std::vector<ColumnType> types = {
+        ColumnType::kNaive, ColumnType::kBitSlice, ColumnType::kByteSlicePadRight,
+        ColumnType::kHybridSlice};
+    const size_t num = 2.3*kNumTuplesPerBlock + 7;
+    std::vector<WordUnit> codes(data_, data_ + num);
+    //the second block holds small codes only, so zone maps decide it
+    for(size_t i = kNumTuplesPerBlock; i < 2*kNumTuplesPerBlock; i++){
+        codes[i] &= 0xff;
+    }
+    for(ColumnType type : types){
+        Column* column = new Column(type, bit_width_, num);
+        column->BulkLoadArray(codes.data(), num);
+        for(WordUnit literal : {WordUnit(0), WordUnit(0x100), mask_ / 20, mask_ / 2, mask_}){
+            for(Comparator comparator : {Comparator::kLess, Comparator::kGreaterEqual}){
+                std::vector<TupleId> expected;
+                for(size_t i=0; i < num; i++){
+                    bool match = (Comparator::kLess == comparator)?
+                        codes[i] < literal : codes[i] >= literal;
+                    if(match){
+                        expected.push_back(i);
+                    }
+                }
+                BitVector* bitvector = new BitVector(column);
+                column->Scan(comparator, literal, bitvector);
+                std::vector<TupleId> positions;
+                bitvector->ToPositions(&positions);
+                delete bitvector;
+                ASSERT_EQ(expected.size(), positions.size()) << type << " literal " << literal;
+                for(size_t i=0; i < expected.size(); i++){
+                    ASSERT_EQ(expected[i], positions[i]) << type << " literal " << literal
+                        << " at " << i;
+                }
+            }
+        }
+        delete column;
+    }
 }
 
 TEST_F(ColumnTest, NaiveSetTuple){
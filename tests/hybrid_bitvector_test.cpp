@@ -0,0 +1,176 @@
+#include    "include/hybrid_bitvector.h"
+#include    "include/column.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+#include    <vector>
+
+namespace byteslice{
+
+enum class Pattern{
+    kEmpty,
+    kNeedles,   //a few 1's
+    kSparse,    //1% random
+    kDense,     //30% random
+    kRuns,      //long runs of 1's
+    kFull
+};
+
+class HybridBitVectorTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+    }
+
+    virtual void TearDown(){
+    }
+
+protected:
+    const size_t num_ = 3*kNumTuplesPerBlock + 2000;
+    const std::vector<Pattern> kPatterns = {Pattern::kEmpty, Pattern::kNeedles,
+        Pattern::kSparse, Pattern::kDense, Pattern::kRuns, Pattern::kFull};
+
+    void Fill(Pattern pattern, BitVector* bitvector){
+        bitvector->SetZeros();
+        for(size_t i=0; i < num_; i++){
+            bool one = false;
+            switch(pattern){
+                case Pattern::kEmpty:
+                    break;
+                case Pattern::kNeedles:
+                    one = (0 == std::rand() % 100000);
+                    break;
+                case Pattern::kSparse:
+                    one = (0 == std::rand() % 100);
+                    break;
+                case Pattern::kDense:
+                    one = (std::rand() % 10 < 3);
+                    break;
+                case Pattern::kRuns:
+                    one = ((i / 5000) % 3 == 1);
+                    break;
+                case Pattern::kFull:
+                    one = true;
+                    break;
+            }
+            if(one){
+                bitvector->SetBit(i);
+            }
+        }
+    }
+
+    void ExpectEqual(BitVector* expected, const HybridBitVector* hybrid){
+        ASSERT_EQ(expected->CountOnes(), hybrid->CountOnes());
+        std::vector<TupleId> expected_positions;
+        std::vector<TupleId> positions;
+        expected->ToPositions(&expected_positions);
+        hybrid->ToPositions(&positions);
+        ASSERT_EQ(expected_positions, positions);
+        for(size_t i=0; i < 1000; i++){
+            size_t pos = std::rand() % num_;
+            ASSERT_EQ(expected->GetBit(pos), hybrid->GetBit(pos)) << "at " << pos;
+        }
+        BitVector* dense = new BitVector(num_);
+        hybrid->ToBitVector(dense);
+        for(size_t block_id = 0; block_id < dense->GetNumBlocks(); block_id++){
+            BitVectorBlock* block = dense->GetBVBlock(block_id);
+            for(size_t i=0; i < block->num_word_units(); i++){
+                ASSERT_EQ(expected->GetBVBlock(block_id)->GetWordUnit(i), block->GetWordUnit(i))
+                    << "block " << block_id << " word " << i;
+            }
+        }
+        delete dense;
+    }
+};
+
+TEST_F(HybridBitVectorTest, Conversion){
+    BitVector* bitvector = new BitVector(num_);
+    for(Pattern pattern : kPatterns){
+        Fill(pattern, bitvector);
+        HybridBitVector* hybrid = new HybridBitVector(num_);
+        hybrid->FromBitVector(bitvector);
+        ExpectEqual(bitvector, hybrid);
+
+        //the smallest form is picked
+        ContainerType expected_type = ContainerType::kBitmap;
+        switch(pattern){
+            case Pattern::kEmpty:
+            case Pattern::kNeedles:
+            case Pattern::kSparse:
+                expected_type = ContainerType::kArray;
+                break;
+            case Pattern::kRuns:
+            case Pattern::kFull:
+                expected_type = ContainerType::kRun;
+                break;
+            default:
+                break;
+        }
+        EXPECT_EQ(expected_type, hybrid->GetContainer(1).type());
+        if(Pattern::kEmpty == pattern || Pattern::kNeedles == pattern){
+            EXPECT_LT(hybrid->GetNumBytes(), num_ / 64);
+        }
+        delete hybrid;
+    }
+    delete bitvector;
+}
+
+TEST_F(HybridBitVectorTest, AndOr){
+    BitVector* bitvector1 = new BitVector(num_);
+    BitVector* bitvector2 = new BitVector(num_);
+    for(Pattern pattern1 : kPatterns){
+        for(Pattern pattern2 : kPatterns){
+            Fill(pattern1, bitvector1);
+            Fill(pattern2, bitvector2);
+            HybridBitVector* hybrid1 = new HybridBitVector(num_);
+            HybridBitVector* hybrid2 = new HybridBitVector(num_);
+            hybrid1->FromBitVector(bitvector1);
+            hybrid2->FromBitVector(bitvector2);
+            HybridBitVector* hybrid_or = new HybridBitVector(num_);
+            hybrid_or->FromBitVector(bitvector1);
+
+            hybrid1->And(hybrid2);
+            hybrid_or->Or(hybrid2);
+            BitVector* expected_or = new BitVector(num_);
+            expected_or->SetZeros();
+            expected_or->Or(bitvector1);
+            expected_or->Or(bitvector2);
+            bitvector1->And(bitvector2);
+            ExpectEqual(bitvector1, hybrid1);
+            ExpectEqual(expected_or, hybrid_or);
+
+            delete expected_or;
+            delete hybrid_or;
+            delete hybrid2;
+            delete hybrid1;
+        }
+    }
+    delete bitvector2;
+    delete bitvector1;
+}
+
+TEST_F(HybridBitVectorTest, ColumnScan){
+    const size_t bit_width = 20;
+    const WordUnit mask = (1ULL << bit_width) - 1;
+    for(ColumnType type : {ColumnType::kByteSlicePadRight, ColumnType::kBitSlice}){
+        Column* column = new Column(type, bit_width, num_);
+        for(size_t i=0; i < num_; i++){
+            //the second block holds large codes only, so zone maps decide it
+            WordUnit code = std::rand() & mask;
+            column->SetTuple(i, (1 == i / kNumTuplesPerBlock)? (code | (mask / 2 + 1)) : code);
+        }
+        BitVector* bitvector = new BitVector(num_);
+        HybridBitVector* hybrid = new HybridBitVector(num_);
+        for(WordUnit literal : {WordUnit(3), mask / 100, mask / 2 + 1, mask}){
+            for(Comparator comparator : {Comparator::kLess, Comparator::kGreaterEqual}){
+                column->Scan(comparator, literal, bitvector, Bitwise::kSet);
+                column->Scan(comparator, literal, hybrid);
+                ExpectEqual(bitvector, hybrid);
+            }
+        }
+        delete hybrid;
+        delete bitvector;
+        delete column;
+    }
+}
+
+}   //namespace
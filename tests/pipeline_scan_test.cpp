@@ -63,6 +63,22 @@ TEST_F(PipelineScanTest, Blockwise){
     delete bitvector;
 }
 
+TEST_F(PipelineScanTest, CountBlockwise){
+    WordUnit lit1 = mask_ * 0.2;
+    WordUnit lit2 = mask_ * 0.5;
+    PipelineScan scan;
+    scan.AddPredicate(AtomPredicate(column1, Comparator::kGreaterEqual, lit1));
+    scan.AddPredicate(AtomPredicate(column2, Comparator::kLess, lit2));
+
+    size_t expected = 0;
+    for(size_t i=0; i < num_; i++){
+        expected += column1->GetTuple(i) >= lit1 && column2->GetTuple(i) < lit2;
+    }
+    EXPECT_EQ(expected, scan.CountBlockwise());
+    scan.SetAdaptive(true);
+    EXPECT_EQ(expected, scan.CountBlockwise());
+}
+
 TEST_F(PipelineScanTest, Columnwise){
     WordUnit lit1 = mask_ * 0.2;
     WordUnit lit2 = mask_ * 0.5;
@@ -153,4 +169,63 @@ TEST_F(PipelineScanTest, Naive){
     delete bitvector;
 }
 
+TEST_F(PipelineScanTest, Adaptive){
+    //the selective predicate is added last
+    WordUnit lit1 = mask_ * 0.9;
+    WordUnit lit2 = mask_ * 0.05;
+    PipelineScan scan;
+    scan.AddPredicate(AtomPredicate(column1, Comparator::kLess, lit1));
+    scan.AddPredicate(AtomPredicate(column2, Comparator::kLess, lit2));
+    scan.SetAdaptive(true);
+    EXPECT_EQ(0u, scan.order()[0]);
+    BitVector* bitvector = new BitVector(num_);
+
+    scan.ExecuteBlockwise(bitvector);
+    for(size_t i=0; i < num_; i++){
+        ASSERT_EQ(column1->GetTuple(i) < lit1 && column2->GetTuple(i) < lit2,
+                bitvector->GetBit(i)) << "at " << i;
+    }
+    EXPECT_EQ(1u, scan.order()[0]);
+    EXPECT_EQ(0u, scan.order()[1]);
+
+    //blocks 0 and 8 are measured
+    const std::vector<PredicateStats> &stats = scan.stats();
+    EXPECT_EQ(2u, stats[0].num_blocks);
+    EXPECT_EQ(2u, stats[1].num_blocks);
+    EXPECT_NEAR(0.05, stats[1].selectivity(), 0.01);
+    EXPECT_NEAR(0.9, stats[0].selectivity(), 0.01);
+    EXPECT_LT(0, stats[1].cycles_per_block());
+
+    //the order is kept by later executions
+    scan.ResetStats();
+    EXPECT_EQ(0u, scan.stats()[0].num_blocks);
+    scan.ExecuteBlockwise(bitvector);
+    EXPECT_EQ(1u, scan.order()[0]);
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        count += column1->GetTuple(i) < lit1 && column2->GetTuple(i) < lit2;
+    }
+    EXPECT_EQ(count, bitvector->CountOnes());
+    delete bitvector;
+}
+
+TEST_F(PipelineScanTest, AdaptiveEmptyInput){
+    //the second predicate drops every tuple: the third one only sees
+    //empty inputs, which must not keep the others from being reordered
+    PipelineScan scan;
+    scan.AddPredicate(AtomPredicate(column1, Comparator::kLess, mask_ * 0.9));
+    scan.AddPredicate(AtomPredicate(column2, Comparator::kGreater, mask_));
+    scan.AddPredicate(AtomPredicate(column2, Comparator::kLess, mask_ * 0.5));
+    scan.SetAdaptive(true);
+    BitVector* bitvector = new BitVector(num_);
+
+    scan.ExecuteBlockwise(bitvector);
+    EXPECT_EQ(0u, bitvector->CountOnes());
+    EXPECT_EQ(0u, scan.stats()[2].num_input);
+    EXPECT_EQ(1u, scan.order()[0]);
+    EXPECT_EQ(2u, scan.order()[2]);
+    EXPECT_LT(0, scan.stats()[2].cycles_per_tuple());
+    delete bitvector;
+}
+
 }
@@ -0,0 +1,96 @@
+#include    "include/predicate_tree.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+
+namespace byteslice{
+
+class PredicateTreeTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+        column1 = new Column(ColumnType::kByteSlicePadRight, 16, num_);
+        column2 = new Column(ColumnType::kByteSlicePadRight, 11, num_);
+        column3 = new Column(ColumnType::kByteSlicePadRight, 23, num_);
+        //Populate with random values; column2 from a small domain
+        for(size_t i=0; i < num_; i++){
+            column1->SetTuple(i, std::rand() & ((1ULL << 16) - 1));
+            column2->SetTuple(i, std::rand() % 50);
+            column3->SetTuple(i, std::rand() & ((1ULL << 23) - 1));
+        }
+    }
+
+    virtual void TearDown(){
+        delete column1;
+        delete column2;
+        delete column3;
+    }
+
+protected:
+    size_t num_ = 3.5*kNumTuplesPerBlock;
+    Column* column1;
+    Column* column2;
+    Column* column3;
+};
+
+TEST_F(PredicateTreeTest, AndOfOr){
+    //(c1 < lit1 OR c2 = 3) AND c3 >= lit3
+    const WordUnit lit1 = 20000;
+    const WordUnit lit3 = 4000000;
+    PredicateTree tree;
+    size_t p1 = tree.AddPredicate(BytewiseAtomPredicate(column1, Comparator::kLess, lit1));
+    size_t p2 = tree.AddPredicate(BytewiseAtomPredicate(column2, Comparator::kEqual, 3));
+    size_t p3 = tree.AddPredicate(BytewiseAtomPredicate(column3, Comparator::kGreaterEqual, lit3));
+    size_t disjunction = tree.AddOr({p1, p2});
+    tree.AddAnd({disjunction, p3});
+    EXPECT_EQ(3u, tree.num_predicates());
+    EXPECT_EQ(5u, tree.num_nodes());
+
+    BitVector* bitvector = new BitVector(num_);
+    tree.Scan(bitvector);
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = (column1->GetTuple(i) < lit1 || column2->GetTuple(i) == 3)
+            && column3->GetTuple(i) >= lit3;
+        count += expected;
+        ASSERT_EQ(expected, bitvector->GetBit(i)) << "at " << i;
+    }
+    EXPECT_EQ(count, bitvector->CountOnes());
+    delete bitvector;
+}
+
+TEST_F(PredicateTreeTest, Not){
+    //NOT(c1 >= lit1 AND c2 <> 7) OR (c3 <= lit3 AND NOT c2 > 40)
+    const WordUnit lit1 = 50000;
+    const WordUnit lit3 = 1000000;
+    PredicateTree tree;
+    size_t p1 = tree.AddPredicate(BytewiseAtomPredicate(column1, Comparator::kGreaterEqual, lit1));
+    size_t p2 = tree.AddPredicate(BytewiseAtomPredicate(column2, Comparator::kInequal, 7));
+    size_t p3 = tree.AddPredicate(BytewiseAtomPredicate(column3, Comparator::kLessEqual, lit3));
+    size_t p4 = tree.AddPredicate(BytewiseAtomPredicate(column2, Comparator::kGreater, 40));
+    size_t left = tree.AddNot(tree.AddAnd({p1, p2}));
+    size_t right = tree.AddAnd({p3, tree.AddNot(p4)});
+    size_t root = tree.AddOr({left, right});
+    EXPECT_EQ(root, tree.root());
+
+    BitVector* bitvector = new BitVector(num_);
+    tree.Scan(bitvector);
+    size_t count = 0;
+    for(size_t i=0; i < num_; i++){
+        bool expected = !(column1->GetTuple(i) >= lit1 && column2->GetTuple(i) != 7)
+            || (column3->GetTuple(i) <= lit3 && !(column2->GetTuple(i) > 40));
+        count += expected;
+        ASSERT_EQ(expected, bitvector->GetBit(i)) << "at " << i;
+    }
+    EXPECT_EQ(count, bitvector->CountOnes());
+
+    //a sub-tree as root
+    tree.SetRoot(right);
+    tree.Scan(bitvector);
+    for(size_t i=0; i < num_; i++){
+        bool expected = column3->GetTuple(i) <= lit3 && !(column2->GetTuple(i) > 40);
+        ASSERT_EQ(expected, bitvector->GetBit(i)) << "at " << i;
+    }
+    delete bitvector;
+}
+
+}   //namespace
@@ -0,0 +1,83 @@
+#include    "include/rank_select.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+#include    <vector>
+
+namespace byteslice{
+
+class RankSelectTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        std::srand(std::time(0));
+        bitvector_ = new BitVector(num_);
+    }
+
+    virtual void TearDown(){
+        delete bitvector_;
+    }
+
+protected:
+    const size_t num_ = 3*kNumTuplesPerBlock + 2000;
+    BitVector* bitvector_;
+
+    //A 1 every one_in tuples on average; the second block has none
+    void Fill(size_t one_in){
+        bitvector_->SetZeros();
+        for(size_t i=0; 0 != one_in && i < num_; i++){
+            if(0 == std::rand() % one_in && 1 != i / kNumTuplesPerBlock){
+                bitvector_->SetBit(i);
+            }
+        }
+    }
+};
+
+TEST_F(RankSelectTest, RankSelect){
+    //none, needles, sparse, dense, and all (but the second block)
+    for(size_t one_in : {size_t(0), size_t(100000), size_t(97), size_t(3), size_t(1)}){
+        Fill(one_in);
+        RankSelect directory(bitvector_);
+        std::vector<TupleId> positions;
+        bitvector_->ToPositions(&positions);
+        ASSERT_EQ(positions.size(), directory.CountOnes());
+        EXPECT_EQ(num_, directory.Select(positions.size()));
+        EXPECT_EQ(positions.size(), directory.Rank(num_));
+        EXPECT_EQ(0u, directory.Rank(0));
+
+        for(size_t k=0; k < positions.size(); k++){
+            ASSERT_EQ(positions[k], directory.Select(k)) << "one in " << one_in << ", k = " << k;
+            ASSERT_EQ(k, directory.Rank(positions[k]));
+        }
+        for(size_t i=0; i < 1000; i++){
+            size_t pos = std::rand() % num_;
+            size_t expected = std::lower_bound(positions.begin(), positions.end(), pos)
+                - positions.begin();
+            ASSERT_EQ(expected, directory.Rank(pos)) << "one in " << one_in << " at " << pos;
+        }
+    }
+}
+
+TEST_F(RankSelectTest, SelectRange){
+    Fill(5);
+    RankSelect directory(bitvector_);
+    std::vector<TupleId> positions;
+    bitvector_->ToPositions(&positions);
+    std::vector<TupleId> page(10000);
+    //pages across blocks, and past the end
+    for(size_t first : {size_t(0), positions.size() / 3 - 100, positions.size() - 5000,
+            positions.size()}){
+        size_t n = directory.SelectRange(first, page.size(), page.data());
+        ASSERT_EQ(std::min(page.size(), positions.size() - first), n);
+        for(size_t i=0; i < n; i++){
+            ASSERT_EQ(positions[first + i], page[i]) << "first " << first << " at " << i;
+        }
+    }
+
+    //the directory is rebuilt after the bit vector changes
+    bitvector_->SetOnes();
+    directory.Build();
+    EXPECT_EQ(num_, directory.CountOnes());
+    EXPECT_EQ(12345u, directory.Select(12345));
+    EXPECT_EQ(kNumTuplesPerBlock + 7, directory.Rank(kNumTuplesPerBlock + 7));
+}
+
+}   //namespace
@@ -0,0 +1,154 @@
+#include    "include/table.h"
+#include    "gtest/gtest.h"
+#include    <cstdlib>
+#include    <cstdio>
+#include    <ctime>
+#include    <string>
+#include    <vector>
+#include    <unistd.h>
+
+namespace byteslice{
+
+class TableTest: public ::testing::Test{
+public:
+    virtual void SetUp(){
+        data1_ = new WordUnit[num_];
+        data2_ = new WordUnit[num_];
+        std::srand(std::time(0));
+        for(size_t i=0; i < num_; i++){
+            data1_[i] = std::rand() & mask1_;
+            data2_[i] = std::rand() & mask2_;
+        }
+    }
+
+    virtual void TearDown(){
+        delete[] data1_;
+        delete[] data2_;
+    }
+
+protected:
+    WordUnit* data1_;
+    WordUnit* data2_;
+    const size_t num_ = 2.5*kNumTuplesPerBlock;
+    const WordUnit mask1_ = (1ULL << 12) - 1;
+    const WordUnit mask2_ = (1ULL << 20) - 1;
+};
+
+TEST_F(TableTest, CreateAndDropColumn){
+    Table table(num_);
+    Column* column = table.CreateColumn("a", ColumnType::kByteSlicePadRight, 12);
+    ASSERT_TRUE(NULL != column);
+    EXPECT_EQ(num_, column->num_tuples());
+    EXPECT_EQ(column, table.GetColumn("a"));
+    EXPECT_TRUE(NULL == table.CreateColumn("a", ColumnType::kNaive, 12));
+    EXPECT_TRUE(NULL == table.GetColumn("b"));
+
+    //cardinality must match
+    Column* other = new Column(ColumnType::kNaive, 12, num_+1);
+    EXPECT_FALSE(table.AddColumn("b", other));
+    other->Resize(num_);
+    EXPECT_TRUE(table.AddColumn("b", other));
+    EXPECT_EQ(2u, table.GetNumColumns());
+    EXPECT_EQ(CEIL(num_, kNumTuplesPerBlock), table.GetNumBlocks());
+
+    EXPECT_TRUE(table.DropColumn("a"));
+    EXPECT_FALSE(table.DropColumn("a"));
+    EXPECT_EQ(1u, table.GetNumColumns());
+
+    //names go to the catalog and to file names
+    for(std::string name : {"", "c d", "c\td", "../c"}){
+        EXPECT_TRUE(NULL == table.CreateColumn(name, ColumnType::kNaive, 12)) << name;
+        Column* column = new Column(ColumnType::kNaive, 12, num_);
+        EXPECT_FALSE(table.AddColumn(name, column)) << name;
+        delete column;
+    }
+    EXPECT_EQ(1u, table.GetNumColumns());
+}
+
+TEST_F(TableTest, PersistAndOpen){
+    std::string path = "tabletest.dir";
+    {
+        Table table(num_);
+        table.CreateColumn("b", ColumnType::kBitSlice, 20)->BulkLoadArray(data2_, num_);
+        EXPECT_TRUE(table.Persist(path));
+        //over an existing table
+        table.CreateColumn("a", ColumnType::kByteSlicePadRight, 12,
+                PagePolicy::kTransparentHugePage)->BulkLoadArray(data1_, num_);
+        EXPECT_TRUE(table.Persist(path));
+    }
+    //temporary files are renamed into place
+    EXPECT_NE(0, access((path + "/a.col.tmp").c_str(), F_OK));
+    EXPECT_NE(0, access((path + "/CATALOG.tmp").c_str(), F_OK));
+
+    for(bool in_memory : {true, false}){
+        Table table;
+        Table::Option option;
+        option.in_memory = in_memory;
+        ASSERT_TRUE(table.Open(path, option));
+        EXPECT_EQ(num_, table.num_tuples());
+        std::vector<std::string> names = table.GetColumnNames();
+        ASSERT_EQ(2u, names.size());
+        EXPECT_EQ("a", names[0]);
+        EXPECT_EQ("b", names[1]);
+        EXPECT_EQ(ColumnType::kByteSlicePadRight, table.GetColumn("a")->type());
+        EXPECT_EQ(ColumnType::kBitSlice, table.GetColumn("b")->type());
+        EXPECT_EQ(PagePolicy::kTransparentHugePage, table.GetColumn("a")->page_policy());
+        EXPECT_EQ(PagePolicy::kDefault, table.GetColumn("b")->page_policy());
+        for(size_t i=0; i < num_; i++){
+            ASSERT_EQ(data1_[i], table.GetColumn("a")->GetTuple(i));
+            ASSERT_EQ(data2_[i], table.GetColumn("b")->GetTuple(i));
+        }
+    }
+
+    //a catalog whose page policy disagrees with the column file
+    Table table;
+    Table::Option option;
+    FILE* catalog = std::fopen((path + "/CATALOG").c_str(), "w");
+    std::fprintf(catalog, "%zu 2\na 0\nb 0\n", num_);
+    std::fclose(catalog);
+    EXPECT_FALSE(table.Open(path, option));
+
+    //a catalog without a valid first line
+    catalog = std::fopen((path + "/CATALOG").c_str(), "w");
+    std::fputs("two columns\na\nb\n", catalog);
+    std::fclose(catalog);
+    EXPECT_FALSE(table.Open(path, option));
+
+    std::remove((path + "/a.col").c_str());
+    std::remove((path + "/b.col").c_str());
+    std::remove((path + "/CATALOG").c_str());
+    rmdir(path.c_str());
+
+    EXPECT_FALSE(table.Open(path, option));
+    option.create_if_missing = true;
+    EXPECT_TRUE(table.Open(path, option));
+    EXPECT_EQ(0u, table.GetNumColumns());
+    rmdir(path.c_str());
+}
+
+TEST_F(TableTest, ForEachBlock){
+    Table table(num_);
+    table.CreateColumn("a", ColumnType::kByteSlicePadRight, 12)->BulkLoadArray(data1_, num_);
+    table.CreateColumn("b", ColumnType::kNaive, 20)->BulkLoadArray(data2_, num_);
+
+    std::vector<size_t> counts(table.GetNumBlocks(), 0);
+    table.ForEachBlock({"b", "a"},
+            [&](size_t block_id, const std::vector<ColumnBlock*> &blocks){
+        ASSERT_EQ(2u, blocks.size());
+        ASSERT_EQ(blocks[0]->num_tuples(), blocks[1]->num_tuples());
+        for(size_t i=0; i < blocks[0]->num_tuples(); i++){
+            size_t pos = block_id*kNumTuplesPerBlock + i;
+            ASSERT_EQ(data2_[pos], blocks[0]->GetTuple(i));
+            ASSERT_EQ(data1_[pos], blocks[1]->GetTuple(i));
+        }
+        counts[block_id] = blocks[0]->num_tuples();
+    });
+
+    size_t total = 0;
+    for(size_t count : counts){
+        total += count;
+    }
+    EXPECT_EQ(num_, total);
+}
+
+}   //namespace
@@ -0,0 +1,159 @@
+#include    "include/zone_map.h"
+#include    "include/byteslice_column_block.h"
+#include    "include/naive_column_block.h"
+#include    "gtest/gtest.h"
+#include    <vector>
+
+namespace byteslice{
+
+TEST(ZoneMapTest, Match){
+    ZoneMap zone_map(12);
+    //nothing written yet: undecided
+    EXPECT_TRUE(zone_map.IsEmpty());
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.Match(Comparator::kLess, 100));
+
+    for(size_t i = 0; i < ZoneMap::kNumTuplesPerZone; i++){
+        zone_map.Update(i, 100 + i % 50);
+    }
+    EXPECT_EQ(100u, zone_map.min());
+    EXPECT_EQ(149u, zone_map.max());
+    EXPECT_EQ(ZoneMatch::kNone, zone_map.Match(Comparator::kLess, 100));
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.Match(Comparator::kLess, 101));
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.Match(Comparator::kLess, 150));
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.Match(Comparator::kLessEqual, 149));
+    EXPECT_EQ(ZoneMatch::kNone, zone_map.Match(Comparator::kGreater, 149));
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.Match(Comparator::kGreaterEqual, 100));
+    EXPECT_EQ(ZoneMatch::kNone, zone_map.Match(Comparator::kEqual, 99));
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.Match(Comparator::kInequal, 150));
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.Match(Comparator::kEqual, 120));
+    //literals wider than the codes are left to the scan
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.Match(Comparator::kLess, 1ULL << 12));
+
+    //zone level
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.Match(0, Comparator::kGreater, 99));
+    EXPECT_TRUE(zone_map.IsZoneEmpty(1));
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.Match(1, Comparator::kGreater, 99));
+}
+
+TEST(ZoneMapTest, MatchIn){
+    ZoneMap zone_map(12);
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.MatchIn({5}));
+    for(size_t i = 0; i < ZoneMap::kNumTuplesPerZone; i++){
+        zone_map.Update(i, 100 + i % 50);
+    }
+    zone_map.Update(ZoneMap::kNumTuplesPerZone, 7);
+    EXPECT_EQ(ZoneMatch::kNone, zone_map.MatchIn(0, {1, 99, 150, 4000}));
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.MatchIn(0, {1, 120, 4000}));
+    EXPECT_EQ(ZoneMatch::kAll, zone_map.MatchIn(1, {1, 7, 4000}));
+    EXPECT_EQ(ZoneMatch::kNone, zone_map.MatchIn(1, {}));
+    EXPECT_EQ(ZoneMatch::kSome, zone_map.MatchIn({7, 4000}));
+}
+
+TEST(ZoneMapTest, BatchUpdate){
+    ZoneMap zone_map(32);
+    std::vector<WordUnit> codes(3 * ZoneMap::kNumTuplesPerZone, 7);
+    zone_map.Update(0, 1000);
+    zone_map.Update(ZoneMap::kNumTuplesPerZone, 1000);
+    zone_map.Update(3 * ZoneMap::kNumTuplesPerZone, 1000);
+
+    //zone 1 and 2 are covered entirely, zone 0 and 3 partially
+    zone_map.Update(codes.data(), codes.size(), ZoneMap::kNumTuplesPerZone / 2);
+    EXPECT_EQ(7u, zone_map.GetZoneMin(0));
+    EXPECT_EQ(1000u, zone_map.GetZoneMax(0));
+    EXPECT_EQ(7u, zone_map.GetZoneMin(1));
+    EXPECT_EQ(7u, zone_map.GetZoneMax(1));
+    EXPECT_EQ(7u, zone_map.GetZoneMax(2));
+    EXPECT_EQ(1000u, zone_map.GetZoneMax(3));
+    EXPECT_EQ(7u, zone_map.min());
+    EXPECT_EQ(1000u, zone_map.max());
+}
+
+TEST(ZoneMapTest, Rebuild){
+    NaiveColumnBlock<uint16_t>* block = new NaiveColumnBlock<uint16_t>();
+    block->SetTuple(10, 5000);
+    block->SetTuple(10, 3);
+    //in-place updates only widen
+    EXPECT_EQ(5000u, block->zone_map().GetZoneMax(0));
+    block->RebuildZoneMap();
+    EXPECT_EQ(0u, block->zone_map().GetZoneMin(0));
+    EXPECT_EQ(3u, block->zone_map().GetZoneMax(0));
+    delete block;
+}
+
+TEST(ZoneMapTest, PartlyWrittenBlock){
+    //tuples never written decode to the value of zeroed storage (0x8080
+    //for 16 bits), which the block itself must account for
+    ByteSliceColumnBlock<16>* block = new ByteSliceColumnBlock<16>(kNumTuplesPerBlock);
+    for(size_t i = 0; i < 100; i++){
+        block->SetTuple(i, 5);
+    }
+    size_t expected = 0;
+    for(size_t i = 0; i < block->num_tuples(); i++){
+        expected += 5 == block->GetTuple(i);
+    }
+    EXPECT_EQ(100u, expected);
+    BitVectorBlock* bvblock = new BitVectorBlock(block->num_tuples());
+    block->Scan(Comparator::kEqual, 5, bvblock, Bitwise::kSet);
+    EXPECT_EQ(expected, bvblock->CountOnes());
+    EXPECT_EQ(expected, block->CountWhere(Comparator::kEqual, 5));
+    delete bvblock;
+
+    //tuples a block gains on Resize, including old values past a shrink
+    std::vector<WordUnit> codes(5000, 5);
+    block->Resize(codes.size());
+    block->BulkLoadArray(codes.data(), codes.size());
+    block->Resize(3000);
+    block->RebuildZoneMap();
+    block->Resize(kNumTuplesPerBlock);
+    EXPECT_EQ(5000u, block->CountWhere(Comparator::kEqual, 5));
+    delete block;
+}
+
+TEST(ZoneMapTest, ByteSliceScanSkipsZones){
+    const size_t num = kNumTuplesPerBlock - 1000;
+    ByteSliceColumnBlock<20>* block = new ByteSliceColumnBlock<20>(num);
+    std::vector<WordUnit> codes(num);
+    for(size_t i = 0; i < num; i++){
+        codes[i] = i;
+    }
+    block->BulkLoadArray(codes.data(), num);
+
+    const WordUnit literal = 123457;
+    std::vector<Comparator> comparators = {
+        Comparator::kLess, Comparator::kGreater, Comparator::kEqual,
+        Comparator::kInequal, Comparator::kLessEqual, Comparator::kGreaterEqual};
+    std::vector<Bitwise> opts = {Bitwise::kSet, Bitwise::kAnd, Bitwise::kOr};
+    BitVectorBlock* bvblock = new BitVectorBlock(num);
+    for(Comparator comparator : comparators){
+        for(Bitwise opt : opts){
+            //alternating input bits
+            for(size_t w = 0; w < bvblock->num_word_units(); w++){
+                bvblock->SetWordUnit(0x5555555555555555ULL, w);
+            }
+            bvblock->ClearTail();
+            block->Scan(comparator, literal, bvblock, opt);
+            for(size_t i = 0; i < num; i++){
+                bool result = false;
+                switch(comparator){
+                    case Comparator::kLess: result = i < literal; break;
+                    case Comparator::kGreater: result = i > literal; break;
+                    case Comparator::kEqual: result = i == literal; break;
+                    case Comparator::kInequal: result = i != literal; break;
+                    case Comparator::kLessEqual: result = i <= literal; break;
+                    case Comparator::kGreaterEqual: result = i >= literal; break;
+                }
+                bool input = (0 == i % 2);
+                bool expected = (Bitwise::kAnd == opt)? (result && input) :
+                    (Bitwise::kOr == opt)? (result || input) : result;
+                ASSERT_EQ(expected, bvblock->GetBit(i))
+                    << comparator << " at " << i;
+            }
+            EXPECT_EQ(0ULL, bvblock->GetWordUnit(bvblock->num_word_units() - 1)
+                    & ~((1ULL << (num % kNumWordBits)) - 1));
+        }
+    }
+    delete bvblock;
+    delete block;
+}
+
+}   //namespace